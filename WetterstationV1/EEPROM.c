@@ -9,18 +9,12 @@
  */ 
 //#define F_CPU 3686400UL
 
-#include <avr/io.h>
-#include <util/delay.h>
+#include "hal.h"
 #include "EEPROM.h"
+#include "timebase.h"
+#include "diag.h"
 
-// SPI Pin-Definitionen für ATmega8
-// Diese Pins werden für die SPI-Kommunikation mit dem EEPROM verwendet
-#define SPI_DDR   DDRB    // Data Direction Register für SPI-Pins
-#define SPI_PORT  PORTB   // Port Register für SPI-Pins
-#define SPI_MISO  PB4     // Master In Slave Out (Daten vom EEPROM)
-#define SPI_MOSI  PB3     // Master Out Slave In (Daten zum EEPROM)
-#define SPI_SCK   PB5     // Serial Clock (Taktsignal)
-#define SPI_CS    PB2     // Chip Select (EEPROM aktivieren/deaktivieren)
+// Pins und SPI-Register: hal.h (CS auf PB2, MISO teilt sich das EEPROM mit dem Display)
 
 // EEPROM-Kommandos (laut Datenblatt des verwendeten EEPROMs)
 #define EEPROM_CMD_READ   0x03  // Read Data from Memory Array
@@ -28,46 +22,31 @@
 #define EEPROM_CMD_WREN   0x06  // Write Enable (vor jedem Schreibvorgang nötig)
 #define EEPROM_CMD_RDSR   0x05  // Read Status Register
 
+#if DIAG_ENABLE
+static eeprom_stats_t stats;
+#endif
+
 // SPI-Initialisierung für EEPROM-Kommunikation
+// Master-Modus, Takt/16
 void spi_init(void) {
-	// SPI-Pins als Ausgänge konfigurieren (außer MISO)
-	SPI_DDR |= (1 << SPI_MOSI) | (1 << SPI_SCK) | (1 << SPI_CS);
-	SPI_DDR &= ~(1 << SPI_MISO);  // MISO als Eingang
-	
-	// SPI-Register konfigurieren
-	// SPE = SPI Enable, MSTR = Master Mode, SPR0 = Prescaler /16
-	SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR0);
+	hal_spi_init();
 }
 
 // SPI-Datentransfer (sendet und empfängt ein Byte)
 uint8_t spi_transfer(uint8_t data) {
-	SPDR = data;  // Daten in SPI Data Register schreiben
-	
-	// Warten bis Transfer abgeschlossen ist (SPIF-Bit wird gesetzt)
-	while (!(SPSR & (1 << SPIF)));
-	
-	return SPDR;  // Empfangene Daten zurückgeben
+	return hal_spi_xfer(data);
 }
 
 // EEPROM Chip Select aktivieren (Low-Aktiv)
+// MISO wird Eingang, die Display-Hälften werden abgewählt (Display hört nicht auf E)
 void eeprom_select(void) {
-	SPI_PORT &= ~(1 << SPI_CS);  // CS auf Low setzen (EEPROM aktivieren)
-	SPI_DDR &= ~(1 << SPI_MISO); // MISO als Input definieren (für EEPROM-Daten)
-	
-	// Alle anderen CS-Pins inaktiv setzen (Display hört nicht auf E)
-	// Dies verhindert Konflikte mit anderen SPI-Geräten
-	PORTC |= _BV(PC1) | _BV(PC0);
+	hal_eeprom_select();
 }
 
-// EEPROM Chip Select deaktivieren (High-Aktiv)
+// EEPROM Chip Select deaktivieren
+// MISO wird wieder Ausgang (Display), beide Display-Hälften sind danach gewählt
 void eeprom_deselect(void) {
-	SPI_PORT |= (1 << SPI_CS);   // CS auf High setzen (EEPROM deaktivieren)
-	SPI_PORT &= ~(1 << SPI_MISO); // MISO-Pin zurücksetzen
-	SPI_DDR  |=  (1 << SPI_MISO); // MISO als Output definieren (für Display)
-	
-	// Display-CS-Pins aktivieren
-	PORTC &= ~(_BV(PC1) | _BV(PC0));
-	// Nun kannst du E per GPIO pulsen und das Display updated
+	hal_eeprom_deselect();
 }
 
 // Write Enable für EEPROM senden
@@ -88,8 +67,9 @@ void eeprom_write_byte(uint16_t address, uint8_t data) {
 	spi_transfer((uint8_t)(address & 0xFF)); // Low-Byte der Adresse
 	spi_transfer(data);                 // Daten-Byte senden
 	eeprom_deselect();                  // EEPROM deaktivieren
+	DIAG(stats.bytes_written++);
 	
-	_delay_ms(10);  // Warten bis Schreibvorgang abgeschlossen ist (typ. 5 ms)
+	eeprom_wait_until_ready();  // Warten bis Schreibvorgang abgeschlossen ist (typ. 5 ms)
 }
 
 // Ein Byte von einer spezifischen Adresse im EEPROM lesen
@@ -100,6 +80,7 @@ uint8_t eeprom_read_byte(uint16_t address) {
 	spi_transfer((uint8_t)(address & 0xFF)); // Low-Byte der Adresse
 	uint8_t data = spi_transfer(0x00);  // Dummy-Byte senden, Daten empfangen
 	eeprom_deselect();                  // EEPROM deaktivieren
+	DIAG(stats.bytes_read++);
 	
 	return data;  // Gelesenes Byte zurückgeben
 }
@@ -116,24 +97,60 @@ uint8_t eeprom_read_status(void) {
 }
 
 // Warten bis EEPROM bereit ist (Schreibvorgang abgeschlossen)
+// Statt fester 10 ms wird nur so lange gewartet, wie das EEPROM wirklich braucht
 void eeprom_wait_until_ready(void) {
+	#if DIAG_ENABLE
+	uint32_t start = timebase_counts();
+	#endif
 	// WIP-Bit (Write In Progress) prüfen - Bit 0 im Status-Register
-	while (eeprom_read_status() & 0x01);
+	while (eeprom_read_status() & EEPROM_STATUS_WIP);
+	#if DIAG_ENABLE
+	uint32_t waited = TIME_ELAPSED(timebase_counts(), start);
+	stats.wip_wait += waited;
+	if (waited > stats.wip_wait_max) stats.wip_wait_max = waited > 0xFFFF ? 0xFFFF : (uint16_t)waited;
+	#endif
 }
 
 // Mehrere Bytes in das EEPROM schreiben
-// Schreibt Byte für Byte und wartet nach jedem Byte
+// Schreibt Byte für Byte, eeprom_write_byte() wartet nach jedem Byte
 void eeprom_write_block(uint16_t address, const uint8_t* data, uint16_t length) {
 	for (uint16_t i = 0; i < length; i++) {
 		eeprom_write_byte(address + i, data[i]);  // Ein Byte schreiben
-		eeprom_wait_until_ready();  // Warten bis Schreibvorgang abgeschlossen
 	}
 }
 
+// Burst-Lesen beginnen: Kommando und Adresse einmal senden
+// Das EEPROM erhöht die Adresse danach mit jedem gelesenen Byte selbst
+void eeprom_read_begin(uint16_t address) {
+	eeprom_select();                    // EEPROM aktivieren
+	spi_transfer(EEPROM_CMD_READ);      // Read-Kommando senden
+	spi_transfer((uint8_t)(address >> 8));   // High-Byte der Adresse
+	spi_transfer((uint8_t)(address & 0xFF)); // Low-Byte der Adresse
+}
+
+// Nächstes Byte des Burst-Lesens
+uint8_t eeprom_read_next(void) {
+	DIAG(stats.bytes_read++);
+	return spi_transfer(0x00);          // Dummy-Byte senden, Daten empfangen
+}
+
+// Burst-Lesen beenden
+void eeprom_read_end(void) {
+	eeprom_deselect();                  // EEPROM deaktivieren
+}
+
 // Mehrere Bytes aus dem EEPROM lesen
-// Liest Byte für Byte ohne Wartezeiten
+// Ein Burst: Chip Select, Kommando und Adresse nur einmal (statt 4 SPI-Bytes je Datenbyte)
 void eeprom_read_block(uint16_t address, uint8_t* data, uint16_t length) {
+	eeprom_read_begin(address);
 	for (uint16_t i = 0; i < length; i++) {
-		data[i] = eeprom_read_byte(address + i);  // Ein Byte lesen
+		data[i] = eeprom_read_next();   // Ein Byte lesen
 	}
-}
\ No newline at end of file
+	eeprom_read_end();
+}
+
+#if DIAG_ENABLE
+void eeprom_get_stats(eeprom_stats_t* s) {
+	*s = stats;
+}
+#endif
\ No newline at end of file
@@ -27,7 +27,7 @@
 
 // EEPROM-Timing-Konstanten
 // Diese Werte bestimmen die Wartezeiten für EEPROM-Operationen
-#define EEPROM_WRITE_DELAY_MS  10   // Wartezeit nach Schreibvorgang (ms)
+#define EEPROM_WRITE_DELAY_MS  10   // Maximale Dauer eines Schreibzyklus laut Datenblatt (ms), gewartet wird per WIP-Bit
 #define EEPROM_PAGE_SIZE       64   // Größe einer EEPROM-Seite (Bytes)
 #define EEPROM_MAX_ADDRESS     0x7FFF // Maximale Adresse (32KB EEPROM)
 
@@ -64,7 +64,7 @@ uint8_t eeprom_read_byte(uint16_t address);
 uint8_t eeprom_read_status(void);
 
 // Warten bis EEPROM bereit ist
-// Wartet bis ein Schreibvorgang abgeschlossen ist
+// Fragt das WIP-Bit ab, bis der Schreibzyklus abgeschlossen ist (Wartezeit geht in die Statistik)
 void eeprom_wait_until_ready(void);
 
 // Mehrere Bytes in EEPROM schreiben
@@ -72,71 +72,25 @@ void eeprom_wait_until_ready(void);
 void eeprom_write_block(uint16_t address, const uint8_t* data, uint16_t length);
 
 // Mehrere Bytes aus EEPROM lesen
-// Liest ein Array von Bytes ab der angegebenen Adresse
+// Liest ein Array von Bytes ab der angegebenen Adresse (ein Burst)
 void eeprom_read_block(uint16_t address, uint8_t* data, uint16_t length);
 
-// EEPROM-Seite schreiben
-// Schreibt eine komplette EEPROM-Seite (64 Bytes)
-void eeprom_write_page(uint16_t page_address, const uint8_t* data);
+// Burst-Lesen in Teilen (z.B. nur einzelne Felder aufeinanderfolgender Datensätze)
+// Zwischen begin und end darf nichts anderes auf den SPI-Bus bzw. das Display zugreifen
+void eeprom_read_begin(uint16_t address);
+uint8_t eeprom_read_next(void);
+void eeprom_read_end(void);
 
-// EEPROM-Seite lesen
-// Liest eine komplette EEPROM-Seite (64 Bytes)
-void eeprom_read_page(uint16_t page_address, uint8_t* data);
-
-// EEPROM-Bereich löschen
-// Setzt einen Bereich des EEPROMs auf 0xFF
-void eeprom_erase_block(uint16_t start_address, uint16_t length);
-
-// EEPROM-Gerät testen
-// Führt einen Selbsttest des EEPROMs durch
-uint8_t eeprom_test(void);
-
-// EEPROM-Informationen lesen
-// Liest Geräte-Informationen aus dem EEPROM
-void eeprom_get_info(uint8_t* manufacturer_id, uint8_t* device_id);
-
-// EEPROM-Schreibschutz aktivieren/deaktivieren
-// Kontrolliert den Hardware-Schreibschutz (falls verfügbar)
-void eeprom_write_protect(uint8_t enable);
-
-// EEPROM-Speicherplatz prüfen
-// Prüft ob genügend freier Speicherplatz verfügbar ist
-uint8_t eeprom_check_space(uint16_t required_bytes);
-
-// EEPROM-Daten integrität prüfen
-// Berechnet und prüft Checksummen für Datenintegrität
-uint16_t eeprom_calculate_checksum(uint16_t start_address, uint16_t length);
-uint8_t eeprom_verify_checksum(uint16_t start_address, uint16_t length, uint16_t expected_checksum);
-
-// EEPROM-Backup erstellen
-// Erstellt eine Sicherungskopie eines EEPROM-Bereichs
-void eeprom_backup(uint16_t source_address, uint16_t dest_address, uint16_t length);
-
-// EEPROM-Restore durchführen
-// Stellt Daten aus einer Sicherungskopie wieder her
-void eeprom_restore(uint16_t source_address, uint16_t dest_address, uint16_t length);
-
-// EEPROM-Formatierung
-// Formatiert das gesamte EEPROM (setzt alle Bytes auf 0xFF)
-void eeprom_format(void);
-
-// EEPROM-Statistiken
-// Gibt Informationen über EEPROM-Nutzung zurück
+// EEPROM-Statistiken (nur mit DIAG_ENABLE, diag.h)
+// Zähler seit dem Start
 typedef struct {
-	uint16_t total_bytes;      // Gesamte EEPROM-Größe
-	uint16_t used_bytes;       // Verwendete Bytes
-	uint16_t free_bytes;       // Freie Bytes
-	uint16_t write_cycles;     // Anzahl Schreibzyklen
-	uint16_t read_cycles;      // Anzahl Lesezyklen
-	uint16_t error_count;      // Anzahl aufgetretener Fehler
+	uint32_t bytes_read;       // Gelesene Datenbytes (Einzel- und Burst-Lesen)
+	uint32_t bytes_written;    // Geschriebene Datenbytes (= Schreibzyklen, es wird byteweise geschrieben)
+	uint32_t wip_wait;         // Summe der Wartezeit auf das Ende der Schreibzyklen (Timer1-Schritte, 1/3600 s)
+	uint16_t wip_wait_max;     // Längste Wartezeit auf einen Schreibzyklus (Timer1-Schritte)
 } eeprom_stats_t;
 
 // EEPROM-Statistiken abrufen
-// Liest aktuelle Nutzungsstatistiken
 void eeprom_get_stats(eeprom_stats_t* stats);
 
-// EEPROM-Statistiken zurücksetzen
-// Setzt alle Zähler zurück
-void eeprom_reset_stats(void);
-
 #endif /* EEPROM_H_ */
\ No newline at end of file
@@ -1,7 +1,7 @@
 /*
  * Sensor.c
  *
- * BME280 Sensor-Treiber für Temperatur- und Druckmessung
+ * BME280 Sensor-Treiber für Temperatur-, Druck- und Feuchtemessung
  * Implementiert die I2C-Kommunikation mit dem BME280 Sensor
  * 
  * Created: 25.05.2025 13:53:11
@@ -10,14 +10,18 @@
 
 #include "Sensor.h"
 #include "i2cMaster.h"
+#include "arena.h"
+#include <util/delay.h>
 
 // BME280 I2C-Adresse (0x76 = Standard-Adresse)
 #define BME280_ADDR 0x76
 
 // BME280 Register-Adressen (laut Datenblatt)
+#define REG_CTRL_HUM 0xF2   // Control Humidity Register
 #define REG_CTRL_MEAS 0xF4  // Control Measurement Register
 #define REG_CONFIG 0xF5     // Configuration Register  
 #define REG_DATA 0xF7       // Data Register (Startadresse für Messdaten)
+#define REG_CALIB_H2 0xE1   // Startadresse der Feuchte-Kalibrierung H2..H6
 
 // Kalibrierungsvariablen (laut BME280-Datenblatt)
 // Diese Werte werden beim Start vom Sensor gelesen
@@ -37,91 +41,176 @@ int16_t  dig_P7;  // Druck-Kalibrierung 7
 int16_t  dig_P8;  // Druck-Kalibrierung 8
 int16_t  dig_P9;  // Druck-Kalibrierung 9
 
+// Feuchte-Kalibrierwerte (für Feuchtekompensation)
+uint8_t  dig_H1;  // Feuchte-Kalibrierung 1
+int16_t  dig_H2;  // Feuchte-Kalibrierung 2
+uint8_t  dig_H3;  // Feuchte-Kalibrierung 3
+int16_t  dig_H4;  // Feuchte-Kalibrierung 4 (12 Bit)
+int16_t  dig_H5;  // Feuchte-Kalibrierung 5 (12 Bit)
+int8_t   dig_H6;  // Feuchte-Kalibrierung 6
+
 // Globale Variable für Temperaturkompensation
 // Wird von der Temperaturkompensation berechnet und für die Druckkompensation benötigt
 int32_t t_fine;
 
+// 1 = Kalibrierungsdaten wurden vollständig gelesen
+static uint8_t calib_ok;
+
+// Wartezeit vor dem nächsten Versuch (1, 2, 4 ms ...)
+static void bme280_backoff(uint8_t attempt) {
+	for (uint8_t ms = 1 << attempt; ms; ms--) {
+		_delay_ms(1);
+	}
+}
+
+// Ein Register des BME280 beschreiben
+// Wird bei Fehlern bis zu I2C_RETRY_COUNT mal wiederholt, dazwischen Bus-Recovery
+// Rückgabe: I2C_OK oder Fehler des letzten Versuchs
+static uint8_t bme280_write_reg(uint8_t reg, uint8_t value) {
+	uint8_t status = I2C_ERROR_START;
+
+	for (uint8_t attempt = 0; attempt < I2C_RETRY_COUNT; attempt++) {
+		if (attempt) {
+			i2c_bus_recover();       // Hängenden Slave freitakten
+			bme280_backoff(attempt - 1);
+		}
+
+		i2c_start((BME280_ADDR << 1) | I2C_WRITE);
+		i2c_write(reg);              // Register-Adresse senden
+		i2c_write(value);            // Wert senden
+		status = i2c_stop();         // Erster Fehler der Transaktion
+		if (status == I2C_OK) break;
+	}
+	return status;
+}
+
+// Mehrere aufeinanderfolgende Register des BME280 lesen (Burst)
+// Wird bei Fehlern bis zu I2C_RETRY_COUNT mal wiederholt, dazwischen Bus-Recovery
+// Rückgabe: I2C_OK oder Fehler des letzten Versuchs
+static uint8_t bme280_read_regs(uint8_t reg, uint8_t* buf, uint8_t len) {
+	uint8_t status = I2C_ERROR_START;
+
+	for (uint8_t attempt = 0; attempt < I2C_RETRY_COUNT; attempt++) {
+		if (attempt) {
+			i2c_bus_recover();       // Hängenden Slave freitakten
+			bme280_backoff(attempt - 1);
+		}
+
+		// Startadresse setzen
+		i2c_start((BME280_ADDR << 1) | I2C_WRITE);
+		i2c_write(reg);
+		status = i2c_stop();
+		if (status != I2C_OK) continue;
+
+		// Daten lesen: alle Bytes mit ACK, das letzte mit NACK
+		i2c_start((BME280_ADDR << 1) | I2C_READ);
+		for (uint8_t i = 0; i < len - 1; i++) {
+			buf[i] = i2c_readAck();
+		}
+		buf[len - 1] = i2c_readNak();
+		status = i2c_stop();
+		if (status == I2C_OK) break;
+	}
+	return status;
+}
+
 // Initialisiert den BME280 Sensor
-void bme280_init(void) {
-	// Nur Temperatur und Druck aktivieren (keine Feuchtigkeit)
-	// I2C-Start mit Schreibadresse
-	i2cStart((BME280_ADDR << 1) | I2C_WRITE);
-	i2cWrite(REG_CTRL_MEAS);  // Register-Adresse senden
-	i2cWrite(0x27);           // Konfiguration: osrs_t=1, osrs_p=1, mode=normal
-	i2cStop();                // I2C-Stop
+// Rückgabe: I2C_OK oder Fehlercode
+uint8_t bme280_init(void) {
+	uint8_t status;
+
+	// Feuchte-Oversampling setzen
+	// ctrl_hum wird erst mit dem nächsten Schreiben von ctrl_meas übernommen
+	status = bme280_write_reg(REG_CTRL_HUM, 0x01);          // Konfiguration: osrs_h=1
+
+	// Temperatur und Druck aktivieren
+	if (status == I2C_OK)
+		status = bme280_write_reg(REG_CTRL_MEAS, 0x27);     // Konfiguration: osrs_t=1, osrs_p=1, mode=normal
 
 	// Konfigurationsregister setzen
-	i2cStart((BME280_ADDR << 1) | I2C_WRITE);
-	i2cWrite(REG_CONFIG);     // Register-Adresse senden
-	i2cWrite(0xA0);           // Konfiguration: Standby 1000ms, Filter aus
-	i2cStop();                // I2C-Stop
+	if (status == I2C_OK)
+		status = bme280_write_reg(REG_CONFIG, 0xA0);        // Konfiguration: Standby 1000ms, Filter aus
+
+	return status;
+}
+
+// Temperatur- und Druck-Kalibrierung umrechnen (26 Bytes ab 0x88, H1 im letzten Byte)
+void bme280_parse_calibration(const uint8_t* calib) {
+	// Kalibrierungsdaten aus Bytes extrahieren (laut Datenblatt)
+	// Temperatur-Kalibrierung (16-bit Werte)
+	dig_T1 = (uint16_t)((calib[1] << 8) | calib[0]);  // T1: Bytes 0-1
+	dig_T2 = (int16_t)((calib[3] << 8) | calib[2]);   // T2: Bytes 2-3
+	dig_T3 = (int16_t)((calib[5] << 8) | calib[4]);   // T3: Bytes 4-5
+
+	// Druck-Kalibrierung (16-bit Werte)
+	dig_P1 = (uint16_t)((calib[7] << 8) | calib[6]);   // P1: Bytes 6-7
+	dig_P2 = (int16_t)((calib[9] << 8) | calib[8]);    // P2: Bytes 8-9
+	dig_P3 = (int16_t)((calib[11] << 8) | calib[10]);  // P3: Bytes 10-11
+	dig_P4 = (int16_t)((calib[13] << 8) | calib[12]);  // P4: Bytes 12-13
+	dig_P5 = (int16_t)((calib[15] << 8) | calib[14]);  // P5: Bytes 14-15
+	dig_P6 = (int16_t)((calib[17] << 8) | calib[16]);  // P6: Bytes 16-17
+	dig_P7 = (int16_t)((calib[19] << 8) | calib[18]);  // P7: Bytes 18-19
+	dig_P8 = (int16_t)((calib[21] << 8) | calib[20]);  // P8: Bytes 20-21
+	dig_P9 = (int16_t)((calib[23] << 8) | calib[22]);  // P9: Bytes 22-23
+
+	// Feuchte-Kalibrierung: H1 liegt bei 0xA1 (letztes Byte des ersten Blocks)
+	dig_H1 = calib[25];
+}
+
+// Feuchte-Kalibrierung H2..H6 umrechnen (7 Bytes ab 0xE1)
+void bme280_parse_calibration_h(const uint8_t* calib) {
+	dig_H2 = (int16_t)((calib[1] << 8) | calib[0]);           // H2: 0xE1-0xE2
+	dig_H3 = calib[2];                                        // H3: 0xE3
+	dig_H4 = (int16_t)(((int8_t)calib[3] * 16) | (calib[4] & 0x0F));  // H4: 0xE4 + untere 4 Bit von 0xE5
+	dig_H5 = (int16_t)(((int8_t)calib[5] * 16) | (calib[4] >> 4));    // H5: 0xE6 + obere 4 Bit von 0xE5
+	dig_H6 = (int8_t)calib[6];                                // H6: 0xE7
+}
+
+// Liest die Kalibrierungsdaten in den Puffer calib (ARENA_CALIB_LEN Bytes) und rechnet sie um
+static uint8_t read_calibration(uint8_t* calib) {
+	// 26 Bytes ab der Startadresse der Kalibrierungsdaten lesen
+	if (bme280_read_regs(0x88, calib, 26) != I2C_OK) return I2C_ERROR_DATA;
+	bme280_parse_calibration(calib);
+
+	// H2..H6 liegen in einem zweiten Block ab 0xE1 (7 Bytes)
+	if (bme280_read_regs(REG_CALIB_H2, calib, 7) != I2C_OK) return I2C_ERROR_DATA;
+	bme280_parse_calibration_h(calib);
+
+	calib_ok = 1;
+	return I2C_OK;
 }
 
 // Liest die Kalibrierungsdaten vom BME280 Sensor
 // Diese Daten sind notwendig für die Temperatur- und Druckkompensation
-void bme280_read_calibration(void) {
-        uint8_t calib[26];  // Puffer für 26 Kalibrierungsbytes
-        
-        // I2C-Start mit Schreibadresse für Kalibrierungsregister
-        i2cStart((BME280_ADDR << 1) | I2C_WRITE);
-        i2cWrite(0x88);      // Startadresse der Kalibrierungsdaten
-        i2cStop();
-
-        // I2C-Start mit Leseadresse
-        i2cStart((BME280_ADDR << 1) | I2C_READ);
-        
-        // 25 Bytes mit ACK lesen
-        for (uint8_t i = 0; i < 25; i++) {
-	        calib[i] = i2cReadAck();
-        }
-        // Letztes Byte mit NACK lesen
-        calib[25] = i2cReadNak();
-        i2cStop();
-
-        // Kalibrierungsdaten aus Bytes extrahieren (laut Datenblatt)
-        // Temperatur-Kalibrierung (16-bit Werte)
-        dig_T1 = (uint16_t)((calib[1] << 8) | calib[0]);  // T1: Bytes 0-1
-        dig_T2 = (int16_t)((calib[3] << 8) | calib[2]);   // T2: Bytes 2-3
-        dig_T3 = (int16_t)((calib[5] << 8) | calib[4]);   // T3: Bytes 4-5
-        
-        // Druck-Kalibrierung (16-bit Werte)
-        dig_P1 = (uint16_t)((calib[7] << 8) | calib[6]);   // P1: Bytes 6-7
-        dig_P2 = (int16_t)((calib[9] << 8) | calib[8]);    // P2: Bytes 8-9
-        dig_P3 = (int16_t)((calib[11] << 8) | calib[10]);  // P3: Bytes 10-11
-        dig_P4 = (int16_t)((calib[13] << 8) | calib[12]);  // P4: Bytes 12-13
-        dig_P5 = (int16_t)((calib[15] << 8) | calib[14]);  // P5: Bytes 14-15
-        dig_P6 = (int16_t)((calib[17] << 8) | calib[16]);  // P6: Bytes 16-17
-        dig_P7 = (int16_t)((calib[19] << 8) | calib[18]);  // P7: Bytes 18-19
-        dig_P8 = (int16_t)((calib[21] << 8) | calib[20]);  // P8: Bytes 20-21
-        dig_P9 = (int16_t)((calib[23] << 8) | calib[22]);  // P9: Bytes 22-23
+// Der Puffer liegt im gemeinsamen Bereich (ARENA_BOOT) statt auf dem Stack
+// Rückgabe: I2C_OK oder Fehlercode
+uint8_t bme280_read_calibration(void) {
+	if (!arena_begin(ARENA_BOOT)) return I2C_ERROR_DATA;  // Bereich belegt: später erneut
+	uint8_t result = read_calibration(arena.boot.calib);
+	arena_end();
+	return result;
 }
 
 // Liest die Rohdaten (ADC-Werte) vom BME280 Sensor
+// Druck, Temperatur und Feuchte liegen direkt hintereinander (0xF7..0xFE)
+// und werden in einem einzigen 8-Byte-Burst gelesen
 // Diese Werte müssen noch kompensiert werden
-void bme280_read_raw(int32_t* temp_raw, int32_t* press_raw) {
-	uint8_t data[6];  // Puffer für 6 Datenbytes (3 Temperatur + 3 Druck)
-
-	// I2C-Start mit Schreibadresse für Datenregister
-	i2cStart((BME280_ADDR << 1) | I2C_WRITE);
-	i2cWrite(REG_DATA);  // Startadresse der Messdaten
-	i2cStop();
+// Rückgabe: I2C_OK oder Fehlercode
+uint8_t bme280_read_raw(int32_t* temp_raw, int32_t* press_raw, int32_t* hum_raw) {
+	uint8_t data[8];  // Puffer für 8 Datenbytes (3 Druck + 3 Temperatur + 2 Feuchte)
 
-	// I2C-Start mit Leseadresse
-	i2cStart((BME280_ADDR << 1) | I2C_READ);
-	
-	// 5 Bytes mit ACK lesen
-	for (uint8_t i = 0; i < 5; i++) {
-		data[i] = i2cReadAck();
-	}
-	// Letztes Byte mit NACK lesen
-	data[5] = i2cReadNak();
-	i2cStop();
+	// Alle Messdaten in einem Burst lesen
+	uint8_t status = bme280_read_regs(REG_DATA, data, 8);
+	if (status != I2C_OK) return status;
 
 	// Rohdaten aus Bytes extrahieren (20-bit Werte)
 	// Druck: Bytes 0-2 (20-bit, rechtsbündig)
 	*press_raw = ((int32_t)data[0] << 12) | ((int32_t)data[1] << 4) | (data[2] >> 4);
 	// Temperatur: Bytes 3-5 (20-bit, rechtsbündig)
 	*temp_raw  = ((int32_t)data[3] << 12) | ((int32_t)data[4] << 4) | (data[5] >> 4);
+	// Feuchte: Bytes 6-7 (16-bit)
+	*hum_raw   = ((int32_t)data[6] << 8) | data[7];
+	return I2C_OK;
 }
 
 // Kompensiert die Temperatur-Rohdaten (laut BME280-Datenblatt)
@@ -171,26 +260,58 @@ uint32_t bme280_compensate_press(int32_t adc_P) {
 	p = (uint32_t)((int32_t)p + ((var1 + var2 + dig_P7) >> 4));
 	
 	// Korrekturfaktor 1.04518 anwenden (für Meereshöhe)
-	// Rechne über 64 Bit um Überlauf zu vermeiden
-	uint64_t scaled_pressure = (uint64_t)p * 104518UL;
-	p = (uint32_t)(scaled_pressure / 100000UL);
+	// Nur den Anteil 0.04518 multiplizieren: p * 4518 bleibt unter 2^32 (p < 950000 Pa)
+	p += p * 4518UL / 100000UL;
 
 	return p;  // Druck in Pascal (auf Meereshöhe reduziert)
 }
 
-// Hauptfunktion: Liest Temperatur und Druck vom BME280
+// Kompensiert die Feuchte-Rohdaten (laut BME280-Datenblatt, 32-Bit-Festkomma)
+// Benötigt t_fine aus der vorherigen Temperaturkompensation
+// Gibt relative Feuchte in 0.1% zurück (z.B. 455 = 45.5%)
+uint16_t bme280_compensate_hum(int32_t adc_H) {
+	int32_t v;  // Zwischenvariable für Berechnung
+
+	// Berechnung laut Datenblatt (Ergebnis im Format Q22.10 %RH)
+	v = t_fine - (int32_t)76800;
+	v = (((((adc_H << 14) - ((int32_t)dig_H4 << 20) - ((int32_t)dig_H5 * v)) + (int32_t)16384) >> 15)
+	     * (((((((v * (int32_t)dig_H6) >> 10) * (((v * (int32_t)dig_H3) >> 11) + (int32_t)32768)) >> 10)
+	     + (int32_t)2097152) * (int32_t)dig_H2 + 8192) >> 14));
+	v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)dig_H1) >> 4);
+
+	// Auf 0..100% begrenzen
+	if (v < 0) v = 0;
+	if (v > 419430400) v = 419430400;
+
+	// Q22.10 (1/1024 %) in 0.1% umrechnen (mit Rundung)
+	uint32_t h = (uint32_t)v >> 12;
+	return (uint16_t)((h * 10 + 512) >> 10);
+}
+
+// Hauptfunktion: Liest Temperatur, Druck und Feuchte vom BME280
 // Gibt kompensierte Werte in den gewünschten Einheiten zurück
-void bmp280_read_temperature_and_pressure(int16_t* temp, uint16_t* press) {
-	int32_t temp_raw, press_raw;  // Rohdaten vom Sensor
-	
-	// Rohdaten vom Sensor lesen
-	bme280_read_raw(&temp_raw, &press_raw);
-	
+// Rückgabe: I2C_OK oder Fehlercode - bei einem Fehler bleiben die Ausgabewerte unverändert
+uint8_t bme280_read_measurement(int16_t* temp, uint16_t* press, uint16_t* hum) {
+	int32_t temp_raw, press_raw, hum_raw;  // Rohdaten vom Sensor
+
+	// Sensor war beim Start nicht erreichbar: Einrichtung nachholen
+	if (!calib_ok && (bme280_init() != I2C_OK || bme280_read_calibration() != I2C_OK)) {
+		return I2C_ERROR_START;
+	}
+
+	// Rohdaten vom Sensor lesen (ein Burst für alle drei Kanäle)
+	if (bme280_read_raw(&temp_raw, &press_raw, &hum_raw) != I2C_OK) return I2C_ERROR_DATA;
+
 	// Temperatur kompensieren (gibt 0.01°C zurück)
 	int32_t comp_temp = bme280_compensate_temp(temp_raw);
 	*temp  = (int16_t)(comp_temp  / 10);  // In 0.1°C umrechnen
-	
+
 	// Druck kompensieren (gibt Pascal zurück)
 	uint32_t comp_press = bme280_compensate_press(press_raw);
 	*press = (uint16_t)(comp_press / 10);  // In 0.1 hPa umrechnen
+
+	// Feuchte kompensieren (gibt 0.1% zurück)
+	*hum   = bme280_compensate_hum(hum_raw);
+	return I2C_OK;
 }
+
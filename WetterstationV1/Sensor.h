@@ -96,158 +96,32 @@
 #define BME280_FORCED_MODE        0x01    // Forced-Modus (einmalige Messung)
 #define BME280_NORMAL_MODE        0x03    // Normal-Modus (kontinuierliche Messung)
 
-// BME280 Kalibrierungsdaten-Struktur
-// Enthält alle Kalibrierungskoeffizienten für die Berechnung
-typedef struct {
-	uint16_t dig_T1;  // Temperatur-Kalibrierungskoeffizient 1
-	int16_t  dig_T2;  // Temperatur-Kalibrierungskoeffizient 2
-	int16_t  dig_T3;  // Temperatur-Kalibrierungskoeffizient 3
-	uint16_t dig_P1;  // Druck-Kalibrierungskoeffizient 1
-	int16_t  dig_P2;  // Druck-Kalibrierungskoeffizient 2
-	int16_t  dig_P3;  // Druck-Kalibrierungskoeffizient 3
-	int16_t  dig_P4;  // Druck-Kalibrierungskoeffizient 4
-	int16_t  dig_P5;  // Druck-Kalibrierungskoeffizient 5
-	int16_t  dig_P6;  // Druck-Kalibrierungskoeffizient 6
-	int16_t  dig_P7;  // Druck-Kalibrierungskoeffizient 7
-	int16_t  dig_P8;  // Druck-Kalibrierungskoeffizient 8
-	int16_t  dig_P9;  // Druck-Kalibrierungskoeffizient 9
-	uint8_t  dig_H1;  // Luftfeuchtigkeit-Kalibrierungskoeffizient 1
-	int16_t  dig_H2;  // Luftfeuchtigkeit-Kalibrierungskoeffizient 2
-	uint8_t  dig_H3;  // Luftfeuchtigkeit-Kalibrierungskoeffizient 3
-	int16_t  dig_H4;  // Luftfeuchtigkeit-Kalibrierungskoeffizient 4
-	int16_t  dig_H5;  // Luftfeuchtigkeit-Kalibrierungskoeffizient 5
-	int8_t   dig_H6;  // Luftfeuchtigkeit-Kalibrierungskoeffizient 6
-} bme280_calib_data_t;
-
-// BME280 Rohdaten-Struktur
-// Enthält die rohen ADC-Werte vom Sensor
-typedef struct {
-	uint32_t adc_T;  // Rohe Temperatur-ADC-Werte (20 Bit)
-	uint32_t adc_P;  // Rohe Druck-ADC-Werte (20 Bit)
-	uint32_t adc_H;  // Rohe Luftfeuchtigkeit-ADC-Werte (16 Bit)
-} bme280_raw_data_t;
-
-// BME280 verarbeitete Daten-Struktur
-// Enthält die finalen physikalischen Messwerte
-typedef struct {
-	int32_t temperature;  // Temperatur in 0.01°C (z.B. 2345 = 23.45°C)
-	uint32_t pressure;    // Druck in Pa (z.B. 101325 = 1013.25 hPa)
-	uint32_t humidity;    // Luftfeuchtigkeit in 0.01% (z.B. 4567 = 45.67%)
-} bme280_data_t;
-
-// BME280 Konfigurations-Struktur
-// Enthält die aktuellen Einstellungen des Sensors
-typedef struct {
-	uint8_t oversamp_temperature;  // Temperatur-Oversampling
-	uint8_t oversamp_pressure;     // Druck-Oversampling
-	uint8_t oversamp_humidity;     // Luftfeuchtigkeit-Oversampling
-	uint8_t filter;                // Filter-Einstellung
-	uint8_t standby_time;          // Standby-Zeit
-	uint8_t power_mode;            // Power-Modus
-} bme280_config_t;
-
-// Sensor-Initialisierung
-// Initialisiert den BME280-Sensor und lädt Kalibrierungsdaten
-uint8_t sensor_init(void);
-
-// Sensor-Kalibrierungsdaten laden
-// Liest alle Kalibrierungskoeffizienten vom Sensor
-uint8_t sensor_load_calibration(bme280_calib_data_t* calib_data);
-
-// Sensor-Konfiguration setzen
-// Konfiguriert den Sensor mit den angegebenen Parametern
-uint8_t sensor_set_config(const bme280_config_t* config);
-
-// Sensor-Konfiguration laden
-// Liest die aktuelle Konfiguration vom Sensor
-uint8_t sensor_get_config(bme280_config_t* config);
-
-// Sensor-Rohdaten lesen
-// Liest die rohen ADC-Werte vom Sensor
-uint8_t sensor_read_raw_data(bme280_raw_data_t* raw_data);
-
-// Sensor-Daten verarbeiten
-// Berechnet die physikalischen Werte aus den Rohdaten
-void sensor_process_data(const bme280_raw_data_t* raw_data, 
-                        const bme280_calib_data_t* calib_data, 
-                        bme280_data_t* processed_data);
-
-// Komplette Sensor-Messung
-// Führt eine vollständige Messung durch und gibt verarbeitete Daten zurück
-uint8_t sensor_read_data(bme280_data_t* data);
-
-// Temperatur messen
-// Misst nur die Temperatur
-uint8_t sensor_read_temperature(int32_t* temperature);
-
-// Druck messen
-// Misst nur den Druck
-uint8_t sensor_read_pressure(uint32_t* pressure);
-
-// Luftfeuchtigkeit messen
-// Misst nur die Luftfeuchtigkeit
-uint8_t sensor_read_humidity(uint32_t* humidity);
-
-// Sensor-Chip-ID prüfen
-// Prüft ob der Sensor korrekt antwortet
-uint8_t sensor_check_id(void);
-
-// Sensor-Reset durchführen
-// Führt einen Software-Reset des Sensors durch
-uint8_t sensor_reset(void);
-
-// Sensor-Power-Modus setzen
-// Ändert den Power-Modus des Sensors
-uint8_t sensor_set_power_mode(uint8_t mode);
-
-// Sensor-Oversampling setzen
-// Ändert die Oversampling-Einstellungen
-uint8_t sensor_set_oversampling(uint8_t temp_oversamp, uint8_t press_oversamp, uint8_t hum_oversamp);
-
-// Sensor-Filter setzen
-// Ändert die Filter-Einstellung
-uint8_t sensor_set_filter(uint8_t filter);
-
-// Sensor-Standby-Zeit setzen
-// Ändert die Standby-Zeit im Normal-Modus
-uint8_t sensor_set_standby_time(uint8_t standby_time);
-
-// Sensor-Status prüfen
-// Prüft ob der Sensor bereit ist
-uint8_t sensor_is_ready(void);
-
-// Sensor-Statistiken
-// Gibt Informationen über Sensor-Nutzung zurück
-typedef struct {
-	uint16_t measurements;        // Anzahl durchgeführter Messungen
-	uint16_t errors;              // Anzahl aufgetretener Fehler
-	uint16_t calibration_errors;  // Anzahl Kalibrierungsfehler
-	uint8_t  is_initialized;      // Initialisierungsstatus
-	uint8_t  is_ready;            // Bereitschaftsstatus
-} sensor_stats_t;
-
-// Sensor-Statistiken abrufen
-// Liest aktuelle Sensor-Statistiken
-void sensor_get_stats(sensor_stats_t* stats);
-
-// Sensor-Statistiken zurücksetzen
-// Setzt alle Zähler zurück
-void sensor_reset_stats(void);
-
-// Sensor-Selbsttest
-// Führt einen Selbsttest des Sensors durch
-uint8_t sensor_self_test(void);
-
-// Sensor-Temperatur-Kompensation
-// Kompensiert Temperatur-Einflüsse auf andere Messungen
-int32_t sensor_compensate_temperature(int32_t adc_T, bme280_calib_data_t* calib_data);
-
-// Sensor-Druck-Kompensation
-// Kompensiert Druck-Messungen basierend auf Temperatur
-uint32_t sensor_compensate_pressure(int32_t adc_P, int32_t t_fine, bme280_calib_data_t* calib_data);
-
-// Sensor-Luftfeuchtigkeit-Kompensation
-// Kompensiert Luftfeuchtigkeit-Messungen basierend auf Temperatur
-uint32_t sensor_compensate_humidity(int32_t adc_H, int32_t t_fine, bme280_calib_data_t* calib_data);
+// Treiber-Funktionen aus Sensor.c
+// Diese Funktionen werden von main.c und dem Messwert-Cache verwendet
+
+// Alle Funktionen kehren nach begrenzter Zeit zurück (Timeouts, höchstens
+// I2C_RETRY_COUNT Versuche) und liefern I2C_OK oder einen I2C-Fehlercode
+
+// BME280 initialisieren (Messmodus und Standby-Zeit setzen)
+uint8_t bme280_init(void);
+
+// Kalibrierungsdaten vom Sensor lesen
+// Schlägt das beim Start fehl, wird es bei der nächsten Messung nachgeholt
+uint8_t bme280_read_calibration(void);
+
+// Temperatur (0.1°C), Druck (0.1 hPa) und Feuchte (0.1%) lesen und kompensieren
+// Kostet eine komplette I2C-Transaktion - besser über sample_get() abfragen
+// Bei einem Fehler bleiben die Ausgabewerte unverändert
+uint8_t bme280_read_measurement(int16_t* temp, uint16_t* press, uint16_t* hum);
+
+// Einzelschritte von bme280_read_measurement() (auch für den Benchmark, bench/bench.c)
+// Kalibrierung aus den Registerblöcken 0x88..0xA1 (26 Bytes) und 0xE1..0xE7 (7 Bytes)
+void bme280_parse_calibration(const uint8_t* calib);
+void bme280_parse_calibration_h(const uint8_t* calib);
+// Rohwerte lesen, dann kompensieren: Temperatur zuerst (liefert t_fine für Druck und Feuchte)
+uint8_t bme280_read_raw(int32_t* temp_raw, int32_t* press_raw, int32_t* hum_raw);
+int32_t bme280_compensate_temp(int32_t adc_T);      // 0.01°C
+uint32_t bme280_compensate_press(int32_t adc_P);    // Pa, auf Meereshöhe umgerechnet
+uint16_t bme280_compensate_hum(int32_t adc_H);      // 0.1%
 
 #endif /* SENSOR_H_ */
\ No newline at end of file
@@ -0,0 +1,45 @@
+/*
+ * arena.c
+ *
+ * Gemeinsamer Speicherbereich kurzlebiger Puffer (Phasen siehe arena.h)
+ *
+ * Created: 18.10.2026 20:17:45
+ *  Author: morri
+ */
+
+#include <stddef.h>
+#include "arena.h"
+#include "ram.h"
+#include "trace.h"
+
+arena_t arena;
+
+static uint8_t  phase;       // Aktuelle Phase (ARENA_*)
+static uint16_t conflicts;
+
+// ARENA_RENDER rechnet die Pixelzeilen an Ort und Stelle aus dem Verlauf um
+// (Zeile i überschreibt nur Werte mit Index <= i, die schon gelesen sind)
+_Static_assert(offsetof(arena_t, render.rows) == offsetof(arena_t, graph.values), "Pixelzeilen müssen am Anfang liegen");
+_Static_assert(sizeof(((arena_t*)0)->render.rows) <= sizeof(((arena_t*)0)->graph.values), "Pixelzeilen passen nicht");
+
+RAM_ACCOUNT(arena, sizeof(arena) + sizeof(phase) + sizeof(conflicts));
+
+uint8_t arena_begin(uint8_t p) {
+	// Übergang vom geladenen Verlauf zum Zeichnen ist erlaubt, sonst muss der Bereich frei sein
+	if (phase != ARENA_FREE && !(phase == ARENA_GRAPH && p == ARENA_RENDER)) {
+		conflicts++;
+		TRACE(TRACE_ARENA, phase, p);
+		return 0;
+	}
+	phase = p;
+	return 1;
+}
+
+void arena_end(void) {
+	phase = ARENA_FREE;
+}
+
+void arena_get_stats(arena_stats_t* stats) {
+	stats->size      = sizeof(arena);
+	stats->conflicts = conflicts;
+}
@@ -0,0 +1,69 @@
+/*
+ * arena.h
+ *
+ * Header-Datei für den gemeinsamen Speicherbereich kurzlebiger Puffer
+ * Kalibrierdaten des Sensors, der geladene Verlauf und der Seitenpuffer des
+ * Displays werden nie gleichzeitig gebraucht. Statt je eines eigenen Puffers
+ * teilen sie sich einen Bereich (Union), belegt in Phasen:
+ *
+ *   ARENA_BOOT    Kalibrierdaten des BME280 (Start, Neu-Einrichtung des Sensors)
+ *   ARENA_GRAPH   Verlauf aus dem EEPROM (int16), wird in Pixelzeilen umgerechnet
+ *   ARENA_RENDER  Pixelzeilen des Verlaufs und Seitenpuffer (Zeichnen, Übertragen)
+ *
+ * Eine Phase gilt nur innerhalb eines Aufrufs (einer Aufgabe des Schedulers),
+ * Interrupts benutzen den Bereich nie. ARENA_RENDER übernimmt die Pixelzeilen
+ * aus ARENA_GRAPH (gleiche Position, zur Compile-Zeit geprüft), jede andere
+ * Überschneidung wird beim Belegen erkannt und gezählt.
+ *
+ * Created: 18.10.2026 20:17:45
+ *  Author: morri
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdint.h>
+#include "storage.h"   // DISPLAY_COUNT
+#include "display.h"   // DISPLAY_WIDTH
+
+// Phasen
+#define ARENA_FREE         0
+#define ARENA_BOOT         1
+#define ARENA_GRAPH        2
+#define ARENA_RENDER       3
+
+#define ARENA_CALIB_LEN    26    // Größter Block der BME280-Kalibrierdaten (0x88..0xA1)
+#define ARENA_ROW_GAP      0xFF  // Pixelzeile für eine Lücke im Verlauf
+
+typedef union {
+	struct {
+		uint8_t calib[ARENA_CALIB_LEN];
+	} boot;
+	struct {
+		int16_t values[DISPLAY_COUNT];     // Verlauf, neuester Wert zuerst
+	} graph;
+	struct {
+		uint8_t rows[DISPLAY_COUNT];       // Pixelzeile je Punkt (ARENA_ROW_GAP = Lücke)
+		uint8_t page[DISPLAY_WIDTH];       // Eine Display-Seite (8 Pixelzeilen)
+	} render;
+} arena_t;
+
+extern arena_t arena;
+
+// Statistik
+typedef struct {
+	uint16_t size;       // Größe des Bereichs (Bytes)
+	uint16_t conflicts;  // Abgewiesene Belegungen (Bereich schon in einer anderen Phase)
+} arena_stats_t;
+
+// Bereich für eine Phase belegen
+// Rückgabe: 1 = belegt, 0 = Bereich ist in einer anderen Phase (nicht benutzen)
+uint8_t arena_begin(uint8_t phase);
+
+// Bereich freigeben
+void arena_end(void);
+
+// Statistik abrufen
+void arena_get_stats(arena_stats_t* stats);
+
+#endif /* ARENA_H_ */
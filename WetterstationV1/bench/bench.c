@@ -0,0 +1,333 @@
+/*
+ * bench.c
+ *
+ * Taktgenauer Benchmark der Rechenkerne für den ATmega8 (läuft unter simavr)
+ * Jeder Kern wird mehrfach mit festen Eingaben aufgerufen, gemessen wird mit
+ * Timer1 ohne Prescaler (ein Schritt = ein CPU-Takt, Überlauf in Software
+ * verlängert). Der Aufwand der Messung und der Überlauf-Interrupts wird
+ * abgezogen: unter 65536 Takten ist das Ergebnis exakt, darüber auf wenige
+ * Takte je Überlauf.
+ *
+ * Ausgabe über den UART (abgefragt, ohne Interrupt), eine Zeile je Kern:
+ *   K:<Name>;<Aufrufe>;<Minimum>;<Maximum>;<Summe>
+ * und zum Schluss "END". Danach schläft die CPU mit gesperrten Interrupts,
+ * simavr beendet sich damit. Flash- und RAM-Bedarf ergänzt tools/avr_bench.py
+ * aus dem ELF und den .su-Dateien.
+ *
+ * Alle Kerne zusammen passen nicht in die 8 KB Flash des ATmega8 (RCALL/RJMP
+ * reichen nicht über das ganze Abbild), daher wird je Gruppe ein eigenes Abbild
+ * gebaut (BENCH_GROUP).
+ *
+ * Kein Teil der Firmware (nicht im Atmel-Studio-Projekt), gebaut wird mit
+ * bench/CMakeLists.txt.
+ *
+ * Created: 18.10.2026 23:41:52
+ *  Author: morri
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/delay_basic.h>
+#include "hal.h"
+#include "Sensor.h"
+#include "display.h"
+#include "fmt.h"
+#include "storage.h"
+#include "sample.h"
+#include "arena.h"
+#include "rs232.h"
+
+// Gemessene Gruppe: 0 alle (nur für Controller mit mehr Flash), sonst eine der folgenden
+#define BENCH_SENSOR  1
+#define BENCH_FMT     2
+#define BENCH_DISPLAY 3
+#define BENCH_STORAGE 4
+#ifndef BENCH_GROUP
+#define BENCH_GROUP 0
+#endif
+#define BENCH_RUN(g) (BENCH_GROUP == 0 || BENCH_GROUP == (g))
+
+// Messwerte wie in main.c (display.c zeigt sie an)
+int16_t  dataT;
+uint16_t dataP;
+uint16_t dataH;
+
+// Ergebnisse landen hier, damit der Compiler die Aufrufe nicht wegoptimiert
+static volatile uint32_t sink;
+
+// Timer1-Überläufe seit bench_start()
+static volatile uint16_t ovf;
+
+// Aufwand einer leeren Messung und eines Überlauf-Interrupts (Takte)
+static uint16_t cost_empty;
+static uint16_t cost_ovf;
+
+// Statistik eines Kerns (lokal je Gruppe und gleich danach ausgegeben, statisch
+// belegten alle 14 zusammen 224 Byte und das Abbild passte nicht mehr in 1 KB RAM)
+typedef struct {
+	uint32_t calls;
+	uint32_t min;
+	uint32_t max;
+	uint32_t sum;
+} bench_stats_t;
+
+ISR(TIMER1_OVF_vect) {
+	ovf++;
+}
+
+// Messung starten
+static inline void bench_start(void) {
+	cli();
+	ovf = 0;
+	TCNT1 = 0;
+	TIFR = (1 << TOV1);  // Wartenden Überlauf löschen
+	sei();
+	__asm__ __volatile__("" ::: "memory");
+}
+
+// Messung beenden, Rückgabe: Takte seit bench_start() (roh, mit Überläufen)
+// n_ovf: Anzahl der Überlauf-Interrupts während der Messung
+static inline uint32_t bench_stop_raw(uint16_t* n_ovf) {
+	__asm__ __volatile__("" ::: "memory");
+	uint16_t t = TCNT1;
+	cli();
+	uint16_t o = ovf;
+	// Überlauf zwischen dem Lesen von TCNT1 und cli(): noch nicht mitgezählt
+	if ((TIFR & (1 << TOV1)) && t < 0x8000) o++;
+	sei();
+	*n_ovf = o;
+	return ((uint32_t)o << 16) | t;
+}
+
+// Messung beenden, Rückgabe: Takte des gemessenen Codes
+static uint32_t bench_stop(void) {
+	uint16_t n;
+	uint32_t c = bench_stop_raw(&n);
+	c -= cost_empty + (uint32_t)n * cost_ovf;
+	return c;
+}
+
+// Aufwand der Messung bestimmen
+// _delay_loop_2(n) braucht genau 4 Takte je Durchlauf: einmal ohne Überlauf
+// (Aufwand des Aufrufs), einmal mit mehreren (Aufwand je Interrupt)
+static void bench_calibrate(void) {
+	uint16_t n;
+	bench_start();
+	cost_empty = (uint16_t)bench_stop_raw(&n);
+
+	bench_start();
+	_delay_loop_2(10000);
+	uint32_t c_call = bench_stop_raw(&n) - cost_empty - 4UL * 10000;
+
+	bench_start();
+	_delay_loop_2(60000);
+	uint32_t c = bench_stop_raw(&n) - cost_empty - c_call - 4UL * 60000;
+	cost_ovf = n ? (uint16_t)(c / n) : 0;
+}
+
+static void stats_add(bench_stats_t* s, uint32_t c) {
+	if (!s->calls || c < s->min) s->min = c;
+	if (c > s->max) s->max = c;
+	s->sum += c;
+	s->calls++;
+}
+
+// Einen Ausdruck messen und in die Statistik s eintragen
+#define MEASURE(s, expr) do { bench_start(); expr; stats_add(&(s), bench_stop()); } while (0)
+
+// --- Ausgabe (UART abgefragt) ---
+
+static void out_char(char c) {
+	while (!hal_uart_tx_free());
+	hal_uart_put(c);
+}
+
+static void out_str(const char* s) {
+	while (*s) out_char(*s++);
+}
+
+static void out_u32(uint32_t v) {
+	char buf[FMT_U32_LEN];
+	fmt_u32(v, buf);
+	out_str(buf);
+}
+
+static void report(const char* name, const bench_stats_t* s) {
+	out_str("K:");
+	out_str(name);
+	out_char(';'); out_u32(s->calls);
+	out_char(';'); out_u32(s->min);
+	out_char(';'); out_u32(s->max);
+	out_char(';'); out_u32(s->sum);
+	out_str("\r\n");
+}
+
+// --- Kerne ---
+
+// Kalibrierung eines BME280 (Beispielwerte aus dem Datenblatt, Feuchte typisch)
+static const uint8_t calib_tp[26] = {
+	0x70, 0x6B,  0x43, 0x67,  0x18, 0xFC,              // T1 27504, T2 26435, T3 -1000
+	0x7D, 0x8E,  0x43, 0xD6,  0xD0, 0x0B,  0x27, 0x0B, // P1 36477, P2 -10685, P3 3024, P4 2855
+	0x8C, 0x00,  0xF9, 0xFF,  0x8C, 0x3C,              // P5 140, P6 -7, P7 15500
+	0xF8, 0xC6,  0x70, 0x17,                           // P8 -14600, P9 6000
+	0x00, 0x4B                                         // (frei), H1 75
+};
+static const uint8_t calib_h[7] = {
+	0x6A, 0x01,  0x00,  0x13, 0x29, 0x03,  0x1E        // H2 362, H3 0, H4 313, H5 50, H6 30
+};
+
+// Rohwerte (Temperatur, Druck, Feuchte) von kalt/tief bis warm/hoch
+static const int32_t adc_t[] = { 400000, 480000, 519888, 560000, 620000 };
+static const int32_t adc_p[] = { 250000, 300000, 415148, 450000, 520000 };
+static const int32_t adc_h[] = { 20000, 25000, 30000, 35000, 45000 };
+#define ADC_COUNT (sizeof(adc_t) / sizeof(adc_t[0]))
+
+static void bench_sensor(void) {
+	bench_stats_t st_temp = { 0 }, st_press = { 0 }, st_hum = { 0 };
+
+	bme280_parse_calibration(calib_tp);
+	bme280_parse_calibration_h(calib_h);
+	for (uint8_t r = 0; r < 4; r++) {
+		for (uint8_t i = 0; i < ADC_COUNT; i++) {
+			// Temperatur zuerst: liefert t_fine für Druck und Feuchte
+			MEASURE(st_temp,  sink = bme280_compensate_temp(adc_t[i]));
+			MEASURE(st_press, sink = bme280_compensate_press(adc_p[i]));
+			MEASURE(st_hum,   sink = bme280_compensate_hum(adc_h[i]));
+		}
+	}
+	report("bme280_compensate_temp", &st_temp);
+	report("bme280_compensate_press", &st_press);
+	report("bme280_compensate_hum", &st_hum);
+}
+
+static void bench_fmt(void) {
+	bench_stats_t st_u16 = { 0 }, st_i16 = { 0 }, st_u32 = { 0 }, st_i32 = { 0 };
+	static const uint16_t v16[] = { 0, 7, 42, 235, 1013, 9999, 10132, 65535 };
+	static const uint32_t v32[] = { 0, 9, 101325, 1234567, 4294967295UL };
+	char buf[FMT_I32_LEN];
+	for (uint8_t i = 0; i < sizeof(v16) / sizeof(v16[0]); i++) {
+		MEASURE(st_u16, sink = fmt_u16(v16[i], buf));
+		MEASURE(st_i16, sink = fmt_i16((int16_t)v16[i], buf));  // 65535 wird -1
+	}
+	for (uint8_t i = 0; i < sizeof(v32) / sizeof(v32[0]); i++) {
+		MEASURE(st_u32, sink = fmt_u32(v32[i], buf));
+		MEASURE(st_i32, sink = fmt_i32(-(int32_t)(v32[i] >> 1), buf));
+	}
+	report("fmt_u16", &st_u16);
+	report("fmt_i16", &st_i16);
+	report("fmt_u32", &st_u32);
+	report("fmt_i32", &st_i32);
+}
+
+// Verlauf wie ein Temperaturtag: Sinus-ähnlich aus Geradenstücken, mit einer Lücke
+static void fill_graph(void) {
+	arena_end();
+	arena_begin(ARENA_GRAPH);
+	int16_t v = 180;
+	for (uint8_t i = 0; i < DISPLAY_COUNT; i++) {
+		v += (i < DISPLAY_COUNT / 2) ? 3 : -2;
+		arena.graph.values[i] = (i >= 40 && i < 44) ? SAMPLE_GAP_VALUE : v;
+	}
+}
+
+static void bench_display(void) {
+	bench_stats_t st_line = { 0 }, st_char = { 0 }, st_prepare = { 0 }, st_plot = { 0 }, st_scene = { 0 };
+
+	// Linien: waagerecht, senkrecht, flach, steil, über mehrere Seiten
+	static const uint8_t lines[][4] = {
+		{ 0, 3, 127, 3 }, { 10, 0, 10, 63 }, { 0, 0, 127, 20 },
+		{ 30, 63, 40, 0 }, { 127, 10, 0, 50 }, { 64, 32, 65, 33 }
+	};
+	for (uint8_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+		for (uint8_t pg = 0; pg < 8; pg++) {
+			clearPage(pg);
+			MEASURE(st_line, bench_drawLine(lines[i][0], lines[i][1], lines[i][2], lines[i][3], pg));
+		}
+	}
+
+	// Zeichen: Ziffern und Sonderzeichen, auf einer und über zwei Seiten
+	static const char chars[] = "0123456789-.%CHPA";
+	for (uint8_t i = 0; chars[i]; i++) {
+		clearPage(2);
+		MEASURE(st_char, bench_drawChar(10, 16, chars[i], 2));
+		MEASURE(st_char, bench_drawChar(20, 20, chars[i], 2));
+	}
+
+	// Graph: Pixelzeilen berechnen, dann alle Seiten zeichnen
+	for (uint8_t r = 0; r < 4; r++) {
+		fill_graph();
+		MEASURE(st_prepare, prepareGraph());
+	}
+	for (uint8_t pg = 0; pg < 8; pg++) {
+		clearPage(pg);
+		MEASURE(st_plot, bench_drawPlot8(pg));
+	}
+
+	// Ganze Szenen (Graphen und Messwert-Seite), jede Seite des Displays
+	dataT = 235;
+	dataP = 10132;
+	dataH = 555;
+	for (uint8_t scene = 0; scene < 5; scene++) {
+		for (uint8_t pg = 0; pg < 8; pg++) {
+			clearPage(pg);
+			MEASURE(st_scene, renderScene(scene, pg));
+		}
+	}
+	arena_end();
+	report("drawLine", &st_line);
+	report("drawChar", &st_char);
+	report("prepareGraph", &st_prepare);
+	report("drawPlot8", &st_plot);
+	report("renderScene", &st_scene);
+}
+
+static void bench_storage(void) {
+	bench_stats_t st_load = { 0 }, st_add = { 0 };
+
+	storage_init();
+
+	// Verlauf für jede Graph-Seite aus dem EEPROM laden
+	// (in simavr ohne angeschlossenes EEPROM: gemessen wird der SPI-Verkehr und die Aufbereitung)
+	for (uint8_t page = 1; page <= 4; page++) {
+		arena_end();
+		arena_begin(ARENA_GRAPH);
+		MEASURE(st_load, storage_load_graph(page, arena.graph.values));
+	}
+	arena_end();
+
+	// Mittelwerte sammeln: gleichbleibende Messwerte, also ohne Schreibzugriff
+	// (der erste Aufruf startet die Zeitspannen und schreibt, er zählt nicht)
+	storage_add_sample(0, SAMPLE_OK, 235, 10132, 555);
+	for (uint8_t i = 1; i <= 32; i++) {
+		MEASURE(st_add, storage_add_sample(i * 2, SAMPLE_OK, 235 + (i & 1), 10132, 555));
+	}
+	report("storage_load_graph", &st_load);
+	report("storage_add_sample", &st_add);
+}
+
+int main(void) {
+	hal_uart_init(F_CPU / 16 / RS232_BAUDRATE - 1);
+
+	// Timer1: Normalmodus, ohne Prescaler, Überlauf-Interrupt
+	TCCR1A = 0;
+	TCCR1B = (1 << CS10);
+	TIMSK |= (1 << TOIE1);
+	sei();
+	bench_calibrate();
+
+	if (BENCH_RUN(BENCH_SENSOR))  bench_sensor();
+	if (BENCH_RUN(BENCH_FMT))     bench_fmt();
+	if (BENCH_RUN(BENCH_DISPLAY)) bench_display();
+	if (BENCH_RUN(BENCH_STORAGE)) bench_storage();
+
+	out_str("END\r\n");
+	while (!hal_uart_tx_done());
+
+	// Ende: simavr beendet sich beim Schlafen mit gesperrten Interrupts
+	cli();
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	sleep_enable();
+	sleep_cpu();
+	for (;;);
+}
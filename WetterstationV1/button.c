@@ -0,0 +1,132 @@
+/*
+ * button.c
+ *
+ * Taster an PC3: Entprellung im Tick-Interrupt, Ereignis-Warteschlange
+ * Der Pegel gilt erst, wenn er BUTTON_DEBOUNCE_TICKS Ticks hintereinander
+ * gleich ist. Ein Druck wird sofort nach der Entprellung gemeldet, langer
+ * Druck und Wiederholung folgen, solange der Taster gehalten wird.
+ *
+ * Created: 18.10.2026 17:48:36
+ *  Author: morri
+ */
+
+#include "hal.h"
+#include "button.h"
+#include "sched.h"
+#include "timebase.h"
+#include "ram.h"
+
+// Zustand der Entprellung (nur Tick-Interrupt)
+static uint8_t stable = 1;      // Entprellter Pegel (1 = nicht gedrückt)
+static uint8_t change;          // Ticks mit abweichendem Pegel
+static uint8_t hold;            // Ticks seit Druck bzw. letzter Meldung
+static uint8_t long_sent;       // 1 = langer Druck für diesen Druck schon gemeldet
+
+// Warteschlange (Interrupt schreibt, Hauptprogramm liest)
+static button_event_t queue[BUTTON_QUEUE_SIZE];
+static volatile uint8_t q_head, q_tail;
+
+#if DIAG_ENABLE
+// Latenzmessung: ältester Druck, dessen Bild noch nicht gezeichnet ist
+static uint8_t  shown_pending;
+static uint32_t shown_since;
+
+static button_stats_t stats;
+
+RAM_ACCOUNT(button, sizeof(stable) + sizeof(change) + sizeof(hold) + sizeof(long_sent)
+                    + sizeof(queue) + sizeof(q_head) + sizeof(q_tail)
+                    + sizeof(shown_pending) + sizeof(shown_since) + sizeof(stats));
+#else
+RAM_ACCOUNT(button, sizeof(stable) + sizeof(change) + sizeof(hold) + sizeof(long_sent)
+                    + sizeof(queue) + sizeof(q_head) + sizeof(q_tail));
+#endif
+
+// Ereignis eintragen und die Taster-Aufgabe wecken (aus dem Interrupt)
+static void button_queue(uint8_t type) {
+	uint8_t next = (q_head + 1) & (BUTTON_QUEUE_SIZE - 1);
+	if (next == q_tail) {
+		DIAG(stats.dropped++);
+		return;
+	}
+	queue[q_head].type   = type;
+	DIAG(queue[q_head].counts = timebase_counts());
+	q_head = next;
+	sched_post(SCHED_EV_BUTTON);
+}
+
+void button_init(void) {
+	hal_button_init();  // Pin als Eingang mit Pull-up-Widerstand
+}
+
+void button_tick(void) {
+	uint8_t level = hal_button_level();
+
+	if (level != stable) {
+		if (++change < BUTTON_DEBOUNCE_TICKS) return;
+		change = 0;
+		stable = level;
+		if (!stable) {
+			// Gedrückt (fallende Flanke)
+			hold = 0;
+			long_sent = 0;
+			button_queue(BUTTON_EV_PRESS);
+		}
+		return;
+	}
+	change = 0;
+
+	// Gehalten: erst langer Druck, danach Wiederholungen
+	if (!stable) {
+		hold++;
+		if (!long_sent) {
+			if (hold >= BUTTON_LONG_TICKS) {
+				hold = 0;
+				long_sent = 1;
+				button_queue(BUTTON_EV_LONG);
+			}
+		} else if (hold >= BUTTON_REPEAT_TICKS) {
+			hold = 0;
+			button_queue(BUTTON_EV_REPEAT);
+		}
+	}
+}
+
+uint8_t button_get(button_event_t* ev) {
+	if (q_tail == q_head) return 0;
+	cli();
+	*ev = queue[q_tail];
+	q_tail = (q_tail + 1) & (BUTTON_QUEUE_SIZE - 1);
+	sei();
+
+	#if DIAG_ENABLE
+	if (ev->type == BUTTON_EV_PRESS)     stats.presses++;
+	else if (ev->type == BUTTON_EV_LONG) stats.longs++;
+	else                                 stats.repeats++;
+
+	if (!shown_pending) {
+		shown_pending = 1;
+		shown_since   = ev->counts;
+	}
+	#endif
+	return 1;
+}
+
+#if DIAG_ENABLE
+void button_shown(void) {
+	if (!shown_pending) return;
+	shown_pending = 0;
+
+	uint32_t ms = TIMEBASE_COUNTS_TO_MS(timebase_counts() - shown_since);
+	if (ms > 0xFFFF) ms = 0xFFFF;
+	stats.latency_last_ms = ms;
+	if (ms > stats.latency_max_ms)  stats.latency_max_ms = ms;
+	if (ms > BUTTON_LATENCY_MAX_MS) stats.late++;
+}
+
+void button_get_stats(button_stats_t* out) {
+	uint8_t sreg = SREG;
+	cli();
+	*out = stats;
+	SREG = sreg;
+}
+#endif
@@ -0,0 +1,74 @@
+/*
+ * button.h
+ *
+ * Header-Datei für den Taster (PC3)
+ * Der ATmega8 hat an PC3 keinen Pin-Change- oder externen Interrupt, der Pin
+ * wird deshalb im Tick-Interrupt des Schedulers (10 ms) abgetastet und dort
+ * entprellt. Erkannte Tastendrücke landen in einer kleinen Warteschlange und
+ * wecken die Taster-Aufgabe (SCHED_EV_BUTTON), es geht also kein Druck
+ * verloren, während eine lange Aufgabe läuft.
+ *
+ * Created: 18.10.2026 17:48:36
+ *  Author: morri
+ */
+
+#ifndef BUTTON_H_
+#define BUTTON_H_
+
+#include <stdint.h>
+#include "diag.h"
+
+// Zeiten in Ticks (10 ms)
+#define BUTTON_DEBOUNCE_TICKS  3    // Pegel muss 30 ms stabil sein
+#define BUTTON_LONG_TICKS      100  // Nach 1 s gedrückt: langer Druck
+#define BUTTON_REPEAT_TICKS    25   // Danach alle 250 ms eine Wiederholung
+
+#define BUTTON_QUEUE_SIZE      4    // Wartende Ereignisse (Zweierpotenz)
+
+// Schranke für die Zeit vom erkannten Druck bis zum neu gezeichneten Display
+#ifndef BUTTON_LATENCY_MAX_MS
+#define BUTTON_LATENCY_MAX_MS  200
+#endif
+
+// Ereignisse
+#define BUTTON_EV_PRESS        1    // Gedrückt (nach der Entprellung, nicht erst beim Loslassen)
+#define BUTTON_EV_LONG         2    // BUTTON_LONG_TICKS gehalten
+#define BUTTON_EV_REPEAT       3    // Weiter gehalten, alle BUTTON_REPEAT_TICKS
+
+typedef struct {
+	uint8_t  type;     // BUTTON_EV_*
+	#if DIAG_ENABLE
+	uint32_t counts;   // Zeitpunkt der Erkennung (timebase_counts, 1/3600 s, für die Latenz)
+	#endif
+} button_event_t;
+
+// Taster-Statistik (nur mit DIAG_ENABLE, diag.h)
+typedef struct {
+	uint16_t presses;          // Kurze Drücke (BUTTON_EV_PRESS)
+	uint16_t longs;            // Lange Drücke
+	uint16_t repeats;          // Wiederholungen
+	uint16_t dropped;          // Verworfene Ereignisse (Warteschlange voll)
+	uint16_t latency_last_ms;  // Druck bis neues Bild, letzter Druck
+	uint16_t latency_max_ms;   // Druck bis neues Bild, größter Wert
+	uint16_t late;             // Drücke über BUTTON_LATENCY_MAX_MS
+} button_stats_t;
+
+// Pin als Eingang mit Pull-up einrichten
+void button_init(void);
+
+// Pin abtasten und entprellen (aus dem Tick-Interrupt, alle 10 ms)
+void button_tick(void);
+
+// Nächstes Ereignis holen, Rückgabe: 1 = Ereignis in ev
+// Der älteste noch nicht angezeigte Druck startet die Latenzmessung
+uint8_t button_get(button_event_t* ev);
+
+#if DIAG_ENABLE
+// Reaktion ist sichtbar (Display neu gezeichnet): Latenzmessung abschließen
+void button_shown(void);
+
+// Taster-Statistik abrufen
+void button_get_stats(button_stats_t* stats);
+#endif
+
+#endif /* BUTTON_H_ */
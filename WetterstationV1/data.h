@@ -47,14 +47,6 @@ typedef struct {
 	int8_t   dig_H6;  // Luftfeuchtigkeit-Kalibrierungskoeffizient 6
 } bme280_calib_t;
 
-// Datenstruktur für rohe Sensordaten vom BME280
-// Diese Werte werden direkt vom Sensor gelesen und müssen noch verarbeitet werden
-typedef struct {
-	uint32_t adc_T;  // Rohe Temperatur-ADC-Werte (20 Bit)
-	uint32_t adc_P;  // Rohe Druck-ADC-Werte (20 Bit)
-	uint32_t adc_H;  // Rohe Luftfeuchtigkeit-ADC-Werte (16 Bit)
-} bme280_raw_data_t;
-
 // Datenstruktur für verarbeitete Sensordaten
 // Diese Werte sind die finalen physikalischen Messwerte
 typedef struct {
@@ -129,30 +121,4 @@ typedef struct {
 #define ERROR_INVALID_DATA    4       // Ungültige Daten
 #define ERROR_CONFIG_CORRUPT  5       // Beschädigte Konfiguration
 
-// Funktionen für Datenverwaltung
-// Diese Funktionen werden in anderen Modulen implementiert
-
-// Konfiguration laden/speichern
-uint8_t config_load(config_t* config);
-uint8_t config_save(const config_t* config);
-uint8_t config_init(config_t* config);
-
-// Sensordaten verarbeiten
-uint8_t sensor_read_raw(bme280_raw_data_t* raw_data);
-uint8_t sensor_process_data(const bme280_raw_data_t* raw_data, 
-                           const bme280_calib_t* calib, 
-                           sensor_data_t* processed_data);
-
-// Datenpunkte speichern/laden
-uint8_t data_save_point(const data_point_t* point);
-uint8_t data_load_point(uint16_t index, data_point_t* point);
-uint16_t data_get_count(void);
-
-// Statistiken berechnen
-uint8_t stats_calculate_24h(statistics_t* stats);
-uint8_t stats_calculate_7d(statistics_t* stats);
-
-// Kalibrierungsdaten laden
-uint8_t calib_load(bme280_calib_t* calib);
-
 #endif /* DATA_H_ */
@@ -0,0 +1,32 @@
+/*
+ * diag.h
+ *
+ * Schalter für die Diagnose im Betrieb
+ * Mit DIAG_ENABLE 1 zählen Scheduler (Laufzeit je Aufgabe, Idle-Anteil),
+ * Taster (Drücke, Latenz), EEPROM- und Display-Treiber mit, ram.c misst die
+ * Stacktiefe, und main.c sendet die Berichte reihum als TASK_STATUS,
+ * INPUT_STATUS, DRIVER_STATUS und RAM_STATUS an den ESP8266.
+ *
+ * Standard aus (Flash-Budget des ATmega8): die Zähler und Rahmen entfallen,
+ * STATUS und LINK_STATUS bleiben.
+ *
+ * Created: 18.10.2026 23:58:12
+ *  Author: morri
+ */
+
+#ifndef DIAG_H_
+#define DIAG_H_
+
+// Diagnose ein-/ausschalten (zur Compile-Zeit, z.B. -DDIAG_ENABLE=1)
+#ifndef DIAG_ENABLE
+#define DIAG_ENABLE        0
+#endif
+
+// Anweisung nur mit Diagnose übersetzen (Zähler in den Treibern)
+#if DIAG_ENABLE
+#define DIAG(stmt)         do { stmt; } while (0)
+#else
+#define DIAG(stmt)         do { } while (0)
+#endif
+
+#endif /* DIAG_H_ */
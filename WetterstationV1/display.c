@@ -13,27 +13,38 @@
 #include <avr/pgmspace.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "ks0108.h"
+#include "sample.h"
+#include "fmt.h"
+#include "ram.h"
+#include "arena.h"
+
+// Der Graph hat genau einen Datenpunkt je Spalte
+_Static_assert(PLOT_X1 - PLOT_X0 + 1 == DISPLAY_COUNT, "Graphenbreite muss DISPLAY_COUNT entsprechen");
 
 // Makro für absoluten Wert (vermeidet negative Zahlen)
 #define ABS(x) ((x) < 0 ? -(x) : (x))
 
-// Globale Variablen für Display-Buffer und Inversion
-uint8_t pageBuf[SCREEN_W];  // Puffer für eine Display-Seite (128 Bytes)
-bool    displayInverted = false;  // Inversion ein/aus (aktuell nicht verwendet)
+// Der Seitenpuffer liegt im gemeinsamen Bereich (arena.render.page, nur während des Zeichnens)
+static int16_t graphMin, graphMax;  // Wertebereich des Verlaufs (Beschriftung der Y-Achse)
+
+RAM_ACCOUNT(display, sizeof(graphMin) + sizeof(graphMax));
 
 /* Icons und Glyphen - im Programmspeicher gespeichert (Flash-ROM) */
 // Temperatur-Icon (11x11 Pixel)
 static const uint8_t icoT[11] PROGMEM = {0x18,0x24,0x34,0x24,0x34,0x24,0x42,0x5A,0x5A,0x42,0x3C};
 // Druck-Icon (11x11 Pixel)  
 static const uint8_t icoP[11] PROGMEM = {0x08,0x08,0x2A,0x1C,0x08,0x00,0x10,0x38,0x54,0x10,0x10};
+// Feuchte-Icon (Tropfen, 11x11 Pixel)
+static const uint8_t icoH[11] PROGMEM = {0x10,0x10,0x28,0x28,0x44,0x44,0x82,0x82,0x82,0x44,0x38};
 
 // Font-Glyphen für Zahlen und Sonderzeichen (3x5 Pixel pro Zeichen)
 static const uint8_t glyphs[][FONT_W] PROGMEM = {
     {0x1F,0x11,0x1F},{0x11,0x1F,0x10},{0x1D,0x15,0x17},{0x15,0x15,0x1F},{0x07,0x04,0x1F},  // 0-4
     {0x17,0x15,0x1D},{0x1F,0x15,0x1D},{0x01,0x01,0x1F},{0x1F,0x15,0x1F},{0x17,0x15,0x1F},  // 5-9
     {0x00,0x10,0x00},{0x04,0x04,0x04},{0x06,0x09,0x06},{0x0E,0x11,0x11},{0x1F,0x11,0x0E},  // ,-O
-    {0x1F,0x04,0x1F},{0x1F,0x05,0x07},{0x1E,0x05,0x1E}  // C-D-H-P-A
+    {0x1F,0x04,0x1F},{0x1F,0x05,0x07},{0x1E,0x05,0x1E},{0x19,0x04,0x13}  // C-D-H-P-A-%
 };
 
 // Konvertiert ein Zeichen in den entsprechenden Glyphen-Index
@@ -42,6 +53,7 @@ static uint8_t glyphIndex(char c) {
     switch (c) {
         case ',': return 10; case '-': return 11; case 'O': return 12; case 'C': return 13;
         case 'D': return 14; case 'H': return 15; case 'P': return 16; case 'A': return 17;
+        case '%': return 18;
         default:  return 0xFF;  // Ungültiges Zeichen
     }
 }
@@ -55,7 +67,7 @@ static void drawLine(int x0, int y0, int x1, int y1, uint8_t pg) {
     while (1) {
         // Pixel setzen, falls innerhalb der Display-Grenzen
         if (x0>=0 && x0<SCREEN_W && y0>=yb && y0<yb+8)
-            pageBuf[x0] |= 1 << (y0-yb);  // Bit in pageBuf setzen
+            arena.render.page[x0] |= 1 << (y0-yb);  // Bit im Seitenpuffer setzen
         
         // Ende erreicht?
         if (x0==x1 && y0==y1) break;
@@ -82,7 +94,7 @@ static void drawBitmap(int x, int y, const uint8_t *bmp, uint8_t pg) {
         // 8 Bits pro Zeile verarbeiten
         for (uint8_t c=0; c<8; c++) if (bits & (0x80>>c)) {
             int xx = x + c;  // X-Position für aktuelles Bit
-            if (xx>=0 && xx<SCREEN_W) pageBuf[xx] |= 1 << (yy-yb);  // Pixel setzen
+            if (xx>=0 && xx<SCREEN_W) arena.render.page[xx] |= 1 << (yy-yb);  // Pixel setzen
         }
     }
 }
@@ -102,7 +114,7 @@ static void drawChar(int x, int y, char ch, uint8_t pg) {
         for (uint8_t b=0; b<FONT_H; b++) if (bits & (1<<b)) {
             int yy=y+b, xx=x+col;  // Pixel-Position berechnen
             if (yy>=yb && yy<yb+8 && xx>=0 && xx<SCREEN_W) 
-                pageBuf[xx] |= 1 << (yy-yb);  // Pixel setzen
+                arena.render.page[xx] |= 1 << (yy-yb);  // Pixel setzen
         }
     }
 }
@@ -116,31 +128,49 @@ static void drawString(int x, int y, const char *s, uint8_t pg) {
     }
 }
 
-// Zeichnet einen Graphen aus 16-bit-Daten
-static void drawPlot16(const int16_t *data, uint8_t x0, uint8_t x1, int y0, int y1, uint8_t pg) {
-    int h = y1 - y0;  // Höhe des Graphen
-    int len = x1 - x0 + 1;  // Anzahl der Datenpunkte
-    int16_t mn = INT16_MAX, mx = INT16_MIN;  // Min/Max-Werte
-    
-    // Min/Max-Werte finden
+// Min/Max-Werte eines Graphen finden (Lücken werden übersprungen)
+// Besteht der Graph nur aus Lücken, wird 0/0 geliefert
+static void findMinMax(const int16_t *data, int len, int16_t *mn, int16_t *mx) {
+    *mn = INT16_MAX; *mx = INT16_MIN;
     for (int i = 0; i < len; i++) {
         int16_t v = data[i];
-        if (v < mn) mn = v;
-        if (v > mx) mx = v;
+        if (v == SAMPLE_GAP_VALUE) continue;  // Lücke
+        if (v < *mn) *mn = v;
+        if (v > *mx) *mx = v;
     }
+    if (*mn > *mx) { *mn = 0; *mx = 0; }  // Keine gültigen Werte
+}
+
+// Rechnet den Verlauf in Pixelzeilen um (einmal je Bild statt je Display-Seite)
+// Die Werte werden an Ort und Stelle überschrieben: Zeile i liegt im Byte i,
+// der Wert i ab Byte 2*i, gelesen ist er also immer vor dem Überschreiben
+void prepareGraph(void) {
+    const int len = PLOT_X1 - PLOT_X0 + 1;  // Anzahl der Datenpunkte
+    const int h = PLOT_Y1 - PLOT_Y0;        // Höhe des Graphen
+    findMinMax(arena.graph.values, len, &graphMin, &graphMax);
+
+    uint16_t range = (graphMax == graphMin ? 1 : (uint16_t)(graphMax - graphMin));  // Wertebereich (mindestens 1)
+    arena_begin(ARENA_RENDER);
+    for (int i = 0; i < len; i++) {
+        int16_t v = arena.graph.values[i];
+        arena.render.rows[i] = (v == SAMPLE_GAP_VALUE) ? ARENA_ROW_GAP
+                             : PLOT_Y0 + (uint32_t)(uint16_t)(graphMax - v) * h / range;
+    }
+}
+
+// Zeichnet den Graphen aus den Pixelzeilen (prepareGraph)
+// An Lücken (ARENA_ROW_GAP) wird die Linie unterbrochen
+static void drawPlot8(const uint8_t *rows, uint8_t x0, uint8_t x1, uint8_t pg) {
+    int len = x1 - x0 + 1;  // Anzahl der Datenpunkte
+    uint8_t yb = pg * 8;    // Y-Basis der aktuellen Seite
     
-    int16_t range = (mx == mn ? 1 : mx - mn);  // Wertebereich (mindestens 1)
-    int px = x0;  // Start-X-Position
-    int16_t v0 = data[0];  // Erster Wert
-    int py = y0 + (mx - v0) * (uint32_t)h / range;  // Start-Y-Position
-    
-    // Linien zwischen allen Datenpunkten zeichnen
+    // Linien zwischen allen benachbarten gültigen Datenpunkten zeichnen
     for (int i = 1; i < len; i++) {
-        int cx = x0 + i;  // Aktuelle X-Position
-        int16_t v = data[i];  // Aktueller Wert
-        int cy = y0 + (mx - v) * (uint32_t)h / range;  // Aktuelle Y-Position
-        drawLine(px, py, cx, cy, pg);  // Linie zeichnen
-        px = cx; py = cy;  // Position für nächste Linie
+        uint8_t py = rows[i - 1], cy = rows[i];
+        if (py == ARENA_ROW_GAP || cy == ARENA_ROW_GAP) continue;
+        // Linie liegt ganz außerhalb der Seite: überspringen
+        if ((py < yb && cy < yb) || (py >= yb + 8 && cy >= yb + 8)) continue;
+        drawLine(x0 + i - 1, py, x0 + i, cy, pg);  // Linie zeichnen
     }
 }
 
@@ -155,20 +185,17 @@ void drawNumber(int x, int y, int16_t val, uint8_t dp, uint8_t pg) {
         x += FONT_W+1;  // X-Position für nächste Ziffer
     }
     
-    uint16_t ip = dp ? ab/10 : ab;  // Ganzzahl-Teil
-    uint16_t fp = dp ? ab%10 : 0;   // Dezimal-Teil
-    
-    char buf[5]; int bl = 0;  // Puffer für Ziffern
-    
-    // Ganzzahl in String umwandeln (rückwärts)
-    do { 
-        buf[bl++] = '0' + ip%10; 
-        ip /= 10; 
-    } while (ip);
+    char buf[FMT_U16_LEN];
+    uint8_t bl = fmt_u16(ab, buf);  // Ziffern ohne Division (fmt.c)
+    uint8_t il = dp ? bl - 1 : bl;  // Ziffern des Ganzzahl-Teils
     
-    // Ziffern zeichnen (vorwärts, da rückwärts gespeichert)
-    while (bl--) {
-        drawChar(x, y, buf[bl], pg);
+    // Ganzzahl-Teil zeichnen (mindestens eine Ziffer, z.B. 0,5)
+    if (il == 0) {
+        drawChar(x, y, '0', pg);
+        x += FONT_W+1;
+    }
+    for (uint8_t i = 0; i < il; i++) {
+        drawChar(x, y, buf[i], pg);
         x += FONT_W+1;  // X-Position für nächste Ziffer
     }
     
@@ -176,13 +203,13 @@ void drawNumber(int x, int y, int16_t val, uint8_t dp, uint8_t pg) {
     if (dp) {
         drawChar(x, y, ',', pg);  // Komma
         x += FONT_W+1;
-        drawChar(x, y, '0'+fp, pg);  // Dezimalstelle
+        drawChar(x, y, buf[bl-1], pg);  // Dezimalstelle
     }
 }
 
 // Löscht eine Display-Seite und zeichnet den Rahmen
 void clearPage(uint8_t pg) {
-    memset(pageBuf, 0, SCREEN_W);  // Puffer komplett löschen
+    memset(arena.render.page, 0, SCREEN_W);  // Puffer komplett löschen
 
     // Vertikale Linien für die aktuelle Seite zeichnen
     drawLine(0, pg*8, 0, pg*8+7, pg);           // Linke Linie
@@ -206,10 +233,6 @@ void renderScene(uint8_t scene, uint8_t pg) {
     uint8_t idx = scene < 5 ? scene : 0;
     scene = order[idx];
 
-    // RW-Pin für Display-Operation setzen
-    PORTB |=  (1 << RW_PIN);
-    CLR(PORTB, RW_PIN);
-
     // Seiten 1-4: Graphen mit Icons und Beschriftungen
     if (scene < 4) {
         int yMid = (SCREEN_H - 11)/2;  // Y-Mitte für Icon-Position
@@ -241,21 +264,12 @@ void renderScene(uint8_t scene, uint8_t pg) {
             drawLine(x, PLOT_Y1-2, x, PLOT_Y1+2, pg);  // Kurzer Strich
         }
         
-        // Min/Max-Werte für Y-Achse finden
-        int16_t mnv = INT16_MAX, mxv = INT16_MIN;
-        int len = PLOT_X1 - PLOT_X0 + 1;
-        for (int i = 0; i < len; i++) {
-            int16_t v = dataGraph[i];
-            if (v < mnv) mnv = v;
-            if (v > mxv) mxv = v;
-        }
-        
-        // Min/Max-Werte an Y-Achse anzeigen
-        drawNumber(2, PLOT_Y0 - FONT_H + 3, mxv, 1, pg);  // Max-Wert oben
-        drawNumber(2, PLOT_Y1 - FONT_H + 3, mnv, 1, pg);  // Min-Wert unten
+        // Min/Max-Werte an Y-Achse anzeigen (aus prepareGraph)
+        drawNumber(2, PLOT_Y0 - FONT_H + 3, graphMax, 1, pg);  // Max-Wert oben
+        drawNumber(2, PLOT_Y1 - FONT_H + 3, graphMin, 1, pg);  // Min-Wert unten
         
         // Graph zeichnen
-        drawPlot16(dataGraph, PLOT_X0, PLOT_X1, PLOT_Y0, PLOT_Y1, pg);
+        drawPlot8(arena.render.rows, PLOT_X0, PLOT_X1, pg);
         
     } else {
         // Seite 5: Aktuelle Werte (kein Graph)
@@ -270,8 +284,24 @@ void renderScene(uint8_t scene, uint8_t pg) {
         drawBitmap(70, yMid, icoP, pg);  // Druck-Icon
         drawNumber(81, yMid+2, (int16_t)dataP, 1, pg);  // Druck-Wert
         drawString(81 + 7*(FONT_W+1), yMid+2, "HPA", pg);  // hPa-Beschriftung
+        
+        // Feuchte anzeigen (Zeile unter der Temperatur)
+        drawBitmap(1, yMid+16, icoH, pg);  // Feuchte-Icon
+        drawNumber(12, yMid+18, (int16_t)dataH, 1, pg);  // Feuchte-Wert
+        drawString(12 + 5*(FONT_W+1), yMid+18, "%", pg);  // %-Beschriftung
     }
-    
-    // RW-Pin zurücksetzen
-    PORTB &= ~(1 << RW_PIN);
-}
\ No newline at end of file
+}
+
+#if DISPLAY_BENCH
+void bench_drawLine(int x0, int y0, int x1, int y1, uint8_t pg) {
+    drawLine(x0, y0, x1, y1, pg);
+}
+
+void bench_drawChar(int x, int y, char ch, uint8_t pg) {
+    drawChar(x, y, ch, pg);
+}
+
+void bench_drawPlot8(uint8_t pg) {
+    drawPlot8(arena.render.rows, PLOT_X0, PLOT_X1, pg);
+}
+#endif
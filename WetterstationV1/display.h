@@ -49,137 +49,45 @@
 #define CHAR_HEIGHT      8     // Höhe eines Zeichens in Pixeln
 #define CHARS_PER_LINE   21    // Maximale Zeichen pro Zeile (128/6)
 
-// Low-Level Display-Funktionen
-// Diese Funktionen kommunizieren direkt mit dem KS0108-Controller
-
-// Display initialisieren
-// Konfiguriert alle Pins und startet das Display
-void lcd_init(void);
-
-// Display-Chip auswählen (0 = links, 1 = rechts)
-// Wählt die entsprechende Display-Hälfte für Operationen
-void lcd_select_chip(uint8_t chip);
-
-// Kommando an Display senden
-// Sendet ein Steuerkommando an den KS0108-Controller
-void lcd_write_cmd(uint8_t cmd);
-
-// Daten an Display senden
-// Sendet Bilddaten an das Display
-void lcd_write_data(uint8_t data);
-
-// Daten vom Display lesen
-// Liest aktuelle Bilddaten vom Display
-uint8_t lcd_read_data(void);
-
-// Display-Status lesen
-// Prüft ob das Display bereit ist
-uint8_t lcd_read_status(void);
-
-// Warten bis Display bereit ist
-// Wartet bis das Display nicht mehr beschäftigt ist
-void lcd_wait_ready(void);
-
-// Display komplett löschen
-// Setzt alle Pixel auf weiß
-void lcd_clear(void);
-
-// Einzelnen Pixel setzen
-// Setzt einen Pixel an Position (x,y) auf schwarz
-void lcd_set_pixel(uint8_t x, uint8_t y);
-
-// Einzelnen Pixel löschen
-// Setzt einen Pixel an Position (x,y) auf weiß
-void lcd_clear_pixel(uint8_t x, uint8_t y);
-
-// High-Level Display-Funktionen
-// Diese Funktionen bieten einfache Schnittstellen für Anwendungen
-
-// Display initialisieren und konfigurieren
-// Führt alle notwendigen Initialisierungsschritte durch
-void display_init(void);
-
-// Display löschen
-// Löscht das gesamte Display
-void display_clear(void);
-
-// Text an Position ausgeben
-// Zeichnet einen String an der angegebenen Position
-void display_text(uint8_t x, uint8_t y, const char* text);
-
-// Zahl an Position ausgeben
-// Zeichnet eine Zahl an der angegebenen Position
-void display_number(uint8_t x, uint8_t y, int16_t number);
-
-// Temperatur anzeigen
-// Zeichnet Temperatur mit Einheit und Formatierung
-void display_temperature(int16_t temp);
-
-// Druck anzeigen
-// Zeichnet Druck mit Einheit und Formatierung
-void display_pressure(uint16_t pressure);
-
-// Luftfeuchtigkeit anzeigen
-// Zeichnet Luftfeuchtigkeit mit Einheit und Formatierung
-void display_humidity(uint16_t humidity);
-
-// Zeit anzeigen
-// Zeichnet aktuelle Zeit im Format HH:MM
-void display_time(uint8_t hour, uint8_t minute);
-
-// Datum anzeigen
-// Zeichnet aktuelles Datum im Format DD.MM
-void display_date(uint8_t day, uint8_t month);
-
-// Linie zeichnen
-// Zeichnet eine Linie von (x1,y1) nach (x2,y2)
-void display_line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
-
-// Rechteck zeichnen
-// Zeichnet ein Rechteck mit den angegebenen Koordinaten
-void display_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
-
-// Gefülltes Rechteck zeichnen
-// Zeichnet ein gefülltes Rechteck
-void display_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
-
-// Kreis zeichnen
-// Zeichnet einen Kreis mit Mittelpunkt (x,y) und Radius r
-void display_circle(uint8_t x, uint8_t y, uint8_t radius);
-
-// Graph zeichnen
-// Zeichnet einen Liniengraphen mit den angegebenen Daten
-void display_graph(uint8_t x, uint8_t y, uint8_t width, uint8_t height, 
-                   const int16_t* data, uint8_t data_count);
-
-// Temperatur-Graph zeichnen
-// Zeichnet speziell formatierte Temperatur-Daten
-void display_temp_graph(const int16_t* temp_data, uint8_t count);
-
-// Druck-Graph zeichnen
-// Zeichnet speziell formatierte Druck-Daten
-void display_pressure_graph(const uint16_t* pressure_data, uint8_t count);
-
-// Hauptanzeige aktualisieren
-// Zeichnet die komplette Hauptanzeige mit aktuellen Werten
-void display_update_main(int16_t temp, uint16_t pressure, uint16_t humidity);
-
-// Graph-Anzeige aktualisieren
-// Zeichnet die Graph-Anzeige mit historischen Daten
-void display_update_graph(const int16_t* temp_data, const uint16_t* pressure_data, uint8_t count);
-
-// Display-Timeout verwalten
-// Schaltet das Display nach einer bestimmten Zeit aus
-void display_set_timeout(uint16_t seconds);
-uint8_t display_check_timeout(void);
-
-// Display ein-/ausschalten
-// Kontrolliert die Display-Beleuchtung
-void display_on(void);
-void display_off(void);
-
-// Display-Kontrast einstellen
-// Passt den Kontrast des Displays an (falls unterstützt)
-void display_set_contrast(uint8_t contrast);
+// Bildaufbau in display.c: eine Display-Seite (8 Pixelzeilen) nach der anderen
+// im Seitenpuffer arena.render.page, main.c überträgt sie mit ks0108_write_page()
+#define SCREEN_W         DISPLAY_WIDTH
+#define SCREEN_H         DISPLAY_HEIGHT
+#define FONT_W           3     // Breite eines Zeichens der kleinen Schrift (Pixel)
+#define FONT_H           5     // Höhe eines Zeichens der kleinen Schrift (Pixel)
+#define PLOT_X0          30    // Linke Achse des Graphen
+#define PLOT_X1          125   // Letzte Spalte des Graphen (ein Datenpunkt je Spalte: PLOT_X0 + DISPLAY_COUNT - 1)
+#define PLOT_Y0          6     // Oberkante des Graphen
+#define PLOT_Y1          56    // Untere Achse des Graphen
+
+// Aktuelle Messwerte für Seite 5 (main.c, 0.1°C, 0.1 hPa, 0.1%)
+extern int16_t  dataT;
+extern uint16_t dataP;
+extern uint16_t dataH;
+
+// Seitenpuffer löschen und den Rahmen der Display-Seite pg zeichnen
+void clearPage(uint8_t pg);
+
+// Szene (0-4 = Anzeigeseite 1-5) in den Seitenpuffer der Display-Seite pg zeichnen
+void renderScene(uint8_t scene, uint8_t pg);
+
+// Zahl mit dp Nachkommastellen (0 oder 1) an (x, y) zeichnen
+void drawNumber(int x, int y, int16_t val, uint8_t dp, uint8_t pg);
+
+// Geladenen Verlauf (arena.graph.values) einmal je Bild in Pixelzeilen umrechnen
+// Danach gilt ARENA_RENDER: renderScene() zeichnet aus arena.render.rows
+void prepareGraph(void);
+
+// Zeichenfunktionen für den Benchmark freigeben (bench/bench.c, -DDISPLAY_BENCH=1)
+#ifndef DISPLAY_BENCH
+#define DISPLAY_BENCH 0
+#endif
+
+#if DISPLAY_BENCH
+// Einstiegspunkte in die sonst statischen Zeichenfunktionen
+void bench_drawLine(int x0, int y0, int x1, int y1, uint8_t pg);
+void bench_drawChar(int x, int y, char ch, uint8_t pg);
+void bench_drawPlot8(uint8_t pg);  // Verlauf aus prepareGraph() in die Seite pg
+#endif
 
 #endif /* DISPLAY_H_ */
@@ -0,0 +1,122 @@
+/*
+ * filter.c
+ *
+ * Messwert-Filterstufe (Median-of-3 und IIR-Tiefpass)
+ * Reine Ganzzahl-Arithmetik, RAM-Bedarf: 18 Bytes Median-Historie
+ * plus 12 Bytes IIR-Zustand. Die Laufzeit jeder Filterung wird mit
+ * Timer0 gemessen und in den Statistiken festgehalten.
+ *
+ * Created: 18.10.2026 11:05:27
+ *  Author: morri
+ */
+
+#include "hal.h"
+#include "filter.h"
+#include "ram.h"
+
+#if SAMPLE_FILTER & FILTER_MEDIAN
+static int16_t hist[FILTER_CHANNELS][3];  // Letzte 3 Werte je Kanal
+static uint8_t hist_pos;                  // Nächste Schreibposition (0-2)
+static uint8_t hist_count;                // Anzahl gültiger Vorgänger (0-2)
+#endif
+
+#if SAMPLE_FILTER & FILTER_IIR
+static int32_t iir[FILTER_CHANNELS];      // IIR-Zustand mit FILTER_FRAC_BITS Nachkommabits
+static uint8_t iir_valid;                 // 1 = Zustand enthält einen Wert
+#endif
+
+static filter_stats_t stats;
+
+#if (SAMPLE_FILTER & FILTER_MEDIAN) && (SAMPLE_FILTER & FILTER_IIR)
+RAM_ACCOUNT(filter, sizeof(hist) + sizeof(hist_pos) + sizeof(hist_count)
+                    + sizeof(iir) + sizeof(iir_valid) + sizeof(stats));
+#elif SAMPLE_FILTER & FILTER_MEDIAN
+RAM_ACCOUNT(filter, sizeof(hist) + sizeof(hist_pos) + sizeof(hist_count) + sizeof(stats));
+#elif SAMPLE_FILTER & FILTER_IIR
+RAM_ACCOUNT(filter, sizeof(iir) + sizeof(iir_valid) + sizeof(stats));
+#else
+RAM_ACCOUNT(filter, sizeof(stats));
+#endif
+
+// Median von drei Werten (drei Vergleiche, keine Sortierung)
+#if SAMPLE_FILTER & FILTER_MEDIAN
+static int16_t median3(int16_t a, int16_t b, int16_t c) {
+	if (a > b) { int16_t t = a; a = b; b = t; }  // a <= b
+	if (b > c) b = c;                            // b = min(b, c)
+	return (a > b) ? a : b;                      // max(a, min(b, c))
+}
+#endif
+
+// Einen Kanal filtern
+static int16_t filter_channel(uint8_t ch, int16_t x) {
+#if SAMPLE_FILTER & FILTER_MEDIAN
+	// Median der letzten 3 Werte (solange weniger vorliegen: Wert unverändert)
+	// hist_count zählt die Vorgänger, der aktuelle Wert ist der dritte
+	hist[ch][hist_pos] = x;
+	if (hist_count >= 2) {
+		x = median3(hist[ch][0], hist[ch][1], hist[ch][2]);
+	}
+#endif
+
+#if SAMPLE_FILTER & FILTER_IIR
+	// IIR: y += (x - y) >> k, im Festkomma mit FILTER_FRAC_BITS Nachkommabits
+	int32_t xs = (int32_t)x << FILTER_FRAC_BITS;
+	if (!iir_valid) {
+		iir[ch] = xs;  // Erster Wert startet den Filter
+	} else {
+		iir[ch] += (xs - iir[ch]) >> FILTER_IIR_SHIFT;
+	}
+	// Zurück auf ganze Einheiten (mit Rundung)
+	x = (int16_t)((iir[ch] + (1 << (FILTER_FRAC_BITS - 1))) >> FILTER_FRAC_BITS);
+#else
+	(void)ch;
+#endif
+
+	return x;
+}
+
+// Filter initialisieren
+void filter_init(void) {
+	hal_cycles_init();  // Timer0 freilaufend mit Takt/8 (nur für die Laufzeitmessung)
+}
+
+// Eine Messung filtern
+void filter_apply(int16_t* temp, uint16_t* press, uint16_t* hum) {
+	uint8_t t0 = hal_cycles();  // Startzeitpunkt
+
+	// Druck (max. ca. 11000) und Feuchte (max. 1000) passen in int16_t
+	*temp  = filter_channel(0, *temp);
+	*press = (uint16_t)filter_channel(1, (int16_t)*press);
+	*hum   = (uint16_t)filter_channel(2, (int16_t)*hum);
+
+#if SAMPLE_FILTER & FILTER_MEDIAN
+	hist_pos = (hist_pos + 1) % 3;     // Ringpuffer weiterschalten
+	if (hist_count < 2) hist_count++;
+#endif
+#if SAMPLE_FILTER & FILTER_IIR
+	iir_valid = 1;
+#endif
+
+	// Laufzeit in CPU-Takten (8-Bit-Differenz reicht bis 2040 Takte)
+	uint16_t cycles = (uint8_t)(hal_cycles() - t0) * 8U;
+	stats.cycles_last = cycles;
+	if (cycles > stats.cycles_max) stats.cycles_max = cycles;
+	stats.samples++;
+}
+
+// Filterzustand verwerfen
+void filter_reset(void) {
+#if SAMPLE_FILTER & FILTER_MEDIAN
+	hist_pos   = 0;
+	hist_count = 0;
+#endif
+#if SAMPLE_FILTER & FILTER_IIR
+	iir_valid  = 0;
+#endif
+	stats.resets++;
+}
+
+// Filter-Statistiken abrufen
+void filter_get_stats(filter_stats_t* out) {
+	*out = stats;
+}
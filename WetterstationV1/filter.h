@@ -0,0 +1,62 @@
+/*
+ * filter.h
+ *
+ * Header-Datei für die Messwert-Filterstufe
+ * Glättet die Messwerte zwischen Sensor-Abfrage und EEPROM-Speicherung,
+ * damit einzelne Ausreißer nicht in die Historie und die Graphen-Skalierung gelangen
+ *
+ * Created: 18.10.2026 11:05:27
+ *  Author: morri
+ */
+
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdint.h>
+
+// Filter-Varianten
+#define FILTER_OFF         0  // Werte unverändert übernehmen
+#define FILTER_MEDIAN      1  // Median der letzten 3 Werte (entfernt einzelne Ausreißer)
+#define FILTER_IIR         2  // IIR-Tiefpass erster Ordnung
+#define FILTER_MEDIAN_IIR  3  // Erst Median, dann IIR
+
+// Gewählte Filter-Variante (zur Compile-Zeit, z.B. -DSAMPLE_FILTER=0)
+#ifndef SAMPLE_FILTER
+#define SAMPLE_FILTER      FILTER_MEDIAN_IIR
+#endif
+
+// IIR-Koeffizient als Zweierpotenz: y += (x - y) / 2^FILTER_IIR_SHIFT
+// 2 = neuer Wert geht mit 1/4 ein (Zeitkonstante ca. 4 Messungen)
+#define FILTER_IIR_SHIFT   2
+
+// Nachkommabits des IIR-Zustands (Festkomma, vermeidet Rundungsdrift)
+#define FILTER_FRAC_BITS   4
+
+// Anzahl gefilterter Kanäle (Temperatur, Druck, Feuchte)
+#define FILTER_CHANNELS    3
+
+// Filter-Statistiken
+// Die Laufzeit wird mit Timer0 (Takt/8) gemessen, Auflösung 8 CPU-Takte
+typedef struct {
+	uint16_t samples;     // Anzahl gefilterter Messungen
+	uint16_t resets;      // Anzahl Neustarts nach einer Messlücke
+	uint16_t cycles_last; // CPU-Takte der letzten Filterung
+	uint16_t cycles_max;  // Maximale CPU-Takte einer Filterung
+} filter_stats_t;
+
+// Filter initialisieren
+// Startet Timer0 als freilaufenden Zähler für die Laufzeitmessung
+void filter_init(void);
+
+// Eine Messung filtern (Werte werden in-place ersetzt)
+// Temperatur in 0.1°C, Druck in 0.1 hPa, Feuchte in 0.1%
+void filter_apply(int16_t* temp, uint16_t* press, uint16_t* hum);
+
+// Filterzustand verwerfen (nach einer Messlücke)
+// Die nächste Messung wird ungefiltert übernommen und startet den Filter neu
+void filter_reset(void);
+
+// Filter-Statistiken abrufen
+void filter_get_stats(filter_stats_t* stats);
+
+#endif /* FILTER_H_ */
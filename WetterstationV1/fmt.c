@@ -0,0 +1,118 @@
+/*
+ * fmt.c
+ *
+ * Zahlenformatierung ohne Division
+ * Für jede Zehnerpotenz (größte zuerst) wird gezählt, wie oft sie sich
+ * abziehen lässt. Führende Nullen werden übersprungen, die Einerstelle
+ * bleibt als Rest übrig. Die Tabellen liegen im Flash.
+ *
+ * Created: 18.10.2026 16:48:15
+ *  Author: morri
+ */
+
+#include <avr/pgmspace.h>
+#include "fmt.h"
+
+static const uint16_t pow10_16[] PROGMEM = { 10000, 1000, 100, 10 };
+static const uint32_t pow10_32[] PROGMEM = {
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL, 1000UL, 100UL, 10UL
+};
+
+// 16 Bit vorzeichenlos
+uint8_t fmt_u16(uint16_t value, char* out) {
+	uint8_t n = 0;
+	for (uint8_t i = 0; i < sizeof(pow10_16) / sizeof(pow10_16[0]); i++) {
+		uint16_t p = pgm_read_word(&pow10_16[i]);
+		char d = '0';
+		while (value >= p) {  // Höchstens 9 Durchläufe (6 bei 10000)
+			value -= p;
+			d++;
+		}
+		if (n || d != '0') out[n++] = d;  // Führende Nullen weglassen
+	}
+	out[n++] = '0' + value;  // Einerstelle (auch die einzelne 0)
+	out[n] = '\0';
+	return n;
+}
+
+// 16 Bit mit Vorzeichen
+uint8_t fmt_i16(int16_t value, char* out) {
+	if (value >= 0) return fmt_u16(value, out);
+	*out = '-';
+	return 1 + fmt_u16(-(int32_t)value, out + 1);  // -32768 passt in uint16_t
+}
+
+// 32 Bit vorzeichenlos
+uint8_t fmt_u32(uint32_t value, char* out) {
+	if (value <= 0xFFFF) return fmt_u16(value, out);  // Häufiger Fall: 16-Bit-Arithmetik genügt
+	uint8_t n = 0;
+	for (uint8_t i = 0; i < sizeof(pow10_32) / sizeof(pow10_32[0]); i++) {
+		uint32_t p = pgm_read_dword(&pow10_32[i]);
+		char d = '0';
+		while (value >= p) {
+			value -= p;
+			d++;
+		}
+		if (n || d != '0') out[n++] = d;
+	}
+	out[n++] = '0' + (uint8_t)value;
+	out[n] = '\0';
+	return n;
+}
+
+// 32 Bit mit Vorzeichen
+uint8_t fmt_i32(int32_t value, char* out) {
+	if (value >= 0) return fmt_u32(value, out);
+	*out = '-';
+	return 1 + fmt_u32(-(uint32_t)value, out + 1);  // Auch INT32_MIN
+}
+
+#if FMT_BENCHMARK
+#include "hal.h"
+
+// Bisheriges Verfahren (Ziffern rückwärts mit / 10 und % 10) als Vergleich
+static uint8_t fmt_i16_div(int16_t value, char* out) {
+	char buf[5];
+	uint8_t n = 0, bl = 0;
+	uint16_t u = value < 0 ? -(int32_t)value : value;
+	if (value < 0) out[n++] = '-';
+	do {
+		buf[bl++] = '0' + u % 10;
+		u /= 10;
+	} while (u);
+	while (bl) out[n++] = buf[--bl];
+	out[n] = '\0';
+	return n;
+}
+
+// Benchmark ausführen: 96 Werte wie ein Druckverlauf (5 Ziffern) plus Randwerte
+void fmt_benchmark(fmt_bench_t* out) {
+	char a[FMT_I16_LEN], b[FMT_I16_LEN];
+	out->cycles_fmt = 0;
+	out->cycles_div = 0;
+	out->mismatches = 0;
+	for (uint8_t i = 0; i < 96 + 4; i++) {
+		int16_t v;
+		switch (i) {
+		case 96:  v = 0;      break;
+		case 97:  v = -1;     break;
+		case 98:  v = 32767;  break;
+		case 99:  v = -32768; break;
+		default:  v = 10013 + (int16_t)i * 3 - 150;  // 0.1 hPa
+		}
+
+		// Laufzeit je Aufruf in CPU-Takten (8-Bit-Differenz von Timer0 reicht bis 2040 Takte)
+		uint8_t t0 = hal_cycles();
+		fmt_i16(v, a);
+		out->cycles_fmt += (uint8_t)(hal_cycles() - t0) * 8U;
+		t0 = hal_cycles();
+		fmt_i16_div(v, b);
+		out->cycles_div += (uint8_t)(hal_cycles() - t0) * 8U;
+
+		for (uint8_t k = 0; k < FMT_I16_LEN; k++) {
+			if (a[k] != b[k]) { out->mismatches++; break; }
+			if (!a[k]) break;
+		}
+	}
+}
+#endif
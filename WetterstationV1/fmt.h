@@ -0,0 +1,50 @@
+/*
+ * fmt.h
+ *
+ * Header-Datei für die Zahlenformatierung (Dezimal, ohne Division)
+ * Der ATmega8 hat keinen Dividierer: jede / 10 und % 10 ist eine
+ * Software-Routine mit über 200 Takten. Die Ziffern entstehen hier durch
+ * Abziehen von Zehnerpotenzen (höchstens 9 Subtraktionen je Ziffer).
+ * Gemeinsam genutzt von rs232, uart, display und mini_snprintf.
+ *
+ * Created: 18.10.2026 16:48:15
+ *  Author: morri
+ */
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include <stdint.h>
+
+// Puffergrößen inklusive Vorzeichen und Null-Terminator
+#define FMT_U16_LEN   6     // "65535"
+#define FMT_I16_LEN   7     // "-32768"
+#define FMT_U32_LEN   11    // "4294967295"
+#define FMT_I32_LEN   12    // "-2147483648"
+
+// Benchmark und Vergleich mit der Division (zur Compile-Zeit, z.B. -DFMT_BENCHMARK=1)
+// Gibt beim Start eine Textzeile f:Takte neu;Takte Division;Abweichungen; aus
+#ifndef FMT_BENCHMARK
+#define FMT_BENCHMARK 0
+#endif
+
+// Zahl als Dezimaltext schreiben (mit Null-Terminator)
+// Rückgabe: Anzahl Zeichen ohne Null-Terminator
+uint8_t fmt_u16(uint16_t value, char* out);
+uint8_t fmt_i16(int16_t value, char* out);
+uint8_t fmt_u32(uint32_t value, char* out);
+uint8_t fmt_i32(int32_t value, char* out);
+
+#if FMT_BENCHMARK
+// Ergebnis des Benchmarks (96 Werte wie ein Verlauf, Timer0 mit Takt/8)
+typedef struct {
+	uint16_t cycles_fmt;   // Takte für alle Werte mit fmt_i16
+	uint16_t cycles_div;   // Takte für alle Werte mit / 10 und % 10
+	uint16_t mismatches;   // Werte mit unterschiedlicher Ausgabe
+} fmt_bench_t;
+
+// Benchmark ausführen (Timer0 muss laufen, siehe filter_init)
+void fmt_benchmark(fmt_bench_t* out);
+#endif
+
+#endif /* FMT_H_ */
@@ -0,0 +1,384 @@
+/*
+ * hal.h
+ *
+ * Hardware-Abstraktion: SPI, TWI, UART, GPIO und Timer
+ * Die Treiber (EEPROM.c, twimaster.c, rs232.c, ks0108.c, button.c,
+ * timebase.c, sched.c, filter.c) greifen nur über diese Funktionen auf
+ * Register und Pins zu. Für den ATmega8 sind es static inline-Funktionen,
+ * die zu denselben Registerzugriffen wie vorher übersetzen.
+ *
+ * Mit HAL_HOST (Host-Build, host/) sind es gewöhnliche Funktionen der
+ * Simulation: dort werden EEPROM, BME280, KS0108 und die serielle Leitung
+ * nachgebildet, die Zeit läuft virtuell (host/sim.h). Interrupt-Routinen
+ * bleiben ISR(...), der Host-Build ruft sie über ihren Vektornamen auf.
+ *
+ * Die Pin-Belegung steht nur hier.
+ *
+ * Created: 18.10.2026 21:48:25
+ *  Author: morri
+ */
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#ifdef HAL_HOST
+#define HAL_API
+#else
+#include <avr/sleep.h>
+#include <compat/twi.h>
+#include <util/delay.h>
+#define HAL_API static inline
+#endif
+
+// --- Pin-Belegung (ATmega8) ---
+
+// SPI zum EEPROM (Port B)
+// CS, MISO und SCK sind zugleich DI, RW und E des Displays: der SPI ist nur
+// zwischen hal_eeprom_select() und hal_eeprom_deselect() eingeschaltet
+#define HAL_SPI_CS         PB2     // Chip Select des EEPROMs (Low-Aktiv)
+#define HAL_SPI_MOSI       PB3
+#define HAL_SPI_MISO       PB4     // Wird außerhalb der EEPROM-Zugriffe zum Ausgang (Display)
+#define HAL_SPI_SCK        PB5
+
+// KS0108: Chip Select und Reset (Port C), Datenbus D0-D1 auf Port B, D2-D7 auf Port D
+// Jedes Datenbit liegt auf dem Portbit mit derselben Nummer
+#define HAL_LCD_CS1        PC1     // Linke Hälfte (Low-Aktiv)
+#define HAL_LCD_CS2        PC0     // Rechte Hälfte (Low-Aktiv)
+#define HAL_LCD_RST        PC2     // Reset (Low-Aktiv)
+#define HAL_LCD_DATA_B     ((1 << PB0) | (1 << PB1))
+#define HAL_LCD_DATA_D     ((1 << PD2) | (1 << PD3) | (1 << PD4) | (1 << PD5) | (1 << PD6) | (1 << PD7))
+#define HAL_LCD_DI         PB2     // Data/Instruction (= CS des EEPROMs)
+#define HAL_LCD_RW         PB4     // Read/Write (= MISO)
+#define HAL_LCD_E          PB5     // Enable (= SCK)
+
+// I2C-Leitungen (Port C), per GPIO nur für die Bus-Recovery
+#define HAL_I2C_SDA        (1 << PC4)
+#define HAL_I2C_SCL        (1 << PC5)
+
+// Taster (Port C, Low-Aktiv mit Pull-up)
+#define HAL_BUTTON         PC3
+
+// Auswahl der Display-Hälften (hal_lcd_select)
+#define HAL_LCD_LEFT       0x01
+#define HAL_LCD_RIGHT      0x02
+
+// Registerauswahl des KS0108 (hal_lcd_write, hal_lcd_read)
+#define HAL_LCD_INSTR      0       // Kommando bzw. Status
+#define HAL_LCD_DATA       1       // Bilddaten
+
+// --- SPI (EEPROM) ---
+
+// SPI als Master einrichten (Takt/16), eingeschaltet wird er erst mit hal_eeprom_select()
+HAL_API void hal_spi_init(void);
+// Ein Byte senden und gleichzeitig eines empfangen
+HAL_API uint8_t hal_spi_xfer(uint8_t data);
+// EEPROM auswählen: CS Low, MISO als Eingang, Display-Hälften abwählen, SPI ein
+HAL_API void hal_eeprom_select(void);
+// EEPROM freigeben: CS High, SPI aus, MISO wieder als Ausgang, Display-Hälften wählen
+HAL_API void hal_eeprom_deselect(void);
+
+// --- TWI (I2C-Master, Ablauf in twimaster.c) ---
+
+// Bitrate setzen (TWBR, Prescaler 1)
+HAL_API void hal_twi_init(uint8_t bitrate);
+// TWCR schreiben (startet START, Byte, STOP je nach Bits) bzw. lesen
+HAL_API void hal_twi_control(uint8_t twcr);
+HAL_API uint8_t hal_twi_flags(void);
+// Status der letzten Busoperation (TW_*, Prescaler-Bits maskiert)
+HAL_API uint8_t hal_twi_status(void);
+// Datenregister (Adresse bzw. Byte senden, empfangenes Byte)
+HAL_API void hal_twi_put(uint8_t data);
+HAL_API uint8_t hal_twi_get(void);
+// Leitungen per GPIO: low = Maske der Leitungen, die auf Low gezogen werden (Open-Drain)
+HAL_API void hal_i2c_pull(uint8_t low);
+// Maske der Leitungen, die gerade High sind
+HAL_API uint8_t hal_i2c_lines(void);
+
+// --- UART (ESP8266) ---
+
+// 8N1, Sender, Empfänger und Empfangs-Interrupt einschalten
+HAL_API void hal_uart_init(uint8_t ubrr);
+// Baudrate umschalten (u2x = doppelte Geschwindigkeit)
+HAL_API void hal_uart_baud(uint8_t ubrr, uint8_t u2x);
+// Byte senden (UDR muss frei sein), TXC wird dabei gelöscht
+HAL_API void hal_uart_put(uint8_t data);
+// Empfangenes Byte (nach hal_uart_rx_error() lesen)
+HAL_API uint8_t hal_uart_get(void);
+// Overrun- oder Rahmenfehler des Bytes in UDR
+HAL_API uint8_t hal_uart_rx_error(void);
+// Interrupt "UDR frei" (USART_UDRE_vect) ein-/ausschalten
+HAL_API void hal_uart_udre_irq(uint8_t on);
+// UDR frei, Schieberegister leer (TXC), Byte empfangen (RXC)
+HAL_API uint8_t hal_uart_tx_free(void);
+HAL_API uint8_t hal_uart_tx_done(void);
+HAL_API uint8_t hal_uart_rx_ready(void);
+
+// --- GPIO: KS0108 ---
+
+// Pins als Ausgänge, Reset inaktiv
+HAL_API void hal_lcd_init(void);
+// Reset-Leitung (1 = Reset aktiv)
+HAL_API void hal_lcd_reset(uint8_t active);
+// Display-Hälften wählen (HAL_LCD_LEFT | HAL_LCD_RIGHT)
+HAL_API void hal_lcd_select(uint8_t halves);
+// Ein Byte schreiben bzw. lesen (rs = HAL_LCD_INSTR oder HAL_LCD_DATA), mit Enable-Puls
+HAL_API void hal_lcd_write(uint8_t rs, uint8_t data);
+HAL_API uint8_t hal_lcd_read(uint8_t rs);
+
+// --- GPIO: Taster ---
+
+// Eingang mit Pull-up
+HAL_API void hal_button_init(void);
+// Pegel (0 = gedrückt)
+HAL_API uint8_t hal_button_level(void);
+
+// --- Timer ---
+
+// Timer1: CTC mit Prescaler 1024, Compare-Interrupt (TIMER1_COMPA_vect) nach top + 1 Schritten
+HAL_API void hal_tick_init(uint8_t top);
+// Stand von Timer1 im laufenden Tick
+HAL_API uint8_t hal_tick_count(void);
+// Compare-Match passiert, Interrupt noch nicht gelaufen (OCF1A)
+HAL_API uint8_t hal_tick_pending(void);
+
+// Timer0 freilaufend mit Takt/8 (Laufzeitmessung, ein Schritt = 8 CPU-Takte)
+HAL_API void hal_cycles_init(void);
+HAL_API uint8_t hal_cycles(void);
+
+// Timer2 freilaufend mit Takt/8, Überlauf-Interrupt (TIMER2_OVF_vect) alle 256 Schritte
+HAL_API void hal_timer2_init(void);
+// Stand von Timer2
+HAL_API uint8_t hal_timer2_count(void);
+// Überlauf passiert, Interrupt noch nicht gelaufen (TOV2)
+HAL_API uint8_t hal_timer2_pending(void);
+
+// Idle-Schlaf einrichten (Timer und UART laufen weiter)
+HAL_API void hal_sleep_init(void);
+// Mit gesperrten Interrupts aufrufen: Interrupts freigeben und bis zum nächsten schlafen
+HAL_API void hal_sleep(void);
+
+// Reset-Ursache (MCUCSR) lesen und löschen
+HAL_API uint8_t hal_reset_cause(void);
+
+#ifndef HAL_HOST
+
+// --- Umsetzung für den ATmega8 ---
+
+HAL_API void hal_spi_init(void) {
+	DDRB |= (1 << HAL_SPI_MOSI) | (1 << HAL_SPI_SCK) | (1 << HAL_SPI_CS);
+	DDRB &= ~(1 << HAL_SPI_MISO);
+	PORTB |= (1 << HAL_SPI_CS);         // EEPROM abgewählt
+	SPCR = (1 << MSTR) | (1 << SPR0);   // Master, Takt/16 (SPE setzt hal_eeprom_select)
+}
+
+HAL_API uint8_t hal_spi_xfer(uint8_t data) {
+	SPDR = data;
+	while (!(SPSR & (1 << SPIF)));  // Warten bis das Byte durch ist
+	return SPDR;
+}
+
+HAL_API void hal_eeprom_select(void) {
+	PORTB &= ~(1 << HAL_SPI_CS);
+	DDRB  &= ~(1 << HAL_SPI_MISO);
+	PORTC |= (1 << HAL_LCD_CS1) | (1 << HAL_LCD_CS2);  // Display hört nicht auf E
+	SPCR  |= (1 << SPE);                // SPI übernimmt SCK und MISO
+}
+
+HAL_API void hal_eeprom_deselect(void) {
+	PORTB |=  (1 << HAL_SPI_CS);
+	SPCR  &= ~(1 << SPE);               // SCK und MISO wieder als E und RW
+	PORTB &= ~(1 << HAL_SPI_MISO);
+	DDRB  |=  (1 << HAL_SPI_MISO);
+	PORTC &= ~((1 << HAL_LCD_CS1) | (1 << HAL_LCD_CS2));
+}
+
+HAL_API void hal_twi_init(uint8_t bitrate) {
+	TWSR = 0;  // Prescaler 1
+	TWBR = bitrate;
+}
+
+HAL_API void hal_twi_control(uint8_t twcr) {
+	TWCR = twcr;
+}
+
+HAL_API uint8_t hal_twi_flags(void) {
+	return TWCR;
+}
+
+HAL_API uint8_t hal_twi_status(void) {
+	return TW_STATUS;
+}
+
+HAL_API void hal_twi_put(uint8_t data) {
+	TWDR = data;
+}
+
+HAL_API uint8_t hal_twi_get(void) {
+	return TWDR;
+}
+
+HAL_API void hal_i2c_pull(uint8_t low) {
+	PORTC &= ~(HAL_I2C_SDA | HAL_I2C_SCL);
+	DDRC   = (DDRC & ~(HAL_I2C_SDA | HAL_I2C_SCL)) | low;
+}
+
+HAL_API uint8_t hal_i2c_lines(void) {
+	return PINC & (HAL_I2C_SDA | HAL_I2C_SCL);
+}
+
+HAL_API void hal_uart_init(uint8_t ubrr) {
+	UBRRH = 0;
+	UBRRL = ubrr;
+	UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0);   // 8 Datenbits, 1 Stoppbit
+	UCSRB = (1 << RXEN) | (1 << TXEN) | (1 << RXCIE);
+}
+
+HAL_API void hal_uart_baud(uint8_t ubrr, uint8_t u2x) {
+	if (u2x) UCSRA |=  (1 << U2X);
+	else     UCSRA &= ~(1 << U2X);
+	UBRRL = ubrr;
+}
+
+HAL_API void hal_uart_put(uint8_t data) {
+	UCSRA |= (1 << TXC);  // TXC löschen (Schreiben einer 1), wird nach diesem Byte wieder gesetzt
+	UDR = data;
+}
+
+HAL_API uint8_t hal_uart_get(void) {
+	return UDR;
+}
+
+HAL_API uint8_t hal_uart_rx_error(void) {
+	return UCSRA & ((1 << DOR) | (1 << FE));
+}
+
+HAL_API void hal_uart_udre_irq(uint8_t on) {
+	if (on) UCSRB |=  (1 << UDRIE);
+	else    UCSRB &= ~(1 << UDRIE);
+}
+
+HAL_API uint8_t hal_uart_tx_free(void) {
+	return UCSRA & (1 << UDRE);
+}
+
+HAL_API uint8_t hal_uart_tx_done(void) {
+	return UCSRA & (1 << TXC);
+}
+
+HAL_API uint8_t hal_uart_rx_ready(void) {
+	return UCSRA & (1 << RXC);
+}
+
+HAL_API void hal_lcd_init(void) {
+	DDRC |= (1 << HAL_LCD_CS1) | (1 << HAL_LCD_CS2) | (1 << HAL_LCD_RST);
+	DDRB |= HAL_LCD_DATA_B | (1 << HAL_LCD_DI) | (1 << HAL_LCD_RW) | (1 << HAL_LCD_E);
+	DDRD |= HAL_LCD_DATA_D;
+	PORTC |= (1 << HAL_LCD_RST);
+}
+
+HAL_API void hal_lcd_reset(uint8_t active) {
+	if (active) PORTC &= ~(1 << HAL_LCD_RST);
+	else        PORTC |=  (1 << HAL_LCD_RST);
+}
+
+HAL_API void hal_lcd_select(uint8_t halves) {
+	uint8_t cs = PORTC | (1 << HAL_LCD_CS1) | (1 << HAL_LCD_CS2);
+	if (halves & HAL_LCD_LEFT)  cs &= ~(1 << HAL_LCD_CS1);
+	if (halves & HAL_LCD_RIGHT) cs &= ~(1 << HAL_LCD_CS2);
+	PORTC = cs;
+}
+
+HAL_API void hal_lcd_write(uint8_t rs, uint8_t data) {
+	DDRB |= HAL_LCD_DATA_B;                  // Datenbus als Ausgang
+	DDRD |= HAL_LCD_DATA_D;
+	PORTB &= ~(1 << HAL_LCD_RW);             // Schreiben
+	if (rs) PORTB |=  (1 << HAL_LCD_DI);
+	else    PORTB &= ~(1 << HAL_LCD_DI);
+	PORTB = (PORTB & ~HAL_LCD_DATA_B) | (data & HAL_LCD_DATA_B);
+	PORTD = (PORTD & ~HAL_LCD_DATA_D) | (data & HAL_LCD_DATA_D);
+	PORTB |= (1 << HAL_LCD_E);               // Enable-Puls
+	_delay_us(1);
+	PORTB &= ~(1 << HAL_LCD_E);
+}
+
+HAL_API uint8_t hal_lcd_read(uint8_t rs) {
+	DDRB &= ~HAL_LCD_DATA_B;                 // Datenbus als Eingang
+	DDRD &= ~HAL_LCD_DATA_D;
+	PORTB |= (1 << HAL_LCD_RW);              // Lesen
+	if (rs) PORTB |=  (1 << HAL_LCD_DI);
+	else    PORTB &= ~(1 << HAL_LCD_DI);
+	PORTB |= (1 << HAL_LCD_E);               // Enable-Puls
+	_delay_us(1);
+	PORTB &= ~(1 << HAL_LCD_E);
+	return (PINB & HAL_LCD_DATA_B) | (PIND & HAL_LCD_DATA_D);
+}
+
+HAL_API void hal_button_init(void) {
+	DDRC  &= ~(1 << HAL_BUTTON);
+	PORTC |=  (1 << HAL_BUTTON);
+}
+
+HAL_API uint8_t hal_button_level(void) {
+	return (PINC & (1 << HAL_BUTTON)) ? 1 : 0;
+}
+
+HAL_API void hal_tick_init(uint8_t top) {
+	TCCR1B |= (1 << WGM12);               // CTC-Modus (Clear Timer on Compare Match)
+	TCCR1B |= (1 << CS12) | (1 << CS10);  // Prescaler 1024
+	OCR1A   = top;
+	TIMSK  |= (1 << OCIE1A);
+}
+
+HAL_API uint8_t hal_tick_count(void) {
+	return TCNT1;
+}
+
+HAL_API uint8_t hal_tick_pending(void) {
+	return (TIFR & (1 << OCF1A)) != 0;
+}
+
+HAL_API void hal_cycles_init(void) {
+	TCCR0 = (1 << CS01);
+}
+
+HAL_API uint8_t hal_cycles(void) {
+	return TCNT0;
+}
+
+HAL_API void hal_timer2_init(void) {
+	TCCR2  = (1 << CS21);   // Normalmodus, Prescaler 8
+	TIMSK |= (1 << TOIE2);  // Überlauf-Interrupt
+}
+
+HAL_API uint8_t hal_timer2_count(void) {
+	return TCNT2;
+}
+
+HAL_API uint8_t hal_timer2_pending(void) {
+	return (TIFR & (1 << TOV2)) != 0;
+}
+
+HAL_API void hal_sleep_init(void) {
+	set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+HAL_API void hal_sleep(void) {
+	sleep_enable();
+	sei();
+	sleep_cpu();
+	sleep_disable();
+}
+
+HAL_API uint8_t hal_reset_cause(void) {
+	uint8_t cause = MCUCSR;
+	MCUCSR = 0;
+	return cause;
+}
+
+#endif /* !HAL_HOST */
+
+#endif /* HAL_H_ */
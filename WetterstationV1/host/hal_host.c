@@ -0,0 +1,400 @@
+/*
+ * hal_host.c
+ *
+ * hal.h für den Host-Build: virtuelle Zeit, Timer, UART, SPI, TWI und GPIO
+ * Die Register des ATmega8 gibt es nicht, nachgebildet wird nur, was die
+ * Treiber über das HAL sehen: Flags, Zählerstände und die Dauer der
+ * Übertragungen. Die Bausteine dahinter stehen in den sim_*.c.
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#include <stdlib.h>
+#include <avr/io.h>
+#include <compat/twi.h>
+#include "hal.h"
+#include "sim.h"
+
+volatile uint8_t SREG;
+
+#define I_SET()            (SREG & (1 << SREG_I))
+
+// Dauer der Busvorgänge
+#define SPI_BYTE_NS        (8ULL * 16 * SIM_NS_PER_S / F_CPU)   // Takt/16: ca. 35 us
+#define TWI_BYTE_NS        90000ULL                             // 9 Takte bei 100 kHz
+#define TWI_COND_NS        10000ULL                             // START bzw. STOP
+
+static uint64_t now_ns;
+static uint64_t end_ns = UINT64_MAX;
+static void (*end_fn)(void);
+static sim_stats_t stats;
+
+// Timer1
+static uint8_t  tick_on;
+static uint64_t tick_ns;        // Dauer eines Ticks
+static uint64_t tick_epoch;     // Start des Timers
+static uint64_t tick_next;      // Nächster Compare-Match (OCF1A ab diesem Zeitpunkt)
+
+// Timer2 (Laufzeitmessung, nur mit PROFILE_ENABLE eingeschaltet)
+#define T2_OVF_NS          (256ULL * 8 * SIM_NS_PER_S / F_CPU)  // 2048 Takte: ca. 556 us
+static uint8_t  t2_on;
+static uint64_t t2_epoch;       // Start des Timers
+static uint64_t t2_next;        // Nächster Überlauf (TOV2 ab diesem Zeitpunkt)
+
+// UART
+static uint8_t  uart_udrie;
+static uint8_t  uart_rxc, uart_udr, uart_dor;
+static uint8_t  uart_ubrr = 7, uart_u2x;
+
+// TWI
+static uint8_t  twi_twcr, twi_twdr, twi_status = TW_NO_INFO;
+static enum { TWI_IDLE, TWI_STARTED, TWI_WRITE, TWI_READ } twi_state;
+
+// Display
+static uint8_t  lcd_halves;
+
+// Reset-Ursache: Power-on (PORF)
+static uint8_t  reset_cause = 0x01;
+
+uint64_t sim_time_ns(void) {
+	return now_ns;
+}
+
+void sim_set_end(uint64_t ns, void (*done)(void)) {
+	end_ns = ns;
+	end_fn = done;
+}
+
+void sim_get_stats(sim_stats_t* s) {
+	*s = stats;
+}
+
+// Empfangene Bytes, die bis jetzt fällig sind, ins UDR legen
+static void uart_receive(void) {
+	while (sim_serial_next_rx() <= now_ns) {
+		uint8_t data = sim_serial_take_rx();
+		if (uart_rxc) {
+			uart_dor = 1;  // Vorheriges Byte nicht abgeholt: überschrieben
+			continue;
+		}
+		uart_udr = data;
+		uart_rxc = 1;
+	}
+}
+
+// Ohne PROFILE_ENABLE hat die Firmware keine Timer2-ISR (der Timer läuft dann nicht)
+__attribute__((weak)) void sim_isr_timer2_ovf(void) {
+}
+
+// Wartende Interrupts abarbeiten (Priorität wie im ATmega8: Timer2, Timer1, RXC, UDRE)
+static void service(void) {
+	uart_receive();
+	while (I_SET()) {
+		if (t2_on && now_ns >= t2_next) {
+			t2_next += ((now_ns - t2_next) / T2_OVF_NS + 1) * T2_OVF_NS;  // Verpasste Überläufe gehen verloren
+			SREG &= ~(1 << SREG_I);
+			sim_isr_timer2_ovf();
+			SREG |= (1 << SREG_I);
+		} else if (tick_on && now_ns >= tick_next) {
+			uint64_t missed = (now_ns - tick_next) / tick_ns;
+			stats.ticks++;
+			stats.ticks_lost += missed;
+			tick_next += (missed + 1) * tick_ns;
+			SREG &= ~(1 << SREG_I);
+			sim_isr_timer1_compa();
+			SREG |= (1 << SREG_I);
+		} else if (uart_rxc) {
+			SREG &= ~(1 << SREG_I);
+			sim_isr_usart_rxc();
+			SREG |= (1 << SREG_I);
+		} else if (uart_udrie) {
+			SREG &= ~(1 << SREG_I);
+			sim_isr_usart_udre();
+			SREG |= (1 << SREG_I);
+		} else {
+			break;
+		}
+	}
+}
+
+// Nächstes Ereignis (Tick oder Empfang)
+static uint64_t next_event(void) {
+	uint64_t t = sim_serial_next_rx();
+	if (tick_on && tick_next < t) t = tick_next;
+	if (t2_on && t2_next < t) t = t2_next;
+	return t;
+}
+
+void sim_delay_ns(uint64_t ns) {
+	uint64_t target = now_ns + ns;
+	for (;;) {
+		uint64_t t = next_event();
+		if (t > target) break;
+		if (t > now_ns) now_ns = t;
+		service();
+		if (!I_SET()) break;  // Gesperrt: Ereignisse bleiben bis zum sei() stehen
+	}
+	now_ns = target;
+	service();
+}
+
+void sim_sei(void) {
+	SREG |= (1 << SREG_I);
+	service();
+}
+
+// --- SPI ---
+
+void hal_spi_init(void) {
+}
+
+uint8_t hal_spi_xfer(uint8_t data) {
+	stats.spi_bytes++;
+	sim_delay_ns(SPI_BYTE_NS);
+	return sim_eeprom_xfer(data);
+}
+
+void hal_eeprom_select(void) {
+	lcd_halves = 0;
+	sim_eeprom_select(1);
+}
+
+void hal_eeprom_deselect(void) {
+	sim_eeprom_select(0);
+	lcd_halves = HAL_LCD_LEFT | HAL_LCD_RIGHT;
+}
+
+// --- TWI ---
+
+void hal_twi_init(uint8_t bitrate) {
+	(void)bitrate;
+}
+
+void hal_twi_control(uint8_t twcr) {
+	twi_twcr = twcr;
+	if (!(twcr & (1 << TWEN))) {  // TWI aus: Bus loslassen
+		if (twi_state != TWI_IDLE) sim_bme280_stop();
+		twi_state = TWI_IDLE;
+		twi_status = TW_NO_INFO;
+		return;
+	}
+	if (!(twcr & (1 << TWINT))) return;
+	stats.twi_ops++;
+
+	if (twcr & (1 << TWSTA)) {
+		sim_delay_ns(TWI_COND_NS);
+		twi_status = (twi_state == TWI_IDLE) ? TW_START : TW_REP_START;
+		twi_state = TWI_STARTED;
+	} else if (twcr & (1 << TWSTO)) {
+		sim_delay_ns(TWI_COND_NS);
+		if (twi_state != TWI_IDLE) sim_bme280_stop();
+		twi_state = TWI_IDLE;
+		twi_status = TW_NO_INFO;
+		twi_twcr &= ~(1 << TWSTO);
+		return;  // Kein TWINT nach STOP
+	} else if (twi_state == TWI_STARTED) {
+		sim_delay_ns(TWI_BYTE_NS);
+		uint8_t ack = sim_bme280_address(twi_twdr);
+		if (twi_twdr & 0x01) {
+			twi_status = ack ? TW_MR_SLA_ACK : TW_MR_SLA_NACK;
+			twi_state = TWI_READ;
+		} else {
+			twi_status = ack ? TW_MT_SLA_ACK : TW_MT_SLA_NACK;
+			twi_state = TWI_WRITE;
+		}
+	} else if (twi_state == TWI_WRITE) {
+		sim_delay_ns(TWI_BYTE_NS);
+		twi_status = sim_bme280_write(twi_twdr) ? TW_MT_DATA_ACK : TW_MT_DATA_NACK;
+	} else if (twi_state == TWI_READ) {
+		sim_delay_ns(TWI_BYTE_NS);
+		twi_twdr = sim_bme280_read();
+		twi_status = (twcr & (1 << TWEA)) ? TW_MR_DATA_ACK : TW_MR_DATA_NACK;
+	} else {
+		twi_status = TW_BUS_ERROR;
+	}
+	twi_twcr |= (1 << TWINT);
+}
+
+uint8_t hal_twi_flags(void) {
+	return twi_twcr;
+}
+
+uint8_t hal_twi_status(void) {
+	return twi_status;
+}
+
+void hal_twi_put(uint8_t data) {
+	twi_twdr = data;
+}
+
+uint8_t hal_twi_get(void) {
+	return twi_twdr;
+}
+
+void hal_i2c_pull(uint8_t low) {
+	(void)low;
+}
+
+uint8_t hal_i2c_lines(void) {
+	return HAL_I2C_SDA | HAL_I2C_SCL;  // Der simulierte Slave hält den Bus nie fest
+}
+
+// --- UART ---
+
+static void uart_update_baud(void) {
+	sim_serial_baud(F_CPU / ((uart_u2x ? 8UL : 16UL) * (uart_ubrr + 1)));
+}
+
+void hal_uart_init(uint8_t ubrr) {
+	uart_ubrr = ubrr;
+	uart_u2x = 0;
+	uart_update_baud();
+}
+
+void hal_uart_baud(uint8_t ubrr, uint8_t u2x) {
+	uart_ubrr = ubrr;
+	uart_u2x = u2x;
+	uart_update_baud();
+}
+
+// Senden ohne Zeichenzeit: das Byte ist sofort auf der Leitung
+void hal_uart_put(uint8_t data) {
+	sim_serial_tx(data);
+}
+
+uint8_t hal_uart_get(void) {
+	uart_rxc = 0;
+	uart_dor = 0;
+	return uart_udr;
+}
+
+uint8_t hal_uart_rx_error(void) {
+	return uart_dor;
+}
+
+void hal_uart_udre_irq(uint8_t on) {
+	uart_udrie = on;
+	if (on) service();  // UDR ist immer frei: löst sofort aus, wenn freigegeben
+}
+
+uint8_t hal_uart_tx_free(void) {
+	return 1;
+}
+
+uint8_t hal_uart_tx_done(void) {
+	return 1;
+}
+
+uint8_t hal_uart_rx_ready(void) {
+	uart_receive();
+	return uart_rxc;
+}
+
+// --- KS0108 ---
+
+void hal_lcd_init(void) {
+}
+
+void hal_lcd_reset(uint8_t active) {
+	if (active) sim_lcd_reset();
+}
+
+void hal_lcd_select(uint8_t halves) {
+	lcd_halves = halves;
+}
+
+void hal_lcd_write(uint8_t rs, uint8_t data) {
+	sim_delay_ns(1000);  // Enable-Puls
+	sim_lcd_write(lcd_halves, rs, data);
+}
+
+uint8_t hal_lcd_read(uint8_t rs) {
+	sim_delay_ns(1000);
+	return sim_lcd_read(lcd_halves, rs);
+}
+
+// --- Taster (nie gedrückt) ---
+
+void hal_button_init(void) {
+}
+
+uint8_t hal_button_level(void) {
+	return 1;
+}
+
+// --- Timer ---
+
+void hal_tick_init(uint8_t top) {
+	tick_ns = (uint64_t)(top + 1) * 1024 * SIM_NS_PER_S / F_CPU;
+	tick_epoch = now_ns;
+	tick_next = now_ns + tick_ns;
+	tick_on = 1;
+}
+
+// Ist der Compare-Match fällig, steht der Timer schon im nächsten Tick
+// Vor hal_tick_init() steht der Timer (TCNT1 = 0)
+uint8_t hal_tick_count(void) {
+	if (!tick_on) return 0;
+	uint64_t in_tick = (now_ns - tick_epoch) % tick_ns;
+	return (uint8_t)(in_tick * (F_CPU / 1024) / SIM_NS_PER_S);
+}
+
+uint8_t hal_tick_pending(void) {
+	return tick_on && now_ns >= tick_next;
+}
+
+void hal_cycles_init(void) {
+}
+
+uint8_t hal_cycles(void) {
+	return (uint8_t)(now_ns * (F_CPU / 8) / SIM_NS_PER_S);
+}
+
+void hal_timer2_init(void) {
+	t2_epoch = now_ns;
+	t2_next = now_ns + T2_OVF_NS;
+	t2_on = 1;
+}
+
+// Ist der Überlauf fällig, steht der Timer schon im nächsten Durchlauf
+uint8_t hal_timer2_count(void) {
+	uint64_t in_ovf = (now_ns - t2_epoch) % T2_OVF_NS;
+	return (uint8_t)(in_ovf * (F_CPU / 8) / SIM_NS_PER_S);
+}
+
+uint8_t hal_timer2_pending(void) {
+	return t2_on && now_ns >= t2_next;
+}
+
+// --- Schlaf ---
+
+void hal_sleep_init(void) {
+}
+
+// Bis zum nächsten Ereignis vorlaufen; nach dem Ende der Simulation beenden
+void hal_sleep(void) {
+	stats.sleeps++;
+	SREG |= (1 << SREG_I);
+	if ((tick_on && now_ns >= tick_next) || hal_timer2_pending() || uart_rxc || sim_serial_next_rx() <= now_ns) {
+		service();
+		return;
+	}
+	if (now_ns >= end_ns) {
+		if (end_fn) end_fn();
+		exit(0);
+	}
+	uint64_t t = next_event();
+	if (t == UINT64_MAX) t = end_ns;
+	if (t > now_ns) {
+		stats.sleep_ns += t - now_ns;
+		now_ns = t;
+	}
+	service();
+}
+
+uint8_t hal_reset_cause(void) {
+	uint8_t cause = reset_cause;
+	reset_cause = 0;
+	return cause;
+}
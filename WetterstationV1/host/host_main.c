@@ -0,0 +1,87 @@
+/*
+ * host_main.c
+ *
+ * Startprogramm des Host-Builds
+ * Stellt die Simulation ein (Messwerte, Laufzeit, Mitschnitt der seriellen
+ * Leitung) und startet die unveränderte Firmware (main() aus main.c, hier
+ * firmware_main). Die Firmware kehrt nicht zurück: ist die virtuelle Zeit
+ * abgelaufen, beendet der nächste Idle-Schlaf das Programm über report().
+ *
+ * Aufruf: wetterstation_host [--seconds N] [--temp C] [--press HPA] [--hum PCT]
+ *                            [--tx DATEI] [--rx DATEI] [--lcd]
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+
+int firmware_main(void);
+
+static FILE*   tx_file;
+static uint8_t show_lcd;
+static clock_t wall_start;
+
+static void usage(void) {
+	fprintf(stderr, "Aufruf: wetterstation_host [--seconds N] [--temp C] [--press HPA] [--hum PCT]\n"
+	                "                           [--tx DATEI] [--rx DATEI] [--lcd]\n");
+	exit(2);
+}
+
+// Bericht am Ende der Simulation
+static void report(void) {
+	sim_report(stdout, (double)(clock() - wall_start) / CLOCKS_PER_SEC);
+	if (show_lcd) sim_lcd_dump(stdout);
+	if (tx_file) fclose(tx_file);
+	fflush(stdout);
+}
+
+// Datei einlesen und der Firmware nach einer Sekunde zustellen
+static void load_rx(const char* path) {
+	FILE* f = fopen(path, "rb");
+	if (!f) {
+		perror(path);
+		exit(1);
+	}
+	static uint8_t buf[4096];
+	size_t n = fread(buf, 1, sizeof(buf), f);
+	fclose(f);
+	sim_serial_inject(buf, (uint16_t)n, SIM_NS_PER_S);
+}
+
+int main(int argc, char** argv) {
+	double seconds = 60, temp = 21.0, press = 980.0, hum = 45.0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "--lcd")) {
+			show_lcd = 1;
+			continue;
+		}
+		if (i + 1 >= argc) usage();
+		const char* v = argv[++i];
+		if      (!strcmp(a, "--seconds")) seconds = atof(v);
+		else if (!strcmp(a, "--temp"))    temp = atof(v);
+		else if (!strcmp(a, "--press"))   press = atof(v);
+		else if (!strcmp(a, "--hum"))     hum = atof(v);
+		else if (!strcmp(a, "--rx"))      load_rx(v);
+		else if (!strcmp(a, "--tx")) {
+			tx_file = fopen(v, "wb");
+			if (!tx_file) {
+				perror(v);
+				return 1;
+			}
+		}
+		else usage();
+	}
+
+	sim_bme280_set(temp, press, hum);
+	sim_serial_capture(tx_file);
+	sim_set_end((uint64_t)(seconds * SIM_NS_PER_S), report);
+	wall_start = clock();
+	return firmware_main();
+}
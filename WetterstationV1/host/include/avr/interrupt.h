@@ -0,0 +1,23 @@
+/*
+ * avr/interrupt.h (Host-Build)
+ *
+ * ISR(...) wird eine gewöhnliche Funktion, cli()/sei() schalten das I-Bit
+ * in SREG. sei() arbeitet wartende Interrupts sofort ab, wie der ATmega8
+ * nach dem folgenden Befehl.
+ *
+ * Created: 18.10.2026 21:55:40
+ *  Author: morri
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+void sim_sei(void);
+
+#define ISR(vector, ...)  void vector(void); void vector(void)
+#define cli()             ((void)(SREG &= (uint8_t)~(1 << SREG_I)))
+#define sei()             sim_sei()
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
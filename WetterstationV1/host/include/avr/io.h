@@ -0,0 +1,61 @@
+/*
+ * avr/io.h (Host-Build)
+ *
+ * Ersatz für die avr-libc: nur Pin- und Bitnummern sowie SREG.
+ * Register gibt es hier absichtlich nicht - greift ein Treiber an hal.h
+ * vorbei auf die Hardware zu, schlägt der Host-Build fehl.
+ *
+ * Created: 18.10.2026 21:55:40
+ *  Author: morri
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+#define _BV(bit)   (1 << (bit))
+
+// Statusregister: nur das I-Bit wird nachgebildet (host/hal_host.c)
+extern volatile uint8_t SREG;
+#define SREG_I     7
+
+// Pins
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+// TWCR-Bits (werden von twimaster.c über hal_twi_control() geschrieben)
+#define TWINT      7
+#define TWEA       6
+#define TWSTA      5
+#define TWSTO      4
+#define TWEN       2
+
+// Interrupt-Vektoren: die ISRs werden zu Funktionen, die die Simulation aufruft
+#define TIMER1_COMPA_vect  sim_isr_timer1_compa
+#define TIMER2_OVF_vect    sim_isr_timer2_ovf
+#define USART_RXC_vect     sim_isr_usart_rxc
+#define USART_UDRE_vect    sim_isr_usart_udre
+
+#endif /* HOST_AVR_IO_H_ */
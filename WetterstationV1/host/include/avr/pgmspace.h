@@ -0,0 +1,26 @@
+/*
+ * avr/pgmspace.h (Host-Build)
+ *
+ * Es gibt nur einen Adressraum: PROGMEM-Daten liegen im RAM, die
+ * pgm_read_*-Makros lesen direkt.
+ *
+ * Created: 18.10.2026 21:55:40
+ *  Author: morri
+ */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s)               (s)
+#define pgm_read_byte(p)      (*(const uint8_t*)(p))
+#define pgm_read_word(p)      (*(const uint16_t*)(p))
+#define pgm_read_dword(p)     (*(const uint32_t*)(p))
+#define pgm_read_ptr(p)       (*(void* const*)(p))
+#define memcpy_P              memcpy
+#define strlen_P              strlen
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
@@ -0,0 +1,21 @@
+/*
+ * util/crc16.h (Host-Build)
+ *
+ * CRC-CCITT wie _crc_ccitt_update() der avr-libc (C-Fassung aus deren Doku).
+ *
+ * Created: 18.10.2026 21:55:40
+ *  Author: morri
+ */
+
+#ifndef HOST_UTIL_CRC16_H_
+#define HOST_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data) {
+	data ^= (uint8_t)(crc & 0xFF);
+	data ^= (uint8_t)(data << 4);
+	return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+#endif /* HOST_UTIL_CRC16_H_ */
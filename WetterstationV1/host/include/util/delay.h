@@ -0,0 +1,21 @@
+/*
+ * util/delay.h (Host-Build)
+ *
+ * Warteschleifen lassen die virtuelle Zeit der Simulation vorlaufen
+ * (fällige Interrupts laufen dabei wie auf dem ATmega8).
+ *
+ * Created: 18.10.2026 21:55:40
+ *  Author: morri
+ */
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+void sim_delay_ns(uint64_t ns);
+
+#define _delay_us(us)  sim_delay_ns((uint64_t)((us) * 1000.0))
+#define _delay_ms(ms)  sim_delay_ns((uint64_t)((ms) * 1000000.0))
+
+#endif /* HOST_UTIL_DELAY_H_ */
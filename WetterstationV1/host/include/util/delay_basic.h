@@ -0,0 +1,22 @@
+/*
+ * util/delay_basic.h (Host-Build)
+ *
+ * Zählschleifen von avr-libc: _delay_loop_1 braucht 3, _delay_loop_2 4 Takte
+ * je Durchlauf (n = 0 zählt wie 256 bzw. 65536). Die virtuelle Zeit läuft
+ * entsprechend vor.
+ *
+ * Created: 18.10.2026 22:41:07
+ *  Author: morri
+ */
+
+#ifndef HOST_UTIL_DELAY_BASIC_H_
+#define HOST_UTIL_DELAY_BASIC_H_
+
+#include <stdint.h>
+
+void sim_delay_ns(uint64_t ns);
+
+#define _delay_loop_1(n)  sim_delay_ns(((n) ? (uint64_t)(n) : 256ULL) * 3 * 1000000000ULL / F_CPU)
+#define _delay_loop_2(n)  sim_delay_ns(((n) ? (uint64_t)(n) : 65536ULL) * 4 * 1000000000ULL / F_CPU)
+
+#endif /* HOST_UTIL_DELAY_BASIC_H_ */
@@ -0,0 +1,45 @@
+/*
+ * ram_host.c
+ *
+ * ram.c für den Host-Build: ohne Linker-Symbole des AVR gibt es weder
+ * Füllmuster noch Stacktiefe, die Statistik bleibt 0. Die Einträge der
+ * Module (RAM_ACCOUNT) werden wie auf dem ATmega8 geliefert, zählen aber
+ * mit den Typgrößen des Hosts.
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#include "ram.h"
+
+extern const uint16_t ram_account_main;
+extern const uint16_t ram_account_display;
+extern const uint16_t ram_account_rs232;
+extern const uint16_t ram_account_link;
+extern const uint16_t ram_account_linkseq;
+extern const uint16_t ram_account_sched;
+extern const uint16_t ram_account_button;
+extern const uint16_t ram_account_storage;
+extern const uint16_t ram_account_sample;
+extern const uint16_t ram_account_filter;
+extern const uint16_t ram_account_arena;
+extern const uint16_t ram_account_trace;
+
+static const uint16_t* const accounts[RAM_MOD_COUNT] = {
+	&ram_account_main, &ram_account_display, &ram_account_rs232, &ram_account_link,
+	&ram_account_linkseq, &ram_account_sched, &ram_account_button, &ram_account_storage,
+	&ram_account_sample, &ram_account_filter, &ram_account_arena, &ram_account_trace
+};
+
+uint16_t ram_scan(void) {
+	return 0;
+}
+
+void ram_get_stats(ram_stats_t* stats) {
+	*stats = (ram_stats_t){0};
+}
+
+uint16_t ram_module_bytes(uint8_t mod) {
+	if (mod >= RAM_MOD_COUNT) return 0;
+	return *accounts[mod];
+}
@@ -0,0 +1,224 @@
+/*
+ * replay.c
+ *
+ * Replay im Host-Build: Messwertverläufe im Zeitraffer durch die Firmware
+ * Der BME280 liefert bei jeder Abfrage den Wert des Verlaufs zur virtuellen
+ * Zeit, Abtastung, Filter, Mittelwerte und EEPROM laufen unverändert
+ * (ganze Firmware, Tick-Interrupt virtuell). Eine Woche Betrieb dauert
+ * Sekunden. Am Ende stehen Schreibstatistik, Verschleiß je Zelle,
+ * SPI-Zugriffe und die 24h-/7d-Verläufe, wie sie im EEPROM liegen.
+ * Rückgabe 1, wenn Ticks verpasst wurden (Interrupts länger als ein Tick
+ * gesperrt), sonst 0.
+ *
+ * Verlauf aus einer CSV-Datei (Sekunden, °C, hPa[, %], '#' = Kommentar,
+ * dazwischen linear interpoliert) oder synthetisch: Tagesgang der Temperatur,
+ * langsame Druckwelle mit einer Front am dritten Tag, Messrauschen.
+ *
+ * Aufruf: wetterstation_replay [--days N] [--csv DATEI] [--seed N]
+ *                              [--wear DATEI] [--series DATEI]
+ *
+ * Created: 18.10.2026 22:41:05
+ *  Author: morri
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "sample.h"
+#include "storage.h"
+
+int firmware_main(void);
+
+#define HOUR_S             3600.0
+#define DAY_S              86400.0
+
+// Verlauf aus der CSV-Datei
+typedef struct {
+	double t, temp, press, hum;
+} point_t;
+
+static point_t* trace;
+static size_t   trace_len;
+static size_t   trace_pos;      // Letzter Abschnitt (Abfragen kommen zeitlich geordnet)
+static uint32_t noise_state = 1;
+
+static const char* wear_path;
+static const char* series_path;
+static clock_t     wall_start;
+
+static void usage(void) {
+	fprintf(stderr, "Aufruf: wetterstation_replay [--days N] [--csv DATEI] [--seed N]\n"
+	                "                             [--wear DATEI] [--series DATEI]\n");
+	exit(2);
+}
+
+// Gleichverteiltes Rauschen -1..1 (reproduzierbar über --seed)
+static double noise(void) {
+	noise_state = noise_state * 1103515245u + 12345u;
+	return ((noise_state >> 8) & 0xFFFF) / 32767.5 - 1.0;
+}
+
+static void synthetic(uint64_t now_ns, double* temp, double* press, double* hum) {
+	double t = (double)now_ns / SIM_NS_PER_S;
+	double day = 2.0 * M_PI * (t - 9.0 * HOUR_S) / DAY_S;   // Minimum um 3 Uhr, Maximum um 15 Uhr
+	double front = 1.0 / (1.0 + exp(-(t - 2.5 * DAY_S) / (2.0 * HOUR_S)));  // Front nach 2,5 Tagen
+	*temp  = 12.0 + 6.0 * sin(day) - 4.0 * front + 0.05 * noise();
+	*press = 990.0 + 6.0 * sin(2.0 * M_PI * t / (5.0 * DAY_S)) - 8.0 * front + 0.03 * noise();
+	*hum   = 60.0 - 15.0 * sin(day) + 15.0 * front + 0.2 * noise();
+}
+
+static void from_csv(uint64_t now_ns, double* temp, double* press, double* hum) {
+	double t = (double)now_ns / SIM_NS_PER_S;
+	while (trace_pos + 1 < trace_len && trace[trace_pos + 1].t <= t) trace_pos++;
+	const point_t* a = &trace[trace_pos];
+	if (trace_pos + 1 >= trace_len || t <= a->t) {
+		*temp = a->temp; *press = a->press; *hum = a->hum;
+		return;
+	}
+	const point_t* b = a + 1;
+	double f = (t - a->t) / (b->t - a->t);
+	*temp  = a->temp  + f * (b->temp  - a->temp);
+	*press = a->press + f * (b->press - a->press);
+	*hum   = a->hum   + f * (b->hum   - a->hum);
+}
+
+static void load_csv(const char* path) {
+	FILE* f = fopen(path, "r");
+	if (!f) {
+		perror(path);
+		exit(1);
+	}
+	char line[256];
+	size_t cap = 0;
+	while (fgets(line, sizeof(line), f)) {
+		point_t p = { 0, 0, 0, 50.0 };
+		if (line[0] == '#' || sscanf(line, "%lf,%lf,%lf,%lf", &p.t, &p.temp, &p.press, &p.hum) < 3) continue;
+		if (trace_len == cap) {
+			cap = cap ? cap * 2 : 1024;
+			trace = realloc(trace, cap * sizeof(point_t));
+			if (!trace) exit(1);
+		}
+		trace[trace_len++] = p;
+	}
+	fclose(f);
+	if (!trace_len) {
+		fprintf(stderr, "%s: keine Messwerte\n", path);
+		exit(1);
+	}
+}
+
+// Verschleiß eines Speicherbereichs
+static void report_wear(const char* name, uint16_t addr, uint16_t size, double days) {
+	uint64_t total = 0;
+	uint32_t max = 0;
+	uint16_t max_addr = addr;
+	for (uint16_t a = addr; a < addr + size; a++) {
+		uint32_t w = sim_eeprom_wear(a);
+		total += w;
+		if (w > max) {
+			max = w;
+			max_addr = a;
+		}
+	}
+	double per_day = days > 0 ? max / days : 0;
+	printf("  %-5s 0x%04X-0x%04X  %8llu Bytes geschrieben, je Zelle max. %6u (0x%04X), Mittel %8.1f",
+	       name, addr, addr + size - 1, (unsigned long long)total, max, max_addr, (double)total / size);
+	if (per_day > 0) printf(", Lebensdauer %.0f Tage\n", EEPROM_ENDURANCE / per_day);
+	else printf("\n");
+}
+
+static void write_wear(const char* path) {
+	FILE* f = fopen(path, "w");
+	if (!f) {
+		perror(path);
+		return;
+	}
+	fprintf(f, "addr,writes\n");
+	for (uint32_t a = 0; a < SIM_EEPROM_SIZE; a++) {
+		uint32_t w = sim_eeprom_wear(a);
+		if (w) fprintf(f, "%u,%u\n", a, w);
+	}
+	fclose(f);
+}
+
+// Verläufe aus dem EEPROM (über die Firmware gelesen, neuester Punkt zuerst)
+static void write_series(FILE* f) {
+	static const char* const names[SERIES_COUNT] = { "t24", "p24", "t7d", "p7d" };
+	int16_t points[DISPLAY_COUNT];
+	fprintf(f, "series,age,value\n");
+	for (uint8_t s = 0; s < SERIES_COUNT; s++) {
+		storage_series_read(s, 0, DISPLAY_COUNT, points);
+		for (uint8_t age = 0; age < DISPLAY_COUNT; age++) {
+			if (points[age] == SAMPLE_GAP_VALUE) fprintf(f, "%s,%u,\n", names[s], age);
+			else fprintf(f, "%s,%u,%d\n", names[s], age, points[age]);
+		}
+	}
+}
+
+// Bericht am Ende der Simulation
+static void report(void) {
+	double days = (double)sim_time_ns() / SIM_NS_PER_S / DAY_S;
+	storage_stats_t st;
+	storage_get_stats(&st, (uint32_t)(sim_time_ns() / SIM_NS_PER_S));
+
+	sim_report(stdout, (double)(clock() - wall_start) / CLOCKS_PER_SEC);
+	printf("Speicher:   %u Messungen, %u Datensätze (24h %u, 7d %u, Rohdaten %u), %lu eingespart, "
+	       "Intervall zuletzt %u s\n",
+	       st.samples, st.writes, st.region_writes[REGION_24H], st.region_writes[REGION_7D],
+	       st.region_writes[REGION_RAW], (unsigned long)st.writes_avoided, st.interval_s);
+	printf("Verschleiß (Schreibzyklen je Zelle, Lebensdauer bei %lu Zyklen):\n", EEPROM_ENDURANCE);
+	static const char* const names[REGION_COUNT] = { "24h", "7d", "raw" };
+	for (uint8_t r = 0; r < REGION_COUNT; r++) {
+		storage_region_t reg;
+		if (storage_region(r, &reg)) report_wear(names[r], reg.addr, reg.size, days);
+	}
+	if (wear_path) write_wear(wear_path);
+
+	// Verläufe: Temperatur in 0,1 °C, Druck in 0,1 hPa (Meereshöhe)
+	FILE* f = series_path ? fopen(series_path, "w") : stdout;
+	if (!f) {
+		perror(series_path);
+	} else {
+		write_series(f);
+		if (f != stdout) fclose(f);
+	}
+	fflush(stdout);
+
+	// Verpasste Ticks: Zeitbasis und Scheduler gehen nach, der Lauf gilt als fehlgeschlagen
+	sim_stats_t s;
+	sim_get_stats(&s);
+	if (s.ticks_lost) {
+		fprintf(stderr, "wetterstation_replay: %llu Ticks verpasst\n", (unsigned long long)s.ticks_lost);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv) {
+	double days = 7;
+	uint8_t days_set = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (i + 1 >= argc) usage();
+		const char* v = argv[++i];
+		if      (!strcmp(a, "--days"))   { days = atof(v); days_set = 1; }
+		else if (!strcmp(a, "--csv"))    load_csv(v);
+		else if (!strcmp(a, "--seed"))   noise_state = (uint32_t)strtoul(v, NULL, 0);
+		else if (!strcmp(a, "--wear"))   wear_path = v;
+		else if (!strcmp(a, "--series")) series_path = v;
+		else usage();
+	}
+
+	if (trace_len) {
+		sim_bme280_set_source(from_csv);
+		if (!days_set) days = trace[trace_len - 1].t / DAY_S;  // Ganzer Verlauf
+	} else {
+		sim_bme280_set_source(synthetic);
+	}
+	sim_set_end((uint64_t)(days * DAY_S * SIM_NS_PER_S), report);
+	wall_start = clock();
+	return firmware_main();
+}
@@ -0,0 +1,137 @@
+/*
+ * sim.h
+ *
+ * Header-Datei für die Simulation im Host-Build
+ * hal_host.c setzt hal.h auf einer virtuellen Zeit um: sie läuft nur in
+ * Warteschleifen, Busübertragungen und im Idle-Schlaf weiter, Rechenzeit der
+ * Firmware kostet nichts. Fällige Interrupts (Tick, UART) laufen, sobald das
+ * I-Bit gesetzt ist, wie auf dem ATmega8 mit gesperrtem I-Bit innerhalb der ISR.
+ *
+ * Die Bausteine hinter dem HAL sind Modelle: 25LC256 (sim_eeprom.c), BME280
+ * (sim_bme280.c), KS0108 (sim_ks0108.c) und die Gegenseite der seriellen
+ * Leitung (sim_serial.c).
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_NS_PER_S       1000000000ULL
+
+// --- Virtuelle Zeit (hal_host.c) ---
+
+// Nanosekunden seit dem Start
+uint64_t sim_time_ns(void);
+// Zeit vorlaufen lassen, fällige Interrupts laufen dabei (wenn freigegeben)
+void sim_delay_ns(uint64_t ns);
+// I-Bit setzen und wartende Interrupts abarbeiten
+void sim_sei(void);
+
+// Ende der Simulation: ist die Zeit erreicht, ruft der nächste Idle-Schlaf
+// done() auf und beendet das Programm
+void sim_set_end(uint64_t ns, void (*done)(void));
+
+// Interrupt-Routinen der Firmware (avr/io.h bildet die Vektornamen darauf ab)
+void sim_isr_timer1_compa(void);
+void sim_isr_timer2_ovf(void);
+void sim_isr_usart_rxc(void);
+void sim_isr_usart_udre(void);
+
+// Zähler der Simulation
+typedef struct {
+	uint64_t ticks;         // Timer1-Interrupts
+	uint64_t ticks_lost;    // Ticks, deren Interrupt zu spät kam (Flag schon gesetzt)
+	uint64_t sleeps;        // Idle-Schlaf-Aufrufe
+	uint64_t sleep_ns;      // Geschlafene Zeit
+	uint64_t spi_bytes;     // SPI-Übertragungen
+	uint64_t twi_ops;       // TWI-Operationen (START, Byte, STOP)
+} sim_stats_t;
+
+void sim_get_stats(sim_stats_t* stats);
+
+// Alle Zähler als Text (sim_report.c), wall_s = verbrauchte Rechenzeit
+void sim_report(FILE* out, double wall_s);
+
+// --- 25LC256 (sim_eeprom.c) ---
+
+#define SIM_EEPROM_SIZE    32768
+#define SIM_EEPROM_PAGE    64
+
+typedef struct {
+	uint32_t transactions;  // CS-Zyklen
+	uint32_t reads;         // READ-Kommandos
+	uint32_t writes;        // WRITE-Kommandos mit Schreibzyklus
+	uint32_t bytes_read;
+	uint32_t bytes_written;
+	uint32_t rejected;      // WRITE ohne WREN oder während eines Schreibzyklus
+	uint32_t status_polls;  // RDSR-Kommandos
+} sim_eeprom_stats_t;
+
+void sim_eeprom_select(uint8_t selected);
+uint8_t sim_eeprom_xfer(uint8_t mosi);
+void sim_eeprom_get_stats(sim_eeprom_stats_t* stats);
+// Schreibzyklen einer Zelle (Verschleiß), Inhalt
+uint32_t sim_eeprom_wear(uint16_t addr);
+const uint8_t* sim_eeprom_data(void);
+
+// --- BME280 (sim_bme280.c) ---
+
+#define SIM_BME280_ADDR    0x76
+
+// Messwerte, die der Sensor ab der nächsten Abfrage liefert
+void sim_bme280_set(double temp_c, double press_hpa, double hum_pct);
+// Messwerte stattdessen bei jeder Abfrage von fn holen (Replay, NULL = feste Werte)
+typedef void (*sim_bme280_source_t)(uint64_t now_ns, double* temp_c, double* press_hpa, double* hum_pct);
+void sim_bme280_set_source(sim_bme280_source_t fn);
+// Sensor antwortet (1) oder nicht (0)
+void sim_bme280_present(uint8_t on);
+
+// Busseite: Adressbyte (mit R/W), Rückgabe 1 = ACK
+uint8_t sim_bme280_address(uint8_t sla);
+uint8_t sim_bme280_write(uint8_t data);
+uint8_t sim_bme280_read(void);
+void sim_bme280_stop(void);
+
+// --- KS0108 (sim_ks0108.c) ---
+
+typedef struct {
+	uint32_t commands;
+	uint32_t data_writes;
+	uint32_t data_reads;
+	uint32_t status_reads;
+} sim_lcd_stats_t;
+
+void sim_lcd_reset(void);
+void sim_lcd_write(uint8_t halves, uint8_t rs, uint8_t data);
+uint8_t sim_lcd_read(uint8_t halves, uint8_t rs);
+void sim_lcd_get_stats(sim_lcd_stats_t* stats);
+// Pixel (x 0..127, y 0..63), Startzeile berücksichtigt
+uint8_t sim_lcd_pixel(uint8_t x, uint8_t y);
+// Bildschirm als Text ausgeben
+void sim_lcd_dump(FILE* out);
+
+// --- Gegenseite der seriellen Leitung (sim_serial.c) ---
+
+typedef struct {
+	uint32_t tx_bytes;      // Von der Firmware gesendet
+	uint32_t rx_bytes;      // An die Firmware zugestellt
+} sim_serial_stats_t;
+
+// Gesendete Bytes in eine Datei mitschreiben (NULL = verwerfen)
+void sim_serial_capture(FILE* out);
+// Bytes für die Firmware einreihen, Abstand eine Zeichenzeit der aktuellen Baudrate
+void sim_serial_inject(const uint8_t* data, uint16_t len, uint64_t at_ns);
+void sim_serial_get_stats(sim_serial_stats_t* stats);
+
+// Von hal_host.c: Baudrate, gesendetes Byte, nächstes Empfangsbyte fällig?
+void sim_serial_baud(uint32_t baud);
+void sim_serial_tx(uint8_t data);
+uint64_t sim_serial_next_rx(void);     // UINT64_MAX = nichts geplant
+uint8_t sim_serial_take_rx(void);
+
+#endif /* SIM_H_ */
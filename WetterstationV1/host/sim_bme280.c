@@ -0,0 +1,187 @@
+/*
+ * sim_bme280.c
+ *
+ * Modell des BME280 am I2C-Bus (Adresse 0x76)
+ * Registersatz mit Chip-ID, Kalibrierung und Messdaten. Die Rohwerte
+ * (0xF7..0xFE) werden zu Beginn jedes Lesezugriffs aus den eingestellten
+ * Messwerten berechnet: die Kompensationsformeln des Datenblatts (double)
+ * werden per Bisektion umgekehrt, die Firmware rechnet sie mit ihren
+ * Integer-Formeln wieder zurück. Der Druck ist der am Sensor, die Firmware
+ * rechnet ihn selbst auf Meereshöhe um. Mit einer Quelle (Replay) werden die
+ * Messwerte bei jedem Lesezugriff zur aktuellen virtuellen Zeit abgefragt.
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#include <string.h>
+#include "sim.h"
+
+// Kalibrierung eines typischen Exemplars
+static const uint16_t T1 = 27504;
+static const int16_t  T2 = 26435, T3 = -1000;
+static const uint16_t P1 = 36477;
+static const int16_t  P2 = -10685, P3 = 3024, P4 = 2855, P5 = 140, P6 = -7, P7 = 15500, P8 = -14600, P9 = 6000;
+static const uint8_t  H1 = 75;
+static const int16_t  H2 = 362;
+static const uint8_t  H3 = 0;
+static const int16_t  H4 = 313, H5 = 50;
+static const int8_t   H6 = 30;
+
+static uint8_t regs[256];
+static uint8_t initialised;
+static uint8_t present = 1;
+
+static double temp_c = 21.0, press_hpa = 980.0, hum_pct = 45.0;
+static sim_bme280_source_t source;
+
+static uint8_t  selected;      // Adresse hat ACK bekommen
+static uint8_t  reading;
+static uint8_t  reg_ptr;
+static uint8_t  ptr_set;       // Erstes Byte eines Schreibzugriffs war die Registeradresse
+
+static void put16(uint8_t reg, uint16_t v) {
+	regs[reg] = (uint8_t)v;
+	regs[reg + 1] = (uint8_t)(v >> 8);
+}
+
+static void init(void) {
+	if (initialised) return;
+	put16(0x88, T1);
+	put16(0x8A, (uint16_t)T2);
+	put16(0x8C, (uint16_t)T3);
+	put16(0x8E, P1);
+	put16(0x90, (uint16_t)P2);
+	put16(0x92, (uint16_t)P3);
+	put16(0x94, (uint16_t)P4);
+	put16(0x96, (uint16_t)P5);
+	put16(0x98, (uint16_t)P6);
+	put16(0x9A, (uint16_t)P7);
+	put16(0x9C, (uint16_t)P8);
+	put16(0x9E, (uint16_t)P9);
+	regs[0xA1] = H1;
+	put16(0xE1, (uint16_t)H2);
+	regs[0xE3] = H3;
+	regs[0xE4] = (uint8_t)(H4 >> 4);
+	regs[0xE5] = (uint8_t)((H4 & 0x0F) | ((H5 & 0x0F) << 4));
+	regs[0xE6] = (uint8_t)(H5 >> 4);
+	regs[0xE7] = (uint8_t)H6;
+	regs[0xD0] = 0x60;  // Chip-ID
+	initialised = 1;
+}
+
+// Kompensation laut Datenblatt (Gleitkomma-Fassung)
+static double comp_t(double adc, double* t_fine) {
+	double v1 = (adc / 16384.0 - T1 / 1024.0) * T2;
+	double v2 = (adc / 131072.0 - T1 / 8192.0) * (adc / 131072.0 - T1 / 8192.0) * T3;
+	*t_fine = v1 + v2;
+	return (v1 + v2) / 5120.0;
+}
+
+static double comp_p(double adc, double t_fine) {
+	double v1 = t_fine / 2.0 - 64000.0;
+	double v2 = v1 * v1 * P6 / 32768.0;
+	v2 = v2 + v1 * P5 * 2.0;
+	v2 = v2 / 4.0 + P4 * 65536.0;
+	v1 = (P3 * v1 * v1 / 524288.0 + P2 * v1) / 524288.0;
+	v1 = (1.0 + v1 / 32768.0) * P1;
+	if (v1 == 0.0) return 0;
+	double p = 1048576.0 - adc;
+	p = (p - v2 / 4096.0) * 6250.0 / v1;
+	v1 = P9 * p * p / 2147483648.0;
+	v2 = p * P8 / 32768.0;
+	return (p + (v1 + v2 + P7) / 16.0) / 100.0;  // hPa
+}
+
+static double comp_h(double adc, double t_fine) {
+	double h = t_fine - 76800.0;
+	h = (adc - (H4 * 64.0 + H5 / 16384.0 * h)) *
+	    (H2 / 65536.0 * (1.0 + H6 / 67108864.0 * h * (1.0 + H3 / 67108864.0 * h)));
+	h = h * (1.0 - H1 * h / 524288.0);
+	if (h > 100.0) h = 100.0;
+	if (h < 0.0) h = 0.0;
+	return h;
+}
+
+// Rohwert suchen, für den f() den Sollwert liefert (f monoton im Bereich)
+static uint32_t invert(double target, uint32_t max, double (*f)(double, double), double t_fine) {
+	uint32_t lo = 0, hi = max;
+	uint8_t rising = f(hi, t_fine) > f(lo, t_fine);
+	while (hi - lo > 1) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if ((f(mid, t_fine) < target) == rising) lo = mid;
+		else hi = mid;
+	}
+	return lo;
+}
+
+static double comp_t_only(double adc, double unused) {
+	double t_fine;
+	(void)unused;
+	return comp_t(adc, &t_fine);
+}
+
+// Rohwerte aus den eingestellten Messwerten in die Datenregister legen
+static void update_data(void) {
+	if (source) source(sim_time_ns(), &temp_c, &press_hpa, &hum_pct);
+	uint32_t adc_t = invert(temp_c, 0xFFFFF, comp_t_only, 0);
+	double t_fine;
+	comp_t(adc_t, &t_fine);
+	uint32_t adc_p = invert(press_hpa, 0xFFFFF, comp_p, t_fine);
+	uint32_t adc_h = invert(hum_pct, 0xFFFF, comp_h, t_fine);
+
+	regs[0xF7] = (uint8_t)(adc_p >> 12);
+	regs[0xF8] = (uint8_t)(adc_p >> 4);
+	regs[0xF9] = (uint8_t)(adc_p << 4);
+	regs[0xFA] = (uint8_t)(adc_t >> 12);
+	regs[0xFB] = (uint8_t)(adc_t >> 4);
+	regs[0xFC] = (uint8_t)(adc_t << 4);
+	regs[0xFD] = (uint8_t)(adc_h >> 8);
+	regs[0xFE] = (uint8_t)adc_h;
+}
+
+void sim_bme280_set(double t, double p_hpa, double h) {
+	temp_c = t;
+	press_hpa = p_hpa;
+	hum_pct = h;
+}
+
+void sim_bme280_set_source(sim_bme280_source_t fn) {
+	source = fn;
+}
+
+void sim_bme280_present(uint8_t on) {
+	present = on;
+}
+
+uint8_t sim_bme280_address(uint8_t sla) {
+	init();
+	selected = present && (sla >> 1) == SIM_BME280_ADDR;
+	reading = sla & 0x01;
+	ptr_set = 0;
+	if (selected && reading) update_data();
+	return selected;
+}
+
+uint8_t sim_bme280_write(uint8_t data) {
+	if (!selected || reading) return 0;
+	if (!ptr_set) {
+		reg_ptr = data;
+		ptr_set = 1;
+	} else {
+		// Nur die Steuerregister sind beschreibbar (Schreibzugriffe: Adresse, Wert)
+		if (reg_ptr == 0xF2 || reg_ptr == 0xF4 || reg_ptr == 0xF5) regs[reg_ptr] = data;
+		if (reg_ptr == 0xE0 && data == 0xB6) memset(regs + 0xF2, 0, 4);  // Soft-Reset
+		reg_ptr++;
+	}
+	return 1;
+}
+
+uint8_t sim_bme280_read(void) {
+	if (!selected || !reading) return 0xFF;
+	return regs[reg_ptr++];
+}
+
+void sim_bme280_stop(void) {
+	selected = 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * sim_eeprom.c
+ *
+ * Modell des SPI-EEPROMs 25LC256 (32 KB, Seiten zu 64 Bytes)
+ * Kommandos WREN, WRDI, RDSR, READ und WRITE. Ein WRITE schreibt erst mit
+ * dem Anheben von CS, danach ist das WIP-Bit 5 ms gesetzt (typischer
+ * Schreibzyklus) und der Baustein nimmt keine Schreibkommandos an. Adressen
+ * laufen beim Schreiben innerhalb der Seite um, wie im Datenblatt.
+ *
+ * Je Zelle wird gezählt, wie oft sie in einem Schreibzyklus lag (Verschleiß).
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#include <string.h>
+#include "sim.h"
+
+#define CMD_READ           0x03
+#define CMD_WRITE          0x02
+#define CMD_WRDI           0x04
+#define CMD_RDSR           0x05
+#define CMD_WREN           0x06
+
+#define STATUS_WIP         0x01
+#define STATUS_WEL         0x02
+
+#define WRITE_CYCLE_NS     5000000ULL
+
+static uint8_t  mem[SIM_EEPROM_SIZE];
+static uint32_t wear[SIM_EEPROM_SIZE];
+static uint8_t  initialised;
+
+static uint8_t  selected;
+static uint8_t  wel;
+static uint64_t busy_until;
+static sim_eeprom_stats_t stats;
+
+// Laufende Transaktion
+static uint8_t  cmd;
+static uint8_t  pos;           // Empfangene Bytes seit CS Low
+static uint16_t addr;
+static uint8_t  page_buf[SIM_EEPROM_PAGE];
+static uint8_t  page_set[SIM_EEPROM_PAGE];
+static uint8_t  page_count;
+
+static void init(void) {
+	if (initialised) return;
+	memset(mem, 0xFF, sizeof(mem));  // Auslieferungszustand
+	initialised = 1;
+}
+
+static uint8_t busy(void) {
+	return sim_time_ns() < busy_until;
+}
+
+// Seitenpuffer ins Array übernehmen (CS High nach WRITE)
+static void commit(void) {
+	uint16_t page = addr & ~(SIM_EEPROM_PAGE - 1) & (SIM_EEPROM_SIZE - 1);
+	for (uint8_t i = 0; i < SIM_EEPROM_PAGE; i++) {
+		if (!page_set[i]) continue;
+		mem[page + i] = page_buf[i];
+		wear[page + i]++;
+		stats.bytes_written++;
+	}
+	stats.writes++;
+	busy_until = sim_time_ns() + WRITE_CYCLE_NS;
+	wel = 0;
+}
+
+void sim_eeprom_select(uint8_t sel) {
+	init();
+	if (sel && !selected) {
+		cmd = 0;
+		pos = 0;
+		page_count = 0;
+		memset(page_set, 0, sizeof(page_set));
+		stats.transactions++;
+	} else if (!sel && selected) {
+		if (cmd == CMD_WREN && pos == 1 && !busy()) wel = 1;
+		if (cmd == CMD_WRDI && pos == 1) wel = 0;
+		if (cmd == CMD_WRITE && page_count) commit();
+	}
+	selected = sel;
+}
+
+uint8_t sim_eeprom_xfer(uint8_t mosi) {
+	init();
+	if (!selected) return 0xFF;
+	uint8_t miso = 0xFF;
+
+	if (pos == 0) {
+		cmd = mosi;
+		if (cmd == CMD_READ) stats.reads++;
+		if (cmd == CMD_RDSR) stats.status_polls++;
+		if (cmd == CMD_WRITE && (busy() || !wel)) {
+			stats.rejected++;
+			cmd = 0;  // Rest der Transaktion ignorieren
+		}
+	} else if (cmd == CMD_RDSR) {
+		miso = (busy() ? STATUS_WIP : 0) | (wel ? STATUS_WEL : 0);
+	} else if (cmd == CMD_READ || cmd == CMD_WRITE) {
+		if (pos == 1) {
+			addr = (uint16_t)mosi << 8;
+		} else if (pos == 2) {
+			addr |= mosi;
+			addr &= SIM_EEPROM_SIZE - 1;
+		} else if (cmd == CMD_READ) {
+			miso = busy() ? 0xFF : mem[addr];
+			addr = (addr + 1) & (SIM_EEPROM_SIZE - 1);
+			stats.bytes_read++;
+		} else {
+			uint8_t i = addr & (SIM_EEPROM_PAGE - 1);
+			page_buf[i] = mosi;
+			if (!page_set[i]) page_count++;
+			page_set[i] = 1;
+			addr = (addr & ~(SIM_EEPROM_PAGE - 1)) | ((i + 1) & (SIM_EEPROM_PAGE - 1));
+		}
+	}
+	if (pos < 3) pos++;
+	return miso;
+}
+
+void sim_eeprom_get_stats(sim_eeprom_stats_t* s) {
+	*s = stats;
+}
+
+uint32_t sim_eeprom_wear(uint16_t a) {
+	return wear[a & (SIM_EEPROM_SIZE - 1)];
+}
+
+const uint8_t* sim_eeprom_data(void) {
+	init();
+	return mem;
+}
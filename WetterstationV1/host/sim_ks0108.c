@@ -0,0 +1,97 @@
+/*
+ * sim_ks0108.c
+ *
+ * Modell des Grafikdisplays: zwei KS0108-Controller mit je 64 x 64 Pixeln
+ * Kommandos: Ein/Aus (0x3E/0x3F), Spalte (0x40 | y), Seite (0xB8 | x),
+ * Startzeile (0xC0 | z). Lesen liefert wie der echte Controller erst beim
+ * zweiten Zugriff die Daten der Adresse (Dummy-Read), Lesen und Schreiben
+ * erhöhen die Spalte. Beschäftigt ist das Modell nie.
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#include <string.h>
+#include "hal.h"
+#include "sim.h"
+
+typedef struct {
+	uint8_t ram[8][64];   // Seite, Spalte
+	uint8_t page, col, start;
+	uint8_t on;
+	uint8_t latch;        // Ausgangsregister für Lesezugriffe
+} chip_t;
+
+static chip_t chips[2];
+static sim_lcd_stats_t stats;
+
+void sim_lcd_reset(void) {
+	for (uint8_t i = 0; i < 2; i++) {
+		chips[i].page = chips[i].col = chips[i].start = 0;
+		chips[i].on = 0;
+	}
+}
+
+static void chip_write(chip_t* c, uint8_t rs, uint8_t data) {
+	if (rs == HAL_LCD_DATA) {
+		c->ram[c->page][c->col] = data;
+		c->col = (c->col + 1) & 63;
+	} else if ((data & 0xFE) == 0x3E) {
+		c->on = data & 0x01;
+	} else if ((data & 0xC0) == 0x40) {
+		c->col = data & 63;
+	} else if ((data & 0xF8) == 0xB8) {
+		c->page = data & 7;
+	} else if ((data & 0xC0) == 0xC0) {
+		c->start = data & 63;
+	}
+}
+
+void sim_lcd_write(uint8_t halves, uint8_t rs, uint8_t data) {
+	if (rs == HAL_LCD_DATA) stats.data_writes++;
+	else stats.commands++;
+	if (halves & HAL_LCD_LEFT)  chip_write(&chips[0], rs, data);
+	if (halves & HAL_LCD_RIGHT) chip_write(&chips[1], rs, data);
+}
+
+uint8_t sim_lcd_read(uint8_t halves, uint8_t rs) {
+	// Beide Hälften gewählt: Buskonflikt, gelesen wird die linke
+	chip_t* c = (halves & HAL_LCD_LEFT) ? &chips[0] : (halves & HAL_LCD_RIGHT) ? &chips[1] : NULL;
+	if (!c) return 0xFF;
+	if (rs == HAL_LCD_INSTR) {
+		stats.status_reads++;
+		return c->on ? 0x00 : 0x20;
+	}
+	stats.data_reads++;
+	uint8_t out = c->latch;
+	c->latch = c->ram[c->page][c->col];
+	c->col = (c->col + 1) & 63;
+	return out;
+}
+
+void sim_lcd_get_stats(sim_lcd_stats_t* s) {
+	*s = stats;
+}
+
+uint8_t sim_lcd_pixel(uint8_t x, uint8_t y) {
+	chip_t* c = &chips[(x >> 6) & 1];
+	uint8_t line = (y + c->start) & 63;
+	return (c->ram[line >> 3][x & 63] >> (line & 7)) & 1;
+}
+
+void sim_lcd_dump(FILE* out) {
+	fprintf(out, "+");
+	for (uint8_t x = 0; x < 128; x++) fputc('-', out);
+	fprintf(out, "+\n");
+	for (uint8_t y = 0; y < 64; y++) {
+		fputc('|', out);
+		for (uint8_t x = 0; x < 128; x++) {
+			uint8_t on = chips[x >> 6].on;
+			fputc(on && sim_lcd_pixel(x, y) ? '#' : ' ', out);
+		}
+		fprintf(out, "|\n");
+	}
+	fprintf(out, "+");
+	for (uint8_t x = 0; x < 128; x++) fputc('-', out);
+	fprintf(out, "+\n");
+}
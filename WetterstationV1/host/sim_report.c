@@ -0,0 +1,35 @@
+/*
+ * sim_report.c
+ *
+ * Zähler der Simulation als Textbericht (Host-Programm und Replay)
+ *
+ * Created: 18.10.2026 22:41:05
+ *  Author: morri
+ */
+
+#include "sim.h"
+
+void sim_report(FILE* out, double wall_s) {
+	sim_stats_t s;
+	sim_eeprom_stats_t e;
+	sim_lcd_stats_t l;
+	sim_serial_stats_t u;
+	sim_get_stats(&s);
+	sim_eeprom_get_stats(&e);
+	sim_lcd_get_stats(&l);
+	sim_serial_get_stats(&u);
+
+	double sim_s = (double)sim_time_ns() / SIM_NS_PER_S;
+	fprintf(out, "Simuliert:  %.1f s in %.2f s Rechenzeit\n", sim_s, wall_s);
+	fprintf(out, "Zeitbasis:  %llu Ticks, %llu verpasst, %.1f%% im Idle-Schlaf\n",
+	        (unsigned long long)s.ticks, (unsigned long long)s.ticks_lost,
+	        sim_s > 0 ? 100.0 * s.sleep_ns / sim_time_ns() : 0.0);
+	fprintf(out, "EEPROM:     %u Zugriffe, %u Lese-/%u Schreibkommandos, %u/%u Bytes gelesen/geschrieben, "
+	        "%u Statusabfragen, %u abgewiesen\n",
+	        e.transactions, e.reads, e.writes, e.bytes_read, e.bytes_written, e.status_polls, e.rejected);
+	fprintf(out, "SPI:        %llu Bytes\n", (unsigned long long)s.spi_bytes);
+	fprintf(out, "I2C:        %llu Busoperationen\n", (unsigned long long)s.twi_ops);
+	fprintf(out, "Display:    %u Kommandos, %u Datenbytes geschrieben, %u gelesen\n",
+	        l.commands, l.data_writes, l.data_reads);
+	fprintf(out, "Seriell:    %u Bytes gesendet, %u empfangen\n", u.tx_bytes, u.rx_bytes);
+}
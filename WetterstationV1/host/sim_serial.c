@@ -0,0 +1,73 @@
+/*
+ * sim_serial.c
+ *
+ * Gegenseite der seriellen Leitung (ESP8266)
+ * Gesendete Bytes gehen ungeteilt in eine Datei, die tools/trace_decode.py
+ * mit --raw lesen kann. Bytes für die Firmware stehen in einer Warteschlange
+ * und kommen im Abstand einer Zeichenzeit (10 Bit) der eingestellten
+ * Baudrate an.
+ *
+ * Created: 18.10.2026 22:04:12
+ *  Author: morri
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#define RX_QUEUE_SIZE      4096
+
+static FILE*    capture;
+static uint32_t baud = 28800;
+static sim_serial_stats_t stats;
+
+static uint8_t  rx_data[RX_QUEUE_SIZE];
+static uint16_t rx_head, rx_tail;
+static uint64_t rx_due = UINT64_MAX;  // Ankunft des Bytes an rx_tail
+
+static uint64_t char_ns(void) {
+	return 10ULL * SIM_NS_PER_S / baud;
+}
+
+void sim_serial_capture(FILE* out) {
+	capture = out;
+}
+
+void sim_serial_inject(const uint8_t* data, uint16_t len, uint64_t at_ns) {
+	uint8_t was_empty = rx_head == rx_tail;
+	for (uint16_t i = 0; i < len; i++) {
+		uint16_t next = (rx_head + 1) % RX_QUEUE_SIZE;
+		if (next == rx_tail) break;
+		rx_data[rx_head] = data[i];
+		rx_head = next;
+	}
+	if (was_empty && rx_head != rx_tail) {
+		uint64_t now = sim_time_ns();
+		rx_due = (at_ns > now ? at_ns : now) + char_ns();
+	}
+}
+
+void sim_serial_get_stats(sim_serial_stats_t* s) {
+	*s = stats;
+}
+
+void sim_serial_baud(uint32_t b) {
+	if (b) baud = b;
+}
+
+void sim_serial_tx(uint8_t data) {
+	stats.tx_bytes++;
+	if (capture) fputc(data, capture);
+}
+
+uint64_t sim_serial_next_rx(void) {
+	return rx_due;
+}
+
+uint8_t sim_serial_take_rx(void) {
+	uint8_t data = rx_data[rx_tail];
+	rx_tail = (rx_tail + 1) % RX_QUEUE_SIZE;
+	stats.rx_bytes++;
+	rx_due = (rx_head == rx_tail) ? UINT64_MAX : rx_due + char_ns();
+	return data;
+}
@@ -0,0 +1,108 @@
+/*
+ * test_fmt.c
+ *
+ * Test der Zahlenformatierung (fmt.c) im Host-Build
+ * fmt_u16/fmt_i16 laufen über den ganzen 16-Bit-Bereich, fmt_u32/fmt_i32
+ * über die Ränder, jede Zehnerpotenz +-1 und einen Pseudozufallsanteil.
+ * Vergleich mit snprintf: Text, Rückgabewert und kein Byte hinter
+ * FMT_*_LEN beschrieben. Rückgabe 0 = alle Werte gleich.
+ *
+ * Created: 18.10.2026 23:31:07
+ *  Author: morri
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "fmt.h"
+
+#define GUARD              0xA5
+
+static unsigned long failures;
+
+// Ausgabe mit snprintf vergleichen, Puffer mit Schutzbytes hinter der Größe aus fmt.h
+static void compare(const char* want, const char* got, uint8_t n, uint8_t size, const char* name) {
+	uint8_t ok = n == strlen(want) && strcmp(got, want) == 0;
+	for (uint8_t i = size; i < size + 4; i++) {
+		if ((uint8_t)got[i] != GUARD) ok = 0;
+	}
+	if (!ok) {
+		if (failures < 20) fprintf(stderr, "%s(%s): \"%.*s\" (%u Zeichen)\n", name, want, size, got, n);
+		failures++;
+	}
+}
+
+static void check_u16(uint16_t v) {
+	char want[16], got[FMT_U16_LEN + 4];
+	memset(got, GUARD, sizeof(got));
+	snprintf(want, sizeof(want), "%u", v);
+	compare(want, got, fmt_u16(v, got), FMT_U16_LEN, "fmt_u16");
+}
+
+static void check_i16(int16_t v) {
+	char want[16], got[FMT_I16_LEN + 4];
+	memset(got, GUARD, sizeof(got));
+	snprintf(want, sizeof(want), "%d", v);
+	compare(want, got, fmt_i16(v, got), FMT_I16_LEN, "fmt_i16");
+}
+
+static void check_u32(uint32_t v) {
+	char want[16], got[FMT_U32_LEN + 4];
+	memset(got, GUARD, sizeof(got));
+	snprintf(want, sizeof(want), "%" PRIu32, v);
+	compare(want, got, fmt_u32(v, got), FMT_U32_LEN, "fmt_u32");
+}
+
+static void check_i32(int32_t v) {
+	char want[16], got[FMT_I32_LEN + 4];
+	memset(got, GUARD, sizeof(got));
+	snprintf(want, sizeof(want), "%" PRId32, v);
+	compare(want, got, fmt_i32(v, got), FMT_I32_LEN, "fmt_i32");
+}
+
+int main(void) {
+	// 16 Bit vollständig
+	for (uint32_t v = 0; v <= 0xFFFF; v++) {
+		check_u16((uint16_t)v);
+		check_i16((int16_t)v);
+	}
+
+	// 32 Bit: Ränder und die Umschaltung auf 16-Bit-Arithmetik in fmt_u32
+	static const uint32_t edges[] = {
+		0, 1, 0xFFFF, 0x10000, 0x7FFFFFFFUL, 0x80000000UL, 0xFFFFFFFEUL, 0xFFFFFFFFUL,
+	};
+	for (uint8_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+		for (int8_t d = -1; d <= 1; d++) {
+			uint32_t v = edges[i] + (uint32_t)(int32_t)d;
+			check_u32(v);
+			check_i32((int32_t)v);
+			check_i32(-(int32_t)(v & 0x7FFFFFFFUL));
+		}
+	}
+
+	// Jede Zehnerpotenz und ihre Nachbarn (Übertrag beim Abziehen)
+	for (uint64_t p = 1; p <= 0xFFFFFFFFULL; p *= 10) {
+		for (int8_t d = -1; d <= 1; d++) {
+			uint32_t v = (uint32_t)(p + d);
+			check_u32(v);
+			check_u32(9 * (uint32_t)p + (uint32_t)(int32_t)d);
+			check_i32((int32_t)v);
+			check_i32(-(int32_t)(v & 0x7FFFFFFFUL));
+		}
+	}
+
+	// Pseudozufällige Werte über den ganzen Bereich
+	uint32_t x = 1;
+	for (uint32_t i = 0; i < 1000000UL; i++) {
+		x = x * 1664525UL + 1013904223UL;
+		check_u32(x);
+		check_i32((int32_t)x);
+	}
+
+	if (failures) {
+		fprintf(stderr, "test_fmt: %lu Abweichungen\n", failures);
+		return 1;
+	}
+	printf("test_fmt: ok\n");
+	return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * test_link.c
+ *
+ * Test des Rahmenprotokolls (link.c) im Host-Build
+ * Die Firmware sendet Rahmen über rs232.c, die Gegenseite (sim_serial.c)
+ * schreibt sie mit, und link_receive() liest sie wieder ein. Geprüft werden
+ * Nutzdaten und CRC nach dem Rückweg, Byte-Stuffing von 0x7E/0x7D, verworfene
+ * Rahmen (CRC falsch, länger als LINK_RX_MAX) und die Neusynchronisation am
+ * nächsten Flag. Rückgabe 0 = alle Prüfungen bestanden.
+ *
+ * Created: 18.10.2026 23:12:40
+ *  Author: morri
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+#include "sim.h"
+#include "link.h"
+#include "rs232.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+// Mitgeschriebene Bytes der Gegenseite
+static char*  wire;
+static size_t wire_len;
+static FILE*  wire_file;
+
+static void wire_reset(void) {
+	fflush(wire_file);
+	rewind(wire_file);
+}
+
+static const uint8_t* wire_bytes(size_t* len) {
+	fflush(wire_file);
+	*len = ftell(wire_file);
+	return (const uint8_t*)wire;
+}
+
+// Ergebnis des letzten gültigen Rahmens
+static uint8_t        rx_type;
+static uint8_t        rx_len;
+static uint8_t        rx_data[LINK_RX_MAX];
+static int            rx_frames;
+
+// Bytes an link_receive() geben, gültige Rahmen zählen
+static void feed(const uint8_t* data, size_t len) {
+	for (size_t i = 0; i < len; i++) {
+		uint8_t type, plen;
+		const uint8_t* payload;
+		if (link_receive(data[i], &type, &payload, &plen)) {
+			rx_type = type;
+			rx_len = plen;
+			memcpy(rx_data, payload, plen);
+			rx_frames++;
+		}
+	}
+}
+
+// Rahmen von Hand bauen, wie ihn der ESP8266 sendet (mit Stuffing, CRC wahlweise verfälscht)
+static size_t build(uint8_t* out, uint8_t type, const uint8_t* payload, uint8_t len, uint16_t crc_xor) {
+	uint8_t raw[260];
+	size_t n = 0, o = 0;
+	uint16_t crc = 0xFFFF;
+
+	raw[n++] = type;
+	raw[n++] = len;
+	memcpy(&raw[n], payload, len);
+	n += len;
+	for (size_t i = 0; i < n; i++) crc = _crc_ccitt_update(crc, raw[i]);
+	crc ^= crc_xor;
+	raw[n++] = (uint8_t)crc;
+	raw[n++] = (uint8_t)(crc >> 8);
+
+	out[o++] = LINK_FLAG;
+	for (size_t i = 0; i < n; i++) {
+		if (raw[i] == LINK_FLAG || raw[i] == LINK_ESC) {
+			out[o++] = LINK_ESC;
+			out[o++] = raw[i] ^ LINK_ESC_XOR;
+		} else {
+			out[o++] = raw[i];
+		}
+	}
+	return o;
+}
+
+// Senden und wieder empfangen: Werte mit 0x7E/0x7D in Nutzdaten und CRC
+static void test_round_trip(void) {
+	static const uint8_t expect[] = {
+		0x7E, 0x7D, 0x00,
+		0x34, 0x12,
+		0x7E, 0x7D,
+		0xFF, 0x7E, 0x7D, 0x20,
+	};
+	link_stats_t before, after;
+	link_get_stats(&before);
+
+	wire_reset();
+	link_begin(LINK_FRAME_CURRENT, sizeof(expect));
+	link_u8(0x7E);
+	link_u8(0x7D);
+	link_u8(0x00);
+	link_u16(0x1234);
+	link_i16((int16_t)0x7D7E);
+	link_u32(0x207D7EFFUL);
+	link_end();
+
+	size_t len;
+	const uint8_t* bytes = wire_bytes(&len);
+
+	// Auf der Leitung steht 0x7E nur als Rahmenanfang
+	CHECK(len > 0 && bytes[0] == LINK_FLAG);
+	for (size_t i = 1; i < len; i++) CHECK(bytes[i] != LINK_FLAG);
+
+	// Mit dem Empfänger vergleichen, der den Rahmen von Hand baut
+	uint8_t ref[64];
+	size_t ref_len = build(ref, LINK_FRAME_CURRENT, expect, sizeof(expect), 0);
+	CHECK(len == ref_len && memcmp(bytes, ref, len) == 0);
+
+	rx_frames = 0;
+	feed(bytes, len);
+	CHECK(rx_frames == 1);
+	CHECK(rx_type == LINK_FRAME_CURRENT);
+	CHECK(rx_len == sizeof(expect) && memcmp(rx_data, expect, sizeof(expect)) == 0);
+
+	link_get_stats(&after);
+	CHECK(after.frames_sent == before.frames_sent + 1);
+	CHECK(after.frames_received == before.frames_received + 1);
+}
+
+// CRC in beiden Bytes verfälscht: Rahmen verworfen, der nächste kommt an
+static void test_crc_error(void) {
+	static const uint8_t page[] = { 2 };
+	uint8_t buf[64];
+	link_stats_t before, after;
+
+	for (uint16_t bit = 0; bit < 16; bit++) {
+		link_get_stats(&before);
+		rx_frames = 0;
+		feed(buf, build(buf, LINK_FRAME_PAGE, page, sizeof(page), 1u << bit));
+		link_get_stats(&after);
+		CHECK(rx_frames == 0);
+		CHECK(after.crc_errors == before.crc_errors + 1);
+	}
+
+	// Nutzdaten verfälscht (CRC passt nicht mehr)
+	size_t n = build(buf, LINK_FRAME_PAGE, page, sizeof(page), 0);
+	buf[3] ^= 0x01;
+	link_get_stats(&before);
+	rx_frames = 0;
+	feed(buf, n);
+	link_get_stats(&after);
+	CHECK(rx_frames == 0);
+	CHECK(after.crc_errors == before.crc_errors + 1);
+
+	rx_frames = 0;
+	feed(buf, build(buf, LINK_FRAME_PAGE, page, sizeof(page), 0));
+	CHECK(rx_frames == 1 && rx_type == LINK_FRAME_PAGE && rx_len == 1 && rx_data[0] == 2);
+}
+
+// Längstmöglicher Rahmen passt, ein Byte mehr wird verworfen
+static void test_length(void) {
+	uint8_t payload[LINK_RX_MAX];
+	uint8_t buf[2 * LINK_RX_MAX + 16];
+	link_stats_t before, after;
+
+	for (uint8_t i = 0; i < sizeof(payload); i++) payload[i] = 0x7A + i;  // Mit 0x7D/0x7E
+
+	rx_frames = 0;
+	feed(buf, build(buf, LINK_FRAME_GET_SERIES, payload, LINK_RX_MAX - 4, 0));
+	CHECK(rx_frames == 1 && rx_len == LINK_RX_MAX - 4);
+	CHECK(memcmp(rx_data, payload, LINK_RX_MAX - 4) == 0);
+
+	for (uint16_t len = LINK_RX_MAX - 3; len <= LINK_RX_MAX; len++) {
+		link_get_stats(&before);
+		rx_frames = 0;
+		feed(buf, build(buf, LINK_FRAME_GET_SERIES, payload, (uint8_t)len, 0));
+		link_get_stats(&after);
+		CHECK(rx_frames == 0);
+		CHECK(after.crc_errors == before.crc_errors + 1);
+	}
+
+	// Längenfelder am oberen Ende (z.B. gestörte Leitung): Länge + 4 passt nicht
+	// in 8 Bit, trotzdem verwerfen und nicht über den Puffer hinaus schreiben
+	for (uint16_t len = 250; len <= 255; len++) {
+		uint8_t junk[300];
+		junk[0] = LINK_FLAG;
+		junk[1] = LINK_FRAME_PAGE;
+		junk[2] = (uint8_t)len;
+		memset(&junk[3], 0x55, sizeof(junk) - 3);
+		link_get_stats(&before);
+		rx_frames = 0;
+		feed(junk, 3);                          // Verworfen, sobald die Länge da ist
+		link_get_stats(&after);
+		CHECK(after.crc_errors == before.crc_errors + 1);
+		feed(&junk[3], sizeof(junk) - 3);       // Rest bis zum nächsten Flag ignoriert
+		CHECK(rx_frames == 0);
+	}
+
+	rx_frames = 0;
+	feed(buf, build(buf, LINK_FRAME_GET_CURRENT, payload, 0, 0));
+	CHECK(rx_frames == 1 && rx_type == LINK_FRAME_GET_CURRENT && rx_len == 0);
+}
+
+// Abgebrochener Rahmen: der nächste Flag beginnt neu
+static void test_resync(void) {
+	static const uint8_t page[] = { 1 };
+	uint8_t buf[64];
+	size_t n = build(buf, LINK_FRAME_PAGE, page, sizeof(page), 0);
+
+	rx_frames = 0;
+	feed(buf, n - 2);                           // CRC fehlt
+	feed((const uint8_t*)"\x55\x7D", 2);        // Rauschen, offenes Escape
+	feed(buf, n);
+	CHECK(rx_frames == 1 && rx_type == LINK_FRAME_PAGE && rx_data[0] == 1);
+
+	// Bytes vor dem ersten Flag werden ignoriert
+	rx_frames = 0;
+	feed((const uint8_t*)"\x10\x01\x01", 3);
+	CHECK(rx_frames == 0);
+}
+
+int main(void) {
+	wire_file = open_memstream(&wire, &wire_len);
+	if (!wire_file) {
+		perror("open_memstream");
+		return 2;
+	}
+	sim_serial_capture(wire_file);
+	rs232_init();
+	sei();
+
+	test_round_trip();
+	test_crc_error();
+	test_length();
+	test_resync();
+
+	if (failures) {
+		fprintf(stderr, "test_link: %d Fehler\n", failures);
+		return 1;
+	}
+	printf("test_link: ok\n");
+	return 0;
+}
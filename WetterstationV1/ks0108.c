@@ -9,55 +9,27 @@
  */ 
 //#define F_CPU 3686400UL
 
-#include <avr/io.h>
 #include <util/delay.h>
+#include "hal.h"
 #include "ks0108.h"
+#include "diag.h"
 
-// Pin-Definitionen für KS0108 LCD-Controller
-// Diese Pins steuern die Kommunikation mit dem Display
-#define LCD_DDR   DDRC    // Data Direction Register für LCD-Pins
-#define LCD_PORT  PORTC   // Port Register für LCD-Pins
-#define LCD_PIN   PINC    // Pin Register für LCD-Pins (zum Lesen)
+// Pins (Chip Select, Datenbus auf Port C/B, RST, RW, DI, E): hal.h
 
-// LCD-Steuerpins (Chip Select für linke und rechte Display-Hälfte)
-#define LCD_CS1   PC0     // Chip Select 1 (linke Hälfte)
-#define LCD_CS2   PC1     // Chip Select 2 (rechte Hälfte)
-
-// LCD-Datenpins (8-bit parallele Datenübertragung)
-#define LCD_D0    PC2     // Datenbit 0
-#define LCD_D1    PC3     // Datenbit 1
-#define LCD_D2    PC4     // Datenbit 2
-#define LCD_D3    PC5     // Datenbit 3
-#define LCD_D4    PC6     // Datenbit 4
-#define LCD_D5    PC7     // Datenbit 5
-#define LCD_D6    PB0     // Datenbit 6
-#define LCD_D7    PB1     // Datenbit 7
-
-// LCD-Steuerpins
-#define LCD_RST   PB6     // Reset-Pin (Display zurücksetzen)
-#define LCD_RW    PB7     // Read/Write-Pin (Lesen/Schreiben)
-#define LCD_DI    PD0     // Data/Instruction-Pin (Daten/Kommando)
-#define LCD_E     PD1     // Enable-Pin (Taktsignal)
-
-// Datenmasken für einfache Pin-Manipulation
-#define LCD_DATA_MASK_C   ((1 << LCD_D0) | (1 << LCD_D1) | (1 << LCD_D2) | (1 << LCD_D3) | (1 << LCD_D4) | (1 << LCD_D5))
-#define LCD_DATA_MASK_B   ((1 << LCD_D6) | (1 << LCD_D7))
+#if DIAG_ENABLE
+static lcd_stats_t stats;
+#endif
 
 // LCD-Initialisierung
 // Konfiguriert alle Pins und initialisiert das Display
 void lcd_init(void) {
-	// Alle LCD-Pins als Ausgänge konfigurieren
-	LCD_DDR |= (1 << LCD_CS1) | (1 << LCD_CS2) | LCD_DATA_MASK_C;  // Port C Pins
-	DDRB |= LCD_DATA_MASK_B | (1 << LCD_RST) | (1 << LCD_RW);      // Port B Pins
-	DDRD |= (1 << LCD_DI) | (1 << LCD_E);                          // Port D Pins
-	
-	// Reset-Pin initial auf High setzen
-	PORTB |= (1 << LCD_RST);
+	// Alle LCD-Pins als Ausgänge konfigurieren, Reset-Pin initial auf High setzen
+	hal_lcd_init();
 	
 	// Display zurücksetzen (Reset-Pulse)
-	PORTB &= ~(1 << LCD_RST);  // Reset auf Low
+	hal_lcd_reset(1);          // Reset auf Low
 	_delay_ms(1);              // 1ms warten
-	PORTB |= (1 << LCD_RST);   // Reset auf High
+	hal_lcd_reset(0);          // Reset auf High
 	_delay_ms(10);             // 10ms warten für Stabilisierung
 	
 	// Display-Konfiguration senden
@@ -74,62 +46,19 @@ void lcd_init(void) {
 // LCD-Chip Select aktivieren
 // Wählt die entsprechende Display-Hälfte aus
 void lcd_select_chip(uint8_t chip) {
-	if (chip == 0) {
-		// Linke Hälfte aktivieren
-		LCD_PORT &= ~(1 << LCD_CS1);  // CS1 auf Low
-		LCD_PORT |= (1 << LCD_CS2);   // CS2 auf High (inaktiv)
-	} else {
-		// Rechte Hälfte aktivieren
-		LCD_PORT |= (1 << LCD_CS1);   // CS1 auf High (inaktiv)
-		LCD_PORT &= ~(1 << LCD_CS2);  // CS2 auf Low
-	}
-}
-
-// LCD-Datenbus konfigurieren
-// Setzt die Datenpins auf die gewünschten Werte
-void lcd_set_data(uint8_t data) {
-	// Port C Datenbits (D0-D5) setzen
-	LCD_PORT = (LCD_PORT & ~LCD_DATA_MASK_C) | (data & LCD_DATA_MASK_C);
-	
-	// Port B Datenbits (D6-D7) setzen
-	PORTB = (PORTB & ~LCD_DATA_MASK_B) | ((data >> 6) & LCD_DATA_MASK_B);
-}
-
-// LCD-Datenbus lesen
-// Liest die aktuellen Werte der Datenpins
-uint8_t lcd_get_data(void) {
-	uint8_t data = 0;
-	
-	// Port C Datenbits (D0-D5) lesen
-	data = (LCD_PIN & LCD_DATA_MASK_C);
-	
-	// Port B Datenbits (D6-D7) lesen und kombinieren
-	data |= ((PINB & LCD_DATA_MASK_B) << 6);
-	
-	return data;
+	// CS1 bzw. CS2 auf Low, die andere Hälfte inaktiv
+	hal_lcd_select(chip == 0 ? HAL_LCD_LEFT : HAL_LCD_RIGHT);
 }
 
 // LCD-Kommando schreiben
 // Sendet ein Kommando an das Display
 void lcd_write_cmd(uint8_t cmd) {
 	// Beide Display-Hälften aktivieren (Kommando geht an beide)
-	LCD_PORT &= ~((1 << LCD_CS1) | (1 << LCD_CS2));
-	
-	// Datenbus als Ausgang konfigurieren
-	LCD_DDR |= LCD_DATA_MASK_C;
-	DDRB |= LCD_DATA_MASK_B;
+	hal_lcd_select(HAL_LCD_LEFT | HAL_LCD_RIGHT);
 	
-	// R/W auf Low (Schreiben), DI auf Low (Kommando)
-	PORTB &= ~(1 << LCD_RW);
-	PORTD &= ~(1 << LCD_DI);
-	
-	// Daten auf Bus setzen
-	lcd_set_data(cmd);
-	
-	// Enable-Puls (E auf High, dann Low)
-	PORTD |= (1 << LCD_E);
-	_delay_us(1);  // 1µs warten
-	PORTD &= ~(1 << LCD_E);
+	// R/W auf Low (Schreiben), DI auf Low (Kommando), Daten auf den Bus, Enable-Puls
+	hal_lcd_write(HAL_LCD_INSTR, cmd);
+	DIAG(stats.commands_sent++);
 	
 	// Warten bis Display bereit ist
 	_delay_us(100);
@@ -138,21 +67,9 @@ void lcd_write_cmd(uint8_t cmd) {
 // LCD-Daten schreiben
 // Sendet Daten an das Display
 void lcd_write_data(uint8_t data) {
-	// Datenbus als Ausgang konfigurieren
-	LCD_DDR |= LCD_DATA_MASK_C;
-	DDRB |= LCD_DATA_MASK_B;
-	
-	// R/W auf Low (Schreiben), DI auf High (Daten)
-	PORTB &= ~(1 << LCD_RW);
-	PORTD |= (1 << LCD_DI);
-	
-	// Daten auf Bus setzen
-	lcd_set_data(data);
-	
-	// Enable-Puls (E auf High, dann Low)
-	PORTD |= (1 << LCD_E);
-	_delay_us(1);  // 1µs warten
-	PORTD &= ~(1 << LCD_E);
+	// R/W auf Low (Schreiben), DI auf High (Daten), Daten auf den Bus, Enable-Puls
+	hal_lcd_write(HAL_LCD_DATA, data);
+	DIAG(stats.data_bytes_sent++);
 	
 	// Warten bis Display bereit ist
 	_delay_us(100);
@@ -161,23 +78,9 @@ void lcd_write_data(uint8_t data) {
 // LCD-Daten lesen
 // Liest Daten vom Display
 uint8_t lcd_read_data(void) {
-	uint8_t data;
-	
-	// Datenbus als Eingang konfigurieren
-	LCD_DDR &= ~LCD_DATA_MASK_C;
-	DDRB &= ~LCD_DATA_MASK_B;
-	
-	// R/W auf High (Lesen), DI auf High (Daten)
-	PORTB |= (1 << LCD_RW);
-	PORTD |= (1 << LCD_DI);
-	
-	// Enable-Puls (E auf High, dann Low)
-	PORTD |= (1 << LCD_E);
-	_delay_us(1);  // 1µs warten
-	PORTD &= ~(1 << LCD_E);
-	
-	// Daten vom Bus lesen
-	data = lcd_get_data();
+	// Datenbus als Eingang, R/W auf High (Lesen), DI auf High (Daten), Enable-Puls
+	uint8_t data = hal_lcd_read(HAL_LCD_DATA);
+	DIAG(stats.read_operations++);
 	
 	// Warten bis Display bereit ist
 	_delay_us(100);
@@ -188,23 +91,9 @@ uint8_t lcd_read_data(void) {
 // LCD-Status lesen
 // Prüft ob das Display bereit ist
 uint8_t lcd_read_status(void) {
-	uint8_t status;
-	
-	// Datenbus als Eingang konfigurieren
-	LCD_DDR &= ~LCD_DATA_MASK_C;
-	DDRB &= ~LCD_DATA_MASK_B;
-	
-	// R/W auf High (Lesen), DI auf Low (Status)
-	PORTB |= (1 << LCD_RW);
-	PORTD &= ~(1 << LCD_DI);
-	
-	// Enable-Puls (E auf High, dann Low)
-	PORTD |= (1 << LCD_E);
-	_delay_us(1);  // 1µs warten
-	PORTD &= ~(1 << LCD_E);
-	
-	// Status vom Bus lesen
-	status = lcd_get_data();
+	// Datenbus als Eingang, R/W auf High (Lesen), DI auf Low (Status), Enable-Puls
+	uint8_t status = hal_lcd_read(HAL_LCD_INSTR);
+	DIAG(stats.read_operations++);
 	
 	// Warten bis Display bereit ist
 	_delay_us(100);
@@ -235,6 +124,7 @@ void lcd_clear(void) {
 			lcd_write_data(0x00);
 		}
 	}
+	lcd_frame_done();
 }
 
 // LCD-Pixel setzen
@@ -288,3 +178,34 @@ void lcd_clear_pixel(uint8_t x, uint8_t y) {
 	// Neue Daten schreiben
 	lcd_write_data(data);
 }
+
+
+// Display für main.c einrichten
+void ks0108_init(void) {
+	lcd_init();
+}
+
+// Eine Display-Seite übertragen
+// Seite und Spalte 0 gehen als Kommando an beide Hälften, danach je 64 Datenbytes
+// (die Spaltenadresse erhöht sich im Controller selbst)
+void ks0108_write_page(uint8_t page, const uint8_t* buf) {
+	lcd_write_cmd(KS0108_CMD_SET_PAGE | page);
+	lcd_write_cmd(KS0108_CMD_SET_COLUMN);
+	for (uint8_t chip = KS0108_CHIP_LEFT; chip <= KS0108_CHIP_RIGHT; chip++) {
+		lcd_select_chip(chip);
+		for (uint8_t col = 0; col < KS0108_COLUMNS; col++) {
+			lcd_write_data(*buf++);
+		}
+	}
+}
+
+// LCD-Statistiken
+#if DIAG_ENABLE
+void lcd_get_stats(lcd_stats_t* s) {
+	*s = stats;
+}
+#endif
+
+void lcd_frame_done(void) {
+	DIAG(stats.frames++);
+}
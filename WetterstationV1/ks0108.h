@@ -91,101 +91,28 @@ void lcd_set_pixel(uint8_t x, uint8_t y);
 // Setzt einen Pixel an Position (x,y) auf weiß
 void lcd_clear_pixel(uint8_t x, uint8_t y);
 
-// Display-Seite setzen
-// Setzt die aktuelle Seitenadresse (0-7)
-void lcd_set_page(uint8_t page);
-
-// Display-Spalte setzen
-// Setzt die aktuelle Spaltenadresse (0-63 pro Chip)
-void lcd_set_column(uint8_t column);
-
-// Display-Startzeile setzen
-// Setzt die Startzeile für vertikales Scrolling (0-63)
-void lcd_set_start_line(uint8_t line);
-
-// Display ein-/ausschalten
-// Kontrolliert die Display-Anzeige
-void lcd_display_on(void);
-void lcd_display_off(void);
-
-// Display-Inversion ein-/ausschalten
-// Invertiert alle Pixel (schwarz/weiß tauschen)
-void lcd_invert_display(uint8_t invert);
-
-// Display-Kontrast einstellen
-// Passt den Kontrast des Displays an (falls unterstützt)
-void lcd_set_contrast(uint8_t contrast);
-
-// Display-Power-Management
-// Kontrolliert den Stromverbrauch des Displays
-void lcd_power_save(uint8_t enable);
-
-// Display-Reset durchführen
-// Führt einen Hardware-Reset des Displays durch
-void lcd_reset(void);
-
-// Display-Selbsttest
-// Führt einen Selbsttest des Displays durch
-uint8_t lcd_self_test(void);
-
-// Display-Informationen abrufen
-// Liest Informationen über das Display
-typedef struct {
-	uint8_t  controller_count;  // Anzahl der Controller (normalerweise 2)
-	uint8_t  width;             // Display-Breite in Pixeln
-	uint8_t  height;            // Display-Höhe in Pixeln
-	uint8_t  pages;             // Anzahl der Seiten
-	uint8_t  columns_per_chip;  // Spalten pro Controller
-	uint8_t  is_initialized;    // Initialisierungsstatus
-	uint8_t  is_on;             // Display-An/Aus-Status
-	uint8_t  is_inverted;       // Inversionsstatus
-} lcd_info_t;
-
-// Display-Informationen lesen
-// Liest aktuelle Display-Konfiguration
-void lcd_get_info(lcd_info_t* info);
-
-// Display-Statistiken
-// Gibt Informationen über Display-Nutzung zurück
+// Display-Statistiken (nur mit DIAG_ENABLE, diag.h)
+// Zähler seit dem Start
 typedef struct {
-	uint16_t pixels_set;        // Anzahl gesetzter Pixel
-	uint16_t pixels_cleared;    // Anzahl gelöschter Pixel
-	uint16_t commands_sent;     // Anzahl gesendeter Kommandos
-	uint16_t data_bytes_sent;   // Anzahl gesendeter Datenbytes
-	uint16_t read_operations;   // Anzahl Leseoperationen
-	uint16_t error_count;       // Anzahl aufgetretener Fehler
+	uint32_t data_bytes_sent;   // Gesendete Datenbytes
+	uint32_t commands_sent;     // Gesendete Kommandos (Seiten-/Spaltenadresse, Ein/Aus, ...)
+	uint16_t read_operations;   // Lesezugriffe (Daten und Status)
+	uint16_t frames;            // Vollständig übertragene Bilder (lcd_frame_done)
 } lcd_stats_t;
 
 // Display-Statistiken abrufen
-// Liest aktuelle Nutzungsstatistiken
 void lcd_get_stats(lcd_stats_t* stats);
 
-// Display-Statistiken zurücksetzen
-// Setzt alle Zähler zurück
-void lcd_reset_stats(void);
-
-// Display-Bereich löschen
-// Löscht einen rechteckigen Bereich des Displays
-void lcd_clear_area(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
-
-// Display-Bereich kopieren
-// Kopiert einen Bereich an eine andere Position
-void lcd_copy_area(uint8_t src_x, uint8_t src_y, uint8_t dest_x, uint8_t dest_y, 
-                   uint8_t width, uint8_t height);
-
-// Display-Scroll-Funktionen
-// Scrollt das Display in verschiedene Richtungen
-void lcd_scroll_up(uint8_t lines);
-void lcd_scroll_down(uint8_t lines);
-void lcd_scroll_left(uint8_t pixels);
-void lcd_scroll_right(uint8_t pixels);
-
-// Display-Frame-Buffer-Funktionen
-// Verwaltet einen lokalen Frame-Buffer für effiziente Updates
-void lcd_fb_init(void);
-void lcd_fb_clear(void);
-void lcd_fb_set_pixel(uint8_t x, uint8_t y);
-void lcd_fb_clear_pixel(uint8_t x, uint8_t y);
-void lcd_fb_update(void);
+// Ein vollständiges Bild ist übertragen (zählt nur, der Treiber kennt keine Bildgrenzen)
+void lcd_frame_done(void);
+
+// Schnittstelle für main.c (Bildaufbau seitenweise in display.c)
+
+// Display einrichten und löschen (wie lcd_init)
+void ks0108_init(void);
+
+// Eine Display-Seite (8 Pixelzeilen, KS0108_WIDTH Bytes) übertragen
+// Spalten 0-63 gehen an die linke, 64-127 an die rechte Hälfte
+void ks0108_write_page(uint8_t page, const uint8_t* buf);
 
 #endif /* KS0108_H_ */
@@ -0,0 +1,180 @@
+/*
+ * link.c
+ *
+ * Binäres Rahmenprotokoll zum ESP8266
+ * Die Rahmen werden beim Senden in den Sendepuffer des rs232-Treibers
+ * geschrieben, die CRC läuft dabei mit. Mit link_room() kann der Aufrufer
+ * vorher prüfen, ob der Rahmen ohne Warten hineinpasst. Beim Empfang reicht ein
+ * kleiner Puffer, da der ESP8266 nur kurze Befehle schickt.
+ *
+ * Created: 18.10.2026 13:41:52
+ *  Author: morri
+ */
+
+#include <avr/io.h>
+#include <util/crc16.h>
+#include "link.h"
+#include "rs232.h"
+#include "timebase.h"
+#include "ram.h"
+#include "trace.h"
+
+// Sendezustand
+static uint16_t tx_crc;  // Laufende CRC des aktuellen Rahmens
+
+// Empfangszustand
+static uint8_t rx_buf[LINK_RX_MAX];  // Typ, Länge, Nutzdaten, CRC
+static uint8_t rx_pos;               // Anzahl empfangener Bytes im Rahmen
+static uint8_t rx_active;            // 1 = Flag empfangen, Rahmen läuft
+static uint8_t rx_escaped;           // 1 = vorheriges Byte war LINK_ESC
+
+// Messung
+static uint16_t meas_bytes;          // rs232-Bytezähler bei Paketbeginn
+static uint32_t meas_counts;         // Timer1-Schritte bei Paketbeginn (timebase_counts)
+
+static link_stats_t stats;
+
+RAM_ACCOUNT(link, sizeof(tx_crc) + sizeof(rx_buf) + sizeof(rx_pos) + sizeof(rx_active) + sizeof(rx_escaped)
+                  + sizeof(meas_bytes) + sizeof(meas_counts) + sizeof(stats));
+
+// Ein Byte mit Stuffing senden und in die CRC aufnehmen
+static void link_put(uint8_t c) {
+	tx_crc = _crc_ccitt_update(tx_crc, c);
+	if (c == LINK_FLAG || c == LINK_ESC) {
+		rs232_putchar(LINK_ESC);
+		c ^= LINK_ESC_XOR;
+	}
+	rs232_putchar(c);
+}
+
+// Ein Byte senden, ohne es in die CRC aufzunehmen (nur für die CRC selbst)
+static void link_put_raw(uint8_t c) {
+	if (c == LINK_FLAG || c == LINK_ESC) {
+		rs232_putchar(LINK_ESC);
+		c ^= LINK_ESC_XOR;
+	}
+	rs232_putchar(c);
+}
+
+// Rahmen beginnen
+void link_begin(uint8_t type, uint8_t len) {
+	rs232_putchar(LINK_FLAG);  // Rahmenanfang (nie maskiert)
+	tx_crc = 0xFFFF;           // CRC-16/CCITT, Startwert 0xFFFF
+	link_put(type);
+	link_put(len);
+}
+
+// Nutzdaten senden
+void link_u8(uint8_t value) {
+	link_put(value);
+}
+
+void link_u16(uint16_t value) {
+	link_put((uint8_t)value);         // Low-Byte zuerst
+	link_put((uint8_t)(value >> 8));  // High-Byte
+}
+
+void link_i16(int16_t value) {
+	link_u16((uint16_t)value);
+}
+
+void link_u32(uint32_t value) {
+	link_u16((uint16_t)value);          // Low-Wort zuerst
+	link_u16((uint16_t)(value >> 16));  // High-Wort
+}
+
+// Rahmen abschließen
+void link_end(void) {
+	uint16_t crc = tx_crc;
+	link_put_raw((uint8_t)crc);         // CRC Low-Byte
+	link_put_raw((uint8_t)(crc >> 8));  // CRC High-Byte
+	stats.frames_sent++;
+}
+
+// Prüfen ob ein Rahmen ohne Warten in den Sendepuffer passt
+// Flag + (Typ, Länge, Nutzdaten, CRC) im ungünstigsten Fall alle maskiert
+uint8_t link_room(uint8_t len) {
+	return rs232_tx_free() >= 1 + 2 * (uint16_t)(len + 4);
+}
+
+// Ein empfangenes Byte verarbeiten
+uint8_t link_receive(uint8_t c, uint8_t* type, const uint8_t** payload, uint8_t* len) {
+	// Rahmenanfang: immer neu synchronisieren
+	if (c == LINK_FLAG) {
+		rx_active  = 1;
+		rx_pos     = 0;
+		rx_escaped = 0;
+		return 0;
+	}
+	if (!rx_active) return 0;  // Bytes außerhalb eines Rahmens ignorieren
+
+	// Byte-Stuffing rückgängig machen
+	if (c == LINK_ESC) {
+		rx_escaped = 1;
+		return 0;
+	}
+	if (rx_escaped) {
+		c ^= LINK_ESC_XOR;
+		rx_escaped = 0;
+	}
+
+	rx_buf[rx_pos++] = c;
+
+	// Länge prüfen, sobald sie bekannt ist
+	// (Längenfeld selbst vergleichen: Länge + 4 läuft ab 252 in 8 Bit über)
+	if (rx_pos >= 2) {
+		uint8_t total = rx_buf[1] + 4;  // Typ + Länge + Nutzdaten + 2 Bytes CRC
+		if (rx_buf[1] > LINK_RX_MAX - 4) {
+			rx_active = 0;  // Zu lang für den Puffer: verwerfen
+			stats.crc_errors++;
+			TRACE(TRACE_CRC_ERROR, rx_buf[0], rx_buf[1]);
+			return 0;
+		}
+		if (rx_pos == total) {
+			rx_active = 0;  // Rahmen vollständig
+
+			// CRC über Typ, Länge und Nutzdaten prüfen
+			uint16_t crc = 0xFFFF;
+			for (uint8_t i = 0; i < total - 2; i++) {
+				crc = _crc_ccitt_update(crc, rx_buf[i]);
+			}
+			if (crc != (rx_buf[total - 2] | ((uint16_t)rx_buf[total - 1] << 8))) {
+				stats.crc_errors++;
+				TRACE(TRACE_CRC_ERROR, rx_buf[0], rx_buf[1]);
+				return 0;
+			}
+
+			*type    = rx_buf[0];
+			*len     = rx_buf[1];
+			*payload = &rx_buf[2];
+			stats.frames_received++;
+			TRACE(TRACE_RX_FRAME, rx_buf[0], rx_buf[1]);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Messung eines Datenpakets starten
+void link_measure_begin(void) {
+	rs232_status_t st;
+	rs232_get_status(&st);
+	meas_bytes = st.bytes_sent;
+	meas_counts = timebase_counts();
+}
+
+// Messung eines Datenpakets beenden
+void link_measure_end(void) {
+	rs232_status_t st;
+	rs232_get_status(&st);
+	uint32_t counts = TIME_ELAPSED(timebase_counts(), meas_counts);  // 3600 Schritte pro Sekunde
+
+	stats.packet_bytes = st.bytes_sent - meas_bytes;
+	stats.packet_ms    = TIMEBASE_COUNTS_TO_MS(counts);
+	if (stats.packet_ms > stats.packet_ms_max) stats.packet_ms_max = stats.packet_ms;
+}
+
+// Link-Statistiken abrufen
+void link_get_stats(link_stats_t* out) {
+	*out = stats;
+}
@@ -0,0 +1,141 @@
+/*
+ * link.h
+ *
+ * Header-Datei für das binäre Rahmenprotokoll zum ESP8266
+ * Rahmenaufbau: 0x7E | Typ | Länge | Nutzdaten (Little Endian) | CRC-16 (LSB zuerst)
+ * Typ bis CRC werden mit Byte-Stuffing übertragen (0x7E/0x7D -> 0x7D, Byte ^ 0x20),
+ * damit der Empfänger sich an jedem 0x7E neu synchronisieren kann
+ *
+ * Created: 18.10.2026 13:41:52
+ *  Author: morri
+ */
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#include <stdint.h>
+#include "rs232.h"
+
+// Protokollwahl (zur Compile-Zeit)
+// 1 = binäre Rahmen, 0 = bisheriges Textformat (d:X:...;  s:...;)
+#ifndef LINK_BINARY
+#define LINK_BINARY        1
+#endif
+
+// Bulk-Export der Ringpuffer (GET_CHUNK/CHUNK) und komprimiert (GET_PACKED/PACKED, pack.h)
+// Standard aus (Flash-Budget des ATmega8), z.B. -DLINK_BULK=1 -DLINK_PACK=1
+// Ohne die Schalter bleiben die Abfragen unbeantwortet (SYNC_ENABLE im Sketch)
+#ifndef LINK_BULK
+#define LINK_BULK          0
+#endif
+#ifndef LINK_PACK
+#define LINK_PACK          0
+#endif
+#if LINK_BULK && !LINK_BINARY
+#error "LINK_BULK braucht LINK_BINARY"
+#endif
+#if LINK_PACK && !LINK_BULK
+#error "LINK_PACK braucht LINK_BULK"
+#endif
+
+// Steuerzeichen
+#define LINK_FLAG          0x7E  // Rahmenanfang
+#define LINK_ESC           0x7D  // Escape-Zeichen
+#define LINK_ESC_XOR       0x20  // Maske für maskierte Bytes
+
+// Maximale Rahmengröße beim Empfang (Typ + Länge + Nutzdaten + CRC)
+// Der ESP8266 sendet nur kurze Befehle
+#define LINK_RX_MAX        16
+
+// Rahmentypen ATmega8 -> ESP8266
+#define LINK_FRAME_CURRENT  0x01  // Angezeigte Seite (u8), Temperatur (i16), Druck (u16), Feuchte (u16)
+#define LINK_FRAME_STATUS   0x02  // Zähler (u16) in der Reihenfolge des Textformats s:, dann Anfragen an den
+                                  // Messwert-Cache und davon eingesparte Sensor-Abfragen (u32)
+#define LINK_FRAME_SERIES   0x03  // Antwort auf GET_SERIES: Series (u8), Seq (u16), ab Alter (u8),
+                                  // Anzahl (u8), Werte (i16), neuester zuerst
+#define LINK_FRAME_APPEND   0x04  // Gesichert (linkseq.h): LinkSeq (u8), Series (u8), Seq (u16), neuer Wert (i16)
+#define LINK_FRAME_CHUNK    0x08  // Antwort auf GET_CHUNK: Bereich (u8), Offset (u16), Seq (u16),
+                                  // Head (u8), Rohbytes aus dem EEPROM
+#define LINK_FRAME_PACKED   0x09  // Antwort auf GET_PACKED: Bereich (u8), erster Datensatz (u8),
+                                  // Seq (u16), Head (u8), Anzahl (u8), kodierte Datensätze (pack.h)
+#define LINK_FRAME_LINK_STATUS 0x0A  // Verlustzähler (u16): CRC-Fehler, RX-Überläufe, RX-Fehler,
+                                     // gesicherte Rahmen, Wiederholungen, Timeouts, Neuabgleiche,
+                                     // Bytes und Dauer (ms) des letzten Datenpakets, Warten auf den
+                                     // Sendepuffer, Baudraten-Stufe
+#define LINK_FRAME_TASK_STATUS 0x0B  // Laufzeitbericht (sched.h): Aufgabe (u8), Anzahl Aufgaben (u8),
+                                     // Aufrufe, längste Laufzeit (1/3600 s), größte Verspätung (Ticks),
+                                     // Deadline-Überschreitungen (u16), Idle-Anteil % (u8),
+                                     // verlorene Ereignisse (u16)
+#define LINK_FRAME_INPUT_STATUS 0x0C  // Taster (u16): Drücke, lange Drücke, Wiederholungen, verworfen,
+                                      // Latenz bis zum neuen Bild (ms) zuletzt und maximal, über der Schranke
+#define LINK_FRAME_PROFILE     0x0D  // Antwort auf GET_PROFILE (profile.h), ein Rahmen je Messpunkt:
+                                     // Messpunkt (u8), Anzahl Messpunkte (u8), Messungen (u16),
+                                     // CPU-Takte Minimum, Maximum, Mittelwert (u32)
+#define LINK_FRAME_DRIVER_STATUS 0x0E  // Treiber-Statistik, reihum ein Treiber je Rahmen: Treiber (u8), Anzahl (u8), dann
+                                       // 0 EEPROM: gelesen, geschrieben (Bytes), WIP-Wartezeit (1/3600 s) (u32),
+                                       //   längste Wartezeit (1/3600 s), Datensätze je Bereich 24h/7d/Roh (u16)
+                                       // 1 LCD: Datenbytes, Kommandos (u32), Lesezugriffe, Bilder (u16)
+                                       // 2 UART: gesendet, empfangen, RX-Überläufe, RX-Fehler, TX abgewiesen,
+                                       //   TX gewartet (u16), höchster Füllstand des Sendepuffers (u8)
+#define LINK_FRAME_RAM_STATUS  0x0F  // RAM (ram.h, Bytes): .data, .bss, größte Stacktiefe, kleinste Reserve (u16),
+                                     // reihum ein Modul: Modul (u8), Anzahl Module (u8), statischer RAM (u16)
+#define LINK_FRAME_TRACE       0x20  // Ablaufprotokoll (trace.h): Sendezeitpunkt (u32, 1/3600 s), dann je Eintrag
+                                     // Ereignis (u8), Zeitpunkt (untere 16 Bit, u16), Argumente (2 x u8)
+
+// Rahmentypen ESP8266 -> ATmega8
+#define LINK_FRAME_PAGE        0x10  // Seitenwechsel am Display: Seite (u8)
+#define LINK_FRAME_GET_SERIES  0x11  // Verlauf abfragen: Series (u8), ab Alter (u8), Anzahl (u8)
+#define LINK_FRAME_GET_CURRENT 0x16  // Aktuelle Werte abfragen (Antwort: LINK_FRAME_CURRENT)
+#define LINK_FRAME_GET_CHUNK   0x17  // Bulk-Export: Bereich (u8), Offset (u16), Länge (u8)
+#define LINK_FRAME_GET_PACKED  0x18  // Bulk-Export komprimiert: Bereich (u8), erster Datensatz (u8), Anzahl (u8)
+#define LINK_FRAME_GET_PROFILE 0x1A  // Laufzeitbericht abfragen, optional: 1 = danach zurücksetzen (u8)
+                                     // (nur mit PROFILE_ENABLE, sonst keine Antwort)
+
+// Größte Länge eines Bulk-Abschnitts (Rohbytes je CHUNK-Rahmen)
+#define LINK_CHUNK_MAX      32
+// Größte Anzahl Datensätze je PACKED-Rahmen (6 + 16 * PACK_MAX_RECORD = 246 <= 255 Bytes Nutzdaten)
+#define LINK_PACK_MAX       16
+
+// Link-Statistiken
+// Bytes und Dauer werden für jedes Datenpaket gemessen (auch im Textformat)
+typedef struct {
+	uint16_t frames_sent;      // Gesendete Rahmen
+	uint16_t frames_received;  // Empfangene gültige Rahmen
+	uint16_t crc_errors;       // Verworfene Rahmen (CRC oder Länge falsch)
+	uint16_t packet_bytes;     // Bytes des letzten Datenpakets (inkl. Stuffing)
+	uint16_t packet_ms;        // Sendedauer des letzten Datenpakets (ms)
+	uint16_t packet_ms_max;    // Längste Sendedauer eines Datenpakets (ms)
+} link_stats_t;
+
+// Rahmen beginnen: Flag, Typ und Länge senden
+// Die Nutzdaten folgen mit link_u8/link_u16/link_i16/link_u32, danach link_end()
+void link_begin(uint8_t type, uint8_t len);
+
+// Nutzdaten senden (Little Endian)
+void link_u8(uint8_t value);
+void link_u16(uint16_t value);
+void link_i16(int16_t value);
+void link_u32(uint32_t value);
+
+// Rahmen abschließen (CRC senden)
+void link_end(void);
+
+// Prüfen ob ein Rahmen mit len Bytes Nutzdaten ohne Warten in den Sendepuffer passt
+// (rechnet mit Byte-Stuffing im ungünstigsten Fall)
+uint8_t link_room(uint8_t len);
+
+// Maximale Nutzdatenlänge, für die link_room() jemals 1 liefern kann
+#define LINK_TX_MAX_PAYLOAD  ((RS232_TX_BUFFER_SIZE - 2) / 2 - 4)
+
+// Ein empfangenes Byte verarbeiten
+// Rückgabe: 1 = vollständiger gültiger Rahmen, Typ/Nutzdaten/Länge sind gesetzt
+uint8_t link_receive(uint8_t c, uint8_t* type, const uint8_t** payload, uint8_t* len);
+
+// Messung eines Datenpakets starten/beenden (Bytes und Dauer)
+void link_measure_begin(void);
+void link_measure_end(void);
+
+// Link-Statistiken abrufen
+void link_get_stats(link_stats_t* stats);
+
+#endif /* LINK_H_ */
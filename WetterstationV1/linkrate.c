@@ -0,0 +1,129 @@
+/*
+ * linkrate.c
+ *
+ * Aushandlung der Baudrate mit dem ESP8266
+ * Ablauf (vom ESP8266 gesteuert):
+ *   QUERY  -> CAPS        Fähigkeiten und aktuelle Stufe
+ *   SET n  -> ACK n       ACK geht mit der alten Rate raus, dann wird umgeschaltet
+ *   PROBE  -> PROBE_ECHO  mit der neuen Rate, der ESP8266 vergleicht das Echo
+ *   COMMIT                Rate gilt; ohne COMMIT nach LINK_RATE_PROBE_S zurück auf Stufe 0
+ * Antworten werden nur vorgemerkt und von linkrate_pump() gesendet, damit sie
+ * keinen halb gesendeten Rahmen (Verlaufs-Antwort) unterbrechen.
+ *
+ * Created: 18.10.2026 15:02:37
+ *  Author: morri
+ */
+
+#include <string.h>
+#include "linkrate.h"
+#include "link.h"
+#include "rs232.h"
+#include "timebase.h"
+#include "trace.h"
+
+#if LINK_RATE
+
+// Vorgemerkte Antworten
+#define REPLY_CAPS    0x01
+#define REPLY_ACK     0x02
+#define REPLY_ECHO    0x04
+#define REPLY_REVERT  0x08  // Kein Rahmen, sondern Rückfall auf Stufe 0
+
+static uint8_t  reply;                   // Vorgemerkte Antworten (REPLY_*)
+static uint8_t  target;                  // Angeforderte Stufe
+static uint8_t  probing;                 // 1 = umgeschaltet, COMMIT steht noch aus
+static uint32_t deadline_s;              // Ende der Probe-Phase
+static uint32_t last_rx_s;               // Letzter gültiger Rahmen vom ESP8266
+static uint8_t  probe[LINK_PROBE_LEN];   // Testmuster für das Echo
+
+static linkrate_stats_t stats;
+
+// Einen empfangenen Rahmen auswerten
+uint8_t linkrate_receive(uint8_t type, const uint8_t* payload, uint8_t len, uint32_t now_s) {
+	last_rx_s = now_s;  // Gegenstelle lebt
+
+	switch (type) {
+	case LINK_FRAME_RATE_QUERY:
+		reply |= REPLY_CAPS;
+		return 1;
+
+	case LINK_FRAME_RATE_SET:
+		if (len == 1 && payload[0] < RS232_RATE_COUNT) {
+			target = payload[0];
+			reply |= REPLY_ACK;
+		}
+		return 1;
+
+	case LINK_FRAME_PROBE:
+		// Die CRC hat link_receive() schon geprüft, das Echo beweist die Gegenrichtung
+		if (probing && len == LINK_PROBE_LEN) {
+			memcpy(probe, payload, LINK_PROBE_LEN);
+			reply |= REPLY_ECHO;
+		}
+		return 1;
+
+	case LINK_FRAME_RATE_COMMIT:
+		if (probing) {
+			probing = 0;
+			stats.switches++;
+		}
+		return 1;
+	}
+	return 0;
+}
+
+// Antworten senden, umschalten und Zeitgrenzen prüfen
+uint8_t linkrate_pump(uint32_t now_s) {
+	// Zeitgrenzen: kein COMMIT oder lange nichts vom ESP8266 gehört
+	if (rs232_get_rate() != 0) {
+		if ((probing && TIME_REACHED(now_s, deadline_s))
+		 || (!probing && TIME_ELAPSED(now_s, last_rx_s) >= LINK_RATE_IDLE_S)) {
+			reply |= REPLY_REVERT;
+		}
+	}
+
+	if (reply & REPLY_REVERT) {
+		rs232_set_rate(0);
+		TRACE(TRACE_RATE, 0, 1);
+		probing = 0;
+		stats.fallbacks++;
+		reply &= ~REPLY_REVERT;
+	}
+
+	if ((reply & REPLY_CAPS) && link_room(2)) {
+		link_begin(LINK_FRAME_RATE_CAPS, 2);
+		link_u8((1 << RS232_RATE_COUNT) - 1);  // Alle Stufen möglich
+		link_u8(rs232_get_rate());
+		link_end();
+		reply &= ~REPLY_CAPS;
+	}
+
+	if ((reply & REPLY_ACK) && link_room(1)) {
+		link_begin(LINK_FRAME_RATE_ACK, 1);
+		link_u8(target);
+		link_end();
+		rs232_set_rate(target);  // Wartet bis das ACK mit der alten Rate gesendet ist
+		TRACE(TRACE_RATE, target, 0);
+		probing    = 1;
+		deadline_s = now_s + LINK_RATE_PROBE_S;
+		last_rx_s  = now_s;
+		reply &= ~REPLY_ACK;
+	}
+
+	if ((reply & REPLY_ECHO) && link_room(LINK_PROBE_LEN)) {
+		link_begin(LINK_FRAME_PROBE_ECHO, LINK_PROBE_LEN);
+		for (uint8_t i = 0; i < LINK_PROBE_LEN; i++) link_u8(probe[i]);
+		link_end();
+		reply &= ~REPLY_ECHO;
+	}
+
+	stats.rate = rs232_get_rate();
+	return reply != 0;
+}
+
+// Statistik abrufen
+void linkrate_get_stats(linkrate_stats_t* out) {
+	*out = stats;
+}
+
+#endif
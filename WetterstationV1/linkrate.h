@@ -0,0 +1,76 @@
+/*
+ * linkrate.h
+ *
+ * Header-Datei für die Aushandlung der Baudrate mit dem ESP8266
+ * Beide Seiten starten mit RS232_BAUDRATE. Der ESP8266 fragt die möglichen
+ * Raten ab, fordert eine Rate an und prüft sie mit einem Probe-Rahmen
+ * (CRC-gesichert, wird zurückgesendet). Erst nach COMMIT gilt die neue Rate,
+ * sonst fallen beide Seiten nach einem Timeout auf die Startrate zurück.
+ *
+ * Created: 18.10.2026 15:02:37
+ *  Author: morri
+ */
+
+#ifndef LINKRATE_H_
+#define LINKRATE_H_
+
+#include <stdint.h>
+#include "link.h"
+
+// Aushandlung ein-/ausschalten (zur Compile-Zeit, z.B. -DLINK_RATE=1, nur im Binärformat)
+// Standard aus (Flash-Budget des ATmega8): die Verbindung bleibt bei RS232_BAUDRATE
+#ifndef LINK_RATE
+#define LINK_RATE          0
+#endif
+#if LINK_RATE && !LINK_BINARY
+#error "LINK_RATE braucht LINK_BINARY"
+#endif
+
+// Rahmentypen ATmega8 -> ESP8266
+#define LINK_FRAME_RATE_CAPS   0x05  // Mögliche Stufen (u8 Bitmaske), aktuelle Stufe (u8)
+#define LINK_FRAME_RATE_ACK    0x06  // Neue Stufe (u8), danach wird umgeschaltet
+#define LINK_FRAME_PROBE_ECHO  0x07  // Nutzdaten des Probe-Rahmens unverändert zurück
+
+// Rahmentypen ESP8266 -> ATmega8
+#define LINK_FRAME_RATE_QUERY  0x12  // Fähigkeiten abfragen (auch als Lebenszeichen alle 10 s)
+#define LINK_FRAME_RATE_SET    0x13  // Stufe anfordern (u8)
+#define LINK_FRAME_PROBE       0x14  // Testmuster (LINK_PROBE_LEN Bytes) mit der neuen Rate
+#define LINK_FRAME_RATE_COMMIT 0x15  // Probe war erfolgreich, Rate behalten
+
+#define LINK_PROBE_LEN         8     // Länge des Testmusters
+
+// Zeitgrenzen
+#define LINK_RATE_PROBE_S      2     // Wartezeit auf PROBE/COMMIT nach dem Umschalten (s)
+#define LINK_RATE_IDLE_S       30    // Ohne gültigen Rahmen vom ESP8266 zurück auf die Startrate (s)
+
+// Statistik der Aushandlung
+typedef struct {
+	uint8_t  rate;       // Aktuelle Stufe (0 = RS232_BAUDRATE)
+	uint16_t switches;   // Bestätigte Umschaltungen
+	uint16_t fallbacks;  // Rückfälle auf die Startrate (Timeout)
+} linkrate_stats_t;
+
+#if LINK_RATE
+
+// Einen empfangenen Rahmen auswerten
+// Rückgabe: 1 = Rahmen gehörte zur Aushandlung
+// Jeder gültige Rahmen zählt als Lebenszeichen der Gegenstelle
+uint8_t linkrate_receive(uint8_t type, const uint8_t* payload, uint8_t len, uint32_t now_s);
+
+// Antworten senden, umschalten und Zeitgrenzen prüfen
+// Nur aufrufen, wenn kein anderer Rahmen halb gesendet ist
+// Rückgabe: 1 = es steht noch eine Antwort aus
+uint8_t linkrate_pump(uint32_t now_s);
+
+// Statistik abrufen
+void linkrate_get_stats(linkrate_stats_t* stats);
+
+#else
+
+// RATE_QUERY und die übrigen Rahmen der Aushandlung bleiben unbeantwortet
+#define linkrate_receive(type, payload, len, now_s)  0
+#define linkrate_pump(now_s)                         0
+
+#endif
+
+#endif /* LINKRATE_H_ */
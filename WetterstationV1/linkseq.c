@@ -0,0 +1,107 @@
+/*
+ * linkseq.c
+ *
+ * Gesicherte Zustellung von Rahmen an den ESP8266 (Go-Back-N)
+ * Das Fenster ist ein Ring aus LINKSEQ_WINDOW Beschreibungen, der älteste
+ * unbestätigte Rahmen hat die Nummer base_seq. Eine Bestätigung außerhalb des
+ * Fensters bedeutet, dass eine Seite neu gestartet ist: dann werden die offenen
+ * Rahmen ab ACK + 1 neu nummeriert und sofort wiederholt.
+ *
+ * Created: 18.10.2026 16:10:52
+ *  Author: morri
+ */
+
+#include "linkseq.h"
+#include "timebase.h"
+#include "ram.h"
+#include "trace.h"
+
+// Beschreibung eines unbestätigten Rahmens
+typedef struct {
+	uint8_t  tag;
+	uint16_t arg;
+} linkseq_slot_t;
+
+static linkseq_slot_t slots[LINKSEQ_WINDOW];
+static uint8_t  head;        // Index des ältesten Eintrags im Ring
+static uint8_t  count;       // Unbestätigte Rahmen
+static uint8_t  base_seq;    // LinkSeq des ältesten unbestätigten Rahmens
+static uint8_t  going_back;  // 1 = Wiederholung läuft
+static uint8_t  resent;      // Bereits wiederholte Rahmen (ab dem ältesten)
+static uint32_t sent_s;      // Start der Wartezeit auf eine Bestätigung
+
+static linkseq_stats_t stats;
+
+RAM_ACCOUNT(linkseq, sizeof(slots) + sizeof(head) + sizeof(count) + sizeof(base_seq)
+                     + sizeof(going_back) + sizeof(resent) + sizeof(sent_s) + sizeof(stats));
+
+// Prüfen ob ein neuer gesicherter Rahmen gesendet werden darf
+uint8_t linkseq_space(void) {
+	return !going_back && count < LINKSEQ_WINDOW;
+}
+
+// Neuen gesicherten Rahmen ins Fenster aufnehmen
+uint8_t linkseq_push(uint8_t tag, uint16_t arg, uint32_t now_s) {
+	linkseq_slot_t* s = &slots[(head + count) & (LINKSEQ_WINDOW - 1)];
+	s->tag = tag;
+	s->arg = arg;
+	if (!count) sent_s = now_s;  // Wartezeit läuft ab dem ersten offenen Rahmen
+	stats.frames++;
+	return base_seq + count++;
+}
+
+// Prüfen ob ein Rahmen wiederholt werden muss
+uint8_t linkseq_resend_due(uint32_t now_s) {
+	if (count && !going_back && TIME_ELAPSED(now_s, sent_s) >= LINKSEQ_TIMEOUT_S) {
+		stats.timeouts++;
+		going_back = 1;
+		resent = 0;
+	}
+	return going_back;
+}
+
+// Nächsten zu wiederholenden Rahmen abholen
+void linkseq_resend(uint8_t* seq, uint8_t* tag, uint16_t* arg, uint32_t now_s) {
+	const linkseq_slot_t* s = &slots[(head + resent) & (LINKSEQ_WINDOW - 1)];
+	*seq = base_seq + resent;
+	*tag = s->tag;
+	*arg = s->arg;
+	stats.retransmits++;
+	TRACE(TRACE_RESEND, *seq, *tag);
+	if (++resent >= count) {
+		going_back = 0;  // Alle offenen Rahmen wiederholt, neue Wartezeit
+		sent_s = now_s;
+	}
+}
+
+// Einen empfangenen Rahmen auswerten
+uint8_t linkseq_receive(uint8_t type, const uint8_t* payload, uint8_t len, uint32_t now_s) {
+	if (type != LINK_FRAME_ACK) return 0;
+	if (len != 1) return 1;
+
+	uint8_t acked = (uint8_t)(payload[0] - base_seq + 1);  // Neu bestätigte Rahmen
+	if (acked == 0) {
+		// Keine neue Bestätigung (Duplikat oder Lücke beim ESP8266), Timeout läuft weiter
+	} else if (acked <= count) {
+		head   = (head + acked) & (LINKSEQ_WINDOW - 1);
+		count -= acked;
+		base_seq += acked;
+		resent = (resent > acked) ? resent - acked : 0;
+		if (!count) going_back = 0;
+		sent_s = now_s;
+	} else {
+		// Bestätigung außerhalb des Fensters: eine Seite ist neu gestartet
+		base_seq = payload[0] + 1;
+		stats.resyncs++;
+		if (count) {
+			going_back = 1;
+			resent = 0;
+		}
+	}
+	return 1;
+}
+
+// Statistik abrufen
+void linkseq_get_stats(linkseq_stats_t* out) {
+	*out = stats;
+}
@@ -0,0 +1,60 @@
+/*
+ * linkseq.h
+ *
+ * Header-Datei für die gesicherte Zustellung von Rahmen an den ESP8266
+ * Gesicherte Rahmen tragen eine laufende Nummer (LinkSeq, u8) als erstes
+ * Nutzdatenbyte. Der ESP8266 bestätigt kumulativ (ACK = letzte lückenlos
+ * empfangene Nummer), verwirft Duplikate und Rahmen hinter einer Lücke.
+ * Fehlt die Bestätigung, werden alle offenen Rahmen ab dem ältesten
+ * wiederholt (Go-Back-N).
+ *
+ * Statt der Rahmenbytes merkt sich das Fenster nur eine kurze Beschreibung
+ * (tag, arg), aus der der Aufrufer den Rahmen neu erzeugt (z.B. Verlauf und
+ * Punktnummer eines APPEND, der Wert steht im EEPROM).
+ *
+ * Created: 18.10.2026 16:10:52
+ *  Author: morri
+ */
+
+#ifndef LINKSEQ_H_
+#define LINKSEQ_H_
+
+#include <stdint.h>
+
+// Rahmentyp ESP8266 -> ATmega8
+#define LINK_FRAME_ACK         0x19  // Kumulative Bestätigung: letzte lückenlos empfangene LinkSeq (u8)
+
+#define LINKSEQ_WINDOW         4     // Unbestätigte Rahmen (Zweierpotenz)
+#define LINKSEQ_TIMEOUT_S      2     // Ohne Fortschritt der Bestätigung wird wiederholt (s)
+
+// Statistik der gesicherten Zustellung
+typedef struct {
+	uint16_t frames;       // Gesicherte Rahmen (erstmals gesendet)
+	uint16_t retransmits;  // Wiederholte Rahmen
+	uint16_t timeouts;     // Zeitüberschreitungen ohne Bestätigung
+	uint16_t resyncs;      // Nummern nach Neustart einer Seite neu abgeglichen
+} linkseq_stats_t;
+
+// Prüfen ob ein neuer gesicherter Rahmen gesendet werden darf
+// (Fenster nicht voll und keine Wiederholung in Arbeit)
+uint8_t linkseq_space(void);
+
+// Neuen gesicherten Rahmen ins Fenster aufnehmen
+// Rückgabe: LinkSeq, die der Aufrufer als erstes Nutzdatenbyte sendet
+uint8_t linkseq_push(uint8_t tag, uint16_t arg, uint32_t now_s);
+
+// Prüfen ob ein Rahmen wiederholt werden muss (startet nach LINKSEQ_TIMEOUT_S die Wiederholung)
+uint8_t linkseq_resend_due(uint32_t now_s);
+
+// Nächsten zu wiederholenden Rahmen abholen (nur nach linkseq_resend_due() == 1)
+// Der Aufrufer muss ihn sofort mit der gelieferten LinkSeq senden
+void linkseq_resend(uint8_t* seq, uint8_t* tag, uint16_t* arg, uint32_t now_s);
+
+// Einen empfangenen Rahmen auswerten
+// Rückgabe: 1 = Rahmen war eine Bestätigung (LINK_FRAME_ACK)
+uint8_t linkseq_receive(uint8_t type, const uint8_t* payload, uint8_t len, uint32_t now_s);
+
+// Statistik abrufen
+void linkseq_get_stats(linkseq_stats_t* stats);
+
+#endif /* LINKSEQ_H_ */
@@ -1,17 +1,10 @@
-// --- DEBUG-MODUS ---
-// Diese Zeile steuert, ob Debug-Ausgaben aktiviert sind
-// 0 = Produktionsmodus (keine Debug-Ausgaben)
-// 1 = Debug-Modus (mit UART-Ausgaben für Fehlersuche)
-#define DEBUG_MODE 0 // Auf 0 für den finalen Code
-
 // Standard AVR-Bibliotheken für Mikrocontroller-Funktionen
-#include <avr/io.h>        // I/O-Register und Pin-Definitionen
 #include <avr/interrupt.h> // Interrupt-Behandlung
-#include <util/delay.h>    // Verzögerungsfunktionen
 #include <stdlib.h>        // Standard-C-Funktionen (atoi, etc.)
 #include <stdint.h>        // Standard-Integer-Typen
 #include <stdbool.h>       // Boolean-Typ
 #include <string.h>        // String-Funktionen
+#include <avr/pgmspace.h>  // Tabellen im Flash
 
 // Eigene Header-Dateien des Projekts
 #include "Sensor.h"        // BME280 Sensor-Funktionen
@@ -21,201 +14,810 @@
 #include "display.h"       // Display-Rendering-Funktionen
 #include "data.h"          // Globale Datenstrukturen
 #include "i2cMaster.h"     // I2C-Kommunikation
-
-// UART nur im Debug-Modus einbinden
-#if DEBUG_MODE
-#include "uart.h"          // UART für Debug-Ausgaben
-#endif
-
-// Struct-Definition für Sensordaten
-// Speichert eine einzelne Messung mit Zeitstempel
-typedef struct {
-	uint32_t timestamp;  // Zeitstempel (in Sekunden seit Start)
-	int16_t  temp;       // Temperatur in Zehntel-Grad (z.B. 235 = 23.5°C)
-	uint16_t press;      // Druck in hPa (z.B. 1013 = 1013.0 hPa)
-} SensorValue;
+#include "sample.h"        // Messwert-Cache (gemeinsame Sensor-Abfrage)
+#include "filter.h"        // Filterstufe vor der Speicherung
+#include "storage.h"       // EEPROM-Speicherung und adaptive Abtastung
+#include "link.h"          // Rahmenprotokoll zum ESP8266
+#include "linkrate.h"      // Aushandlung der Baudrate
+#include "pack.h"          // Kompression beim Bulk-Export
+#include "linkseq.h"       // Gesicherte Zustellung (APPEND)
+#include "fmt.h"           // Zahlenformatierung ohne Division
+#include "timebase.h"      // Zeitbasis (Timer1: Sekunden, Millisekunden, atomar gelesen)
+#include "sched.h"         // Kooperativer Scheduler (Tick, Idle-Schlaf)
+#include "button.h"        // Taster (Entprellung im Tick-Interrupt)
+#include "profile.h"       // Laufzeitmessung der Verarbeitungsstufen (PROFILE_ENABLE)
+#include "diag.h"          // Diagnose-Zähler und -Rahmen (DIAG_ENABLE)
+#include "ram.h"           // RAM-Überwachung (Stacktiefe, statischer RAM je Modul)
+#include "arena.h"         // Gemeinsamer Bereich für Verlauf, Seitenpuffer, Kalibrierdaten
+#include "trace.h"         // Ablaufprotokoll (binär, wird in freier Zeit gesendet)
+#include "hal.h"           // Hardware-Abstraktion (Reset-Ursache)
 
 // Globale Variablen - werden in verschiedenen Funktionen verwendet
+// Statischer RAM von main.c: MAIN_RAM_* direkt unter den gezählten Variablen,
+// RAM_ACCOUNT(main) am Ende der Variablen (tools/ram_map.py vergleicht mit der Map-Datei)
 volatile uint8_t pageNumber = 1;    // Aktuelle Anzeigeseite (1-5)
-volatile uint32_t timestamp = 0;    // Zeitstempel (wird von Timer-ISR erhöht)
-char    cmd_buffer[4];              // Puffer für empfangene Befehle vom ESP8266
-uint8_t cmd_index = 0;              // Aktuelle Position im Befehls-Puffer
-int16_t  dataGraph[DISPLAY_COUNT];  // Daten für Display-Graphen (96 Werte)
 int16_t  dataT;                     // Aktuelle Temperatur
 uint16_t dataP;                     // Aktueller Druck
-bool     first_run         = true;  // Flag für erste Ausführung
-uint32_t last_measured     = 0;     // Zeitstempel der letzten Messung
-uint32_t last_refrehed     = 0;     // Zeitstempel der letzten Display-Aktualisierung
-uint8_t raw_index_24h = 0;          // Index für 24h-Rohdaten im EEPROM
-uint8_t raw_index_7d  = 0;          // Index für 7-Tage-Rohdaten im EEPROM
-uint8_t index_24h     = 0;          // Index für 24h-Durchschnittsdaten
-uint8_t index_7d      = 0;          // Index für 7-Tage-Durchschnittsdaten
+uint16_t dataH;                     // Aktuelle Luftfeuchtigkeit
+#define MAIN_RAM_VALUES  (sizeof(pageNumber) + sizeof(dataT) + sizeof(dataP) + sizeof(dataH))
+#if !LINK_BINARY
+char    cmd_buffer[4];              // Puffer für empfangene Befehle vom ESP8266 (nur Textformat)
+uint8_t cmd_index = 0;              // Aktuelle Position im Befehls-Puffer
+#define MAIN_RAM_TEXT  (sizeof(cmd_buffer) + sizeof(cmd_index))
+#else
+#define MAIN_RAM_TEXT  0
+#endif
+
+// Aufgaben des Schedulers (Nummer = Reihenfolge beim Eintragen in main)
+// Die Webseite des ESP8266 benennt die Aufgaben in derselben Reihenfolge
+#define TASK_RX       0              // Empfangene Bytes vom ESP8266 verarbeiten (Ereignis SCHED_EV_RX)
+#define TASK_BUTTON   1              // Taster-Ereignisse auswerten (Ereignis SCHED_EV_BUTTON)
+#define TASK_DISPLAY  2              // Display neu zeichnen und Datenpaket senden (alle 6 s)
+#define TASK_MEASURE  3              // Messen und speichern (storage_interval())
+#define TASK_PUMP     4              // Vorgemerkte Rahmen senden (jeder Durchlauf)
+#define DISPLAY_PERIOD_S     6       // Display-Aktualisierung (s)
+
+// Übertragene Verläufe (nur Binärformat)
+// Der ESP8266 fragt Verläufe mit GET_SERIES ab (beliebiger Abschnitt, unabhängig
+// von der angezeigten Seite). Neue Punkte werden als APPEND mit ihrer laufenden
+// Nummer gemeldet, damit die Kopie des ESP8266 aktuell bleibt.
+#if LINK_BINARY
+uint16_t series_sent[SERIES_COUNT];  // Laufende Nummer des zuletzt gemeldeten Punkts
+uint8_t  req_from[SERIES_COUNT];     // Offene Abfrage je Verlauf: ab Alter
+uint8_t  req_count[SERIES_COUNT];    // Offene Abfrage je Verlauf: Anzahl (0 = keine)
+#define MAIN_RAM_SERIES  (sizeof(series_sent) + sizeof(req_from) + sizeof(req_count))
+#else
+#define MAIN_RAM_SERIES  0
+#endif
+
+// Sendeaufträge an den ESP8266
+// send_data_packet() merkt die Rahmen (aktuelle Werte, Status) nur vor,
+// send_pump() schreibt die Rahmen in der Hauptschleife, sobald sie ohne Warten
+// in den Sendepuffer passen. Die Übertragung läuft per Interrupt im Hintergrund.
+#define TX_CURRENT  0x01             // Aktuelle Werte senden
+#define TX_STATUS   0x02             // Statuszähler senden
+#define TX_LINK_STATUS 0x04          // Verlustzähler der Verbindung senden (nur Binärformat)
+#define TX_TASK_STATUS 0x08          // Laufzeitbericht einer Aufgabe senden (nur Binärformat, DIAG_ENABLE)
+#define TASK_STATUS_LEN 13           // Nutzdaten des TASK_STATUS-Rahmens
+#define TX_INPUT_STATUS 0x10         // Taster-Statistik senden (nur Binärformat, DIAG_ENABLE)
+#define INPUT_STATUS_VALUES 7        // Anzahl Zähler im INPUT_STATUS-Rahmen
+#define TX_PROFILE  0x20             // Laufzeitbericht senden, ein Rahmen je Messpunkt (PROFILE_ENABLE)
+#define PROFILE_LEN 16               // Nutzdaten des PROFILE-Rahmens
+#define TX_DRIVER_STATUS 0x40        // Treiber-Statistik senden, reihum ein Treiber je Rahmen (nur Binärformat, DIAG_ENABLE)
+#define DRIVER_EEPROM 0              // Treiber im DRIVER_STATUS-Rahmen
+#define DRIVER_LCD    1
+#define DRIVER_UART   2
+#define DRIVER_COUNT  3
+#define TX_RAM_STATUS 0x80           // RAM-Bericht senden, reihum ein Modul je Rahmen (nur Binärformat, DIAG_ENABLE)
+#define RAM_STATUS_LEN 12            // Nutzdaten des RAM_STATUS-Rahmens
+#define LINK_STATUS_VALUES 11        // Anzahl Zähler im LINK_STATUS-Rahmen
+#define STATUS_VALUES 9              // Anzahl u16-Zähler im Statuspaket
+#define STATUS_WIDE   2              // Danach 32-Bit-Zähler (Messwert-Cache)
+#define STATUS_LEN    (STATUS_VALUES * 2 + STATUS_WIDE * 4)  // Nutzdaten des STATUS-Rahmens
+#define JOB_NONE    0xFF             // Keine Verlaufs-Antwort in Arbeit
+#define SERIES_BURST 8               // Punkte je EEPROM-Burst beim Senden
+_Static_assert(DISPLAY_COUNT % SERIES_BURST == 0, "Verlauf wird im Textformat in ganzen Bursts gesendet");
+uint8_t  tx_pending;                 // Vorgemerkte Aufträge (TX_*)
+uint8_t  tx_page = 1;                // Seite für den nächsten CURRENT-Rahmen
+uint8_t  tx_measuring;               // 1 = Paketmessung läuft bis der Sendepuffer leer ist
+uint8_t  tx_status;                  // Nächster Eintrag in tx_rotation
+#define MAIN_RAM_TX  (sizeof(tx_pending) + sizeof(tx_page) + sizeof(tx_measuring) + sizeof(tx_status))
+#if DIAG_ENABLE
+uint8_t  tx_task;                    // Aufgabe des nächsten TASK_STATUS-Rahmens (reihum)
+uint8_t  tx_driver;                  // Treiber des nächsten DRIVER_STATUS-Rahmens (reihum)
+uint8_t  tx_ram_mod;                 // Modul des nächsten RAM_STATUS-Rahmens (reihum)
+#define MAIN_RAM_DIAG  (sizeof(tx_task) + sizeof(tx_driver) + sizeof(tx_ram_mod))
+#else
+#define MAIN_RAM_DIAG  0
+#endif
+#if LINK_BINARY
+// Status- und Diagnoserahmen: mit jedem Datenpaket (alle 6 s) einer reihum, jeder
+// kommt so alle 12 s (mit DIAG_ENABLE alle 36 s) statt alle 6 s (Verlaufspunkte und
+// CURRENT laufen unabhängig)
+static const uint8_t tx_rotation[] PROGMEM = {
+	TX_STATUS, TX_LINK_STATUS,
+	#if DIAG_ENABLE
+	TX_TASK_STATUS, TX_INPUT_STATUS, TX_DRIVER_STATUS, TX_RAM_STATUS
+	#endif
+};
+#endif
+#if PROFILE_ENABLE
+uint8_t  prof_next;                  // Nächster Messpunkt des Laufzeitberichts
+uint8_t  prof_reset_after;           // 1 = Messpunkte nach dem Bericht zurücksetzen
+#define MAIN_RAM_PROFILE  (sizeof(prof_next) + sizeof(prof_reset_after))
+#else
+#define MAIN_RAM_PROFILE  0
+#endif
+#if LINK_BINARY
+uint8_t  job_series = JOB_NONE;      // Verlauf der laufenden Antwort
+uint8_t  job_from;                   // Erstes Alter der Antwort
+uint8_t  job_count;                  // Anzahl Punkte der Antwort
+uint8_t  job_point;                  // Bereits gesendete Punkte
+uint16_t job_seq;                    // Laufende Nummer zu Beginn der Antwort
+#define MAIN_RAM_JOB  (sizeof(job_series) + sizeof(job_from) + sizeof(job_count) \
+                       + sizeof(job_point) + sizeof(job_seq))
+
+// Bulk-Export (GET_CHUNK, GET_PACKED; LINK_BULK, LINK_PACK): Der ESP8266 fordert die
+// Ringpuffer abschnittsweise an. Jede Abfrage ist in sich abgeschlossen (Bereich + Offset),
+// ein verlorener Abschnitt wird einfach erneut angefordert.
+#if LINK_BULK
+#define CHUNK_BURST 8                // Bytes je EEPROM-Burst beim Senden
+uint8_t  chunk_req_region;           // Offene Abfrage: Bereich (REGION_*)
+uint16_t chunk_req_offset;           // Offene Abfrage: Offset im Bereich
+uint8_t  chunk_req_len;              // Offene Abfrage: Länge (Bytes, bei PACKED Datensätze; 0 = keine)
+uint8_t  chunk_open;                 // 1 = CHUNK/PACKED-Rahmen wird gerade gesendet
+uint16_t chunk_addr;                 // Nächste EEPROM-Adresse des laufenden Rahmens
+uint8_t  chunk_left;                 // Noch zu sendende Bytes (bei PACKED Datensätze)
+#define MAIN_RAM_BULK  (sizeof(chunk_req_region) + sizeof(chunk_req_offset) + sizeof(chunk_req_len) \
+                        + sizeof(chunk_open) + sizeof(chunk_addr) + sizeof(chunk_left))
+#if LINK_PACK
+uint8_t  chunk_req_packed;           // Offene Abfrage: 1 = komprimiert (PACKED)
+uint8_t  chunk_packed;               // 1 = laufender Rahmen ist PACKED
+pack_state_t chunk_pack;             // Kodierer des laufenden PACKED-Rahmens
+#define MAIN_RAM_PACK  (sizeof(chunk_req_packed) + sizeof(chunk_packed) + sizeof(chunk_pack))
+#endif
+#define BULK_OPEN   chunk_open
+#else
+#define BULK_OPEN   0                // Ohne Bulk-Export ist nie ein Abschnitt offen
+#endif
+#else
+#define MAIN_RAM_JOB  0
+#endif
+#ifndef MAIN_RAM_BULK
+#define MAIN_RAM_BULK  0
+#endif
+#ifndef MAIN_RAM_PACK
+#define MAIN_RAM_PACK  0
+#endif
+RAM_ACCOUNT(main, MAIN_RAM_VALUES + MAIN_RAM_TEXT + MAIN_RAM_SERIES + MAIN_RAM_TX + MAIN_RAM_DIAG
+                  + MAIN_RAM_PROFILE + MAIN_RAM_JOB + MAIN_RAM_BULK + MAIN_RAM_PACK);
+
 
 // Funktionsprototypen - Deklarationen für Funktionen, die später definiert werden
-void timer1_init(void);
-void store_sensor_value(uint16_t base_addr, uint8_t index, uint32_t ts, int16_t temp, uint16_t press);
-void read_raw_values(uint16_t base_addr, uint8_t count, int32_t* temp_sum, uint32_t* press_sum, uint32_t* time_sum);
-void loadDataGraph(uint8_t mode);
 void send_data_packet(uint8_t page_num);
-
-// Interrupt Service Routine für Timer1
-// Wird alle ~1 Sekunde aufgerufen (abhängig von Timer-Konfiguration)
-ISR(TIMER1_COMPA_vect) {
-	timestamp++;  // Erhöht den Zeitstempel um 1
-}
+void send_status_packet(void);
+void send_pump(void);
+uint8_t update_current_values(uint16_t max_age_ms);
+void task_rx(void);
+void task_button(void);
+void task_display(void);
+void task_measure(void);
 
 // Hauptprogramm - Startpunkt der Anwendung
 int main(void) {
 	// Initialisierung aller Hardware-Komponenten
 	spi_init();        // SPI für externes EEPROM initialisieren
-	initI2C();         // I2C für BME280 Sensor initialisieren
-	timer1_init();     // Timer1 für Zeitmessung initialisieren
+	i2c_init();        // I2C für BME280 Sensor initialisieren
+	sched_init();      // Scheduler (Idle-Schlaf)
+	filter_init();     // Filterstufe (Timer0 für Laufzeitmessung)
+	PROFILE_INIT();    // Laufzeitmessung (Timer2, nur mit PROFILE_ENABLE)
+	storage_init();    // EEPROM-Speicherung
 	rs232_init();      // RS232 für ESP8266-Kommunikation initialisieren
 
-	// Debug-Modus: 10 Sekunden warten und UART initialisieren
-	#if DEBUG_MODE
-	_delay_ms(10000);  // 10 Sekunden warten für Debugging
-	uart_init(7);      // UART mit Baudrate 7 initialisieren
-	uart_send_string("DEBUG MODE ACTIVE\n");  // Debug-Nachricht senden
+	#if FMT_BENCHMARK
+	// Zahlenformatierung gegen die Division messen und vergleichen (Textzeile f:...;)
+	fmt_bench_t fb;
+	fmt_benchmark(&fb);
+	rs232_putchar('f'); rs232_putchar(':');
+	rs232_send_uint_semicolon(fb.cycles_fmt);
+	rs232_send_uint_semicolon(fb.cycles_div);
+	rs232_send_uint_semicolon(fb.mismatches);
+	rs232_putchar('\r'); rs232_putchar('\n');
 	#endif
 
+	// Reset-Ursache ins Ablaufprotokoll (ersetzt den früheren DEBUG_MODE mit Textausgaben)
+	uint8_t reset_cause = hal_reset_cause();  // MCUCSR lesen und löschen
+	TRACE(TRACE_BOOT, reset_cause, 0);
+	(void)reset_cause;
+
 	// Sensor und Display initialisieren
-	bme280_init();                    // BME280 Sensor initialisieren
-	bme280_read_calibration();        // Kalibrierungsdaten vom Sensor lesen
+	// Antwortet der Sensor nicht, wird die Einrichtung bei der nächsten Messung nachgeholt
+	if (bme280_init() == I2C_OK) {    // BME280 Sensor initialisieren
+		bme280_read_calibration();    // Kalibrierungsdaten vom Sensor lesen
+	}
 	ks0108_init();                    // KS0108 Display initialisieren
 	
-	// Taster-Pin konfigurieren (PC3 als Eingang mit Pull-up)
-	DDRC  &= ~_BV(PC3);               // Pin als Eingang setzen
-	PORTC |=  _BV(PC3);               // Pull-up-Widerstand aktivieren
-	uint8_t last_button_state = 1;    // Letzter Taster-Zustand (1 = nicht gedrückt)
-	
+	button_init();                    // Taster-Pin (PC3 als Eingang mit Pull-up)
+
+	// Timer1 erst nach der Einrichtung starten: Sensor, EEPROM und Display brauchen rund
+	// 70 ms mit gesperrten Interrupts, die Ticks in dieser Zeit gingen sonst verloren
+	timebase_init();                  // Zeitbasis (Tick alle 10 ms)
+
+	// Aufgaben eintragen (Reihenfolge wie TASK_*)
+	// Display und Messung sind beim Start sofort fällig, das Display zuerst
+	sched_add(task_rx,      SCHED_NO_PERIOD,                      2, SCHED_EV_MASK(SCHED_EV_RX));
+	sched_add(task_button,  SCHED_NO_PERIOD,                      2, SCHED_EV_MASK(SCHED_EV_BUTTON));
+	sched_add(task_display, DISPLAY_PERIOD_S * SCHED_TICKS_PER_S, 50, 0);
+	sched_add(task_measure, storage_interval() * SCHED_TICKS_PER_S, 100, 0);
+	sched_add(send_pump,    SCHED_EVERY_PASS,                     2, 0);
+
 	sei();  // Interrupts global aktivieren
 
-	// Hauptschleife - läuft endlos
-	while (1) {
-		// --- Taster-Abfrage für Seitenwechsel ---
-		// Aktuellen Taster-Zustand lesen (0 = gedrückt, 1 = nicht gedrückt)
-		uint8_t current_button_state = (PINC & _BV(PC3)) ? 1 : 0;
+	// Hauptschleife - läuft endlos, die CPU schläft, wenn keine Aufgabe fällig ist
+	sched_run();
+	return 0;  // Wird nie erreicht, da sched_run() endlos läuft
+}
+
+// --- Aufgaben des Schedulers ---
+
+// Befehlsverarbeitung bei ANFRAGE vom ESP (Seitenwechsel, Abfragen)
+// Wird durch das Empfangs-Ereignis fällig und verarbeitet alle wartenden Bytes
+void task_rx(void) {
+	while (rs232_data_ready()) {
+		char received = rs232_getchar();  // Ein Zeichen lesen
 		
-		// Taster wurde gerade gedrückt (fallende Flanke)
-		if (last_button_state && !current_button_state) {
-			_delay_ms(50);  // 50ms warten für Entprellung
-			
-			// Nochmal prüfen, ob Taster wirklich gedrückt ist
-			if ((PINC & _BV(PC3)) == 0) {
-				// Zur nächsten Seite wechseln (1->2->3->4->5->1...)
-				pageNumber = (pageNumber % 5) + 1;
-
-				// Display SOFORT aktualisieren
-				loadDataGraph(pageNumber);  // Daten für neue Seite laden
-				bmp280_read_temperature_and_pressure(&dataT, &dataP);  // Aktuelle Werte lesen
+		#if LINK_BINARY
+		// Binärformat: Seitenwechsel kommt als LINK_FRAME_PAGE
+		uint8_t type, len; const uint8_t* payload;
+		if (link_receive(received, &type, &payload, &len)) {
+			uint32_t now = timebase_seconds();
+			if (linkrate_receive(type, payload, len, now)) {
+				// Baudraten-Aushandlung (Antwort sendet send_pump)
+			} else if (linkseq_receive(type, payload, len, now)) {
+				// Bestätigung gesicherter Rahmen
+			} else if (type == LINK_FRAME_PAGE && len == 1 && payload[0] >= 1 && payload[0] <= 5) {
+				pageNumber = payload[0];  // Seite wechseln
+				TRACE(TRACE_PAGE, pageNumber, TRACE_SRC_ESP);
+				sched_trigger(TASK_DISPLAY);  // Display sofort neu zeichnen
+			} else if (type == LINK_FRAME_GET_SERIES && len == 3
+			           && payload[0] < SERIES_COUNT && payload[1] < DISPLAY_COUNT && payload[2]) {
+				// Abschnitt eines Verlaufs abfragen (ersetzt eine offene Abfrage desselben Verlaufs)
+				uint8_t count = payload[2];
+				if (count > DISPLAY_COUNT - payload[1]) count = DISPLAY_COUNT - payload[1];
+				req_from[payload[0]]  = payload[1];
+				req_count[payload[0]] = count;
+			} else if (type == LINK_FRAME_GET_PROFILE && len <= 1) {
+				#if PROFILE_ENABLE
+				// Laufzeitbericht (alle Messpunkte nacheinander über send_pump)
+				prof_next = 0;
+				prof_reset_after = len && payload[0];
+				tx_pending |= TX_PROFILE;
+				#endif
+			} else if (type == LINK_FRAME_GET_CURRENT && len == 0) {
+				tx_pending |= TX_CURRENT;  // Aktuelle Werte beim nächsten send_pump()
+			} else if (type == LINK_FRAME_GET_CHUNK && len == 4) {
+				#if LINK_BULK
+				// Abschnitt eines Speicherbereichs abfragen (ersetzt eine offene Abfrage)
+				storage_region_t r;
+				uint16_t offset = payload[1] | ((uint16_t)payload[2] << 8);
+				if (storage_region(payload[0], &r) && offset < r.size && payload[3]) {
+					uint8_t n = payload[3];
+					if (n > LINK_CHUNK_MAX)    n = LINK_CHUNK_MAX;
+					if (n > r.size - offset)   n = r.size - offset;
+					chunk_req_region = payload[0];
+					chunk_req_offset = offset;
+					chunk_req_len    = n;
+					#if LINK_PACK
+					chunk_req_packed = 0;
+					#endif
+				}
+				#endif
+			} else if (type == LINK_FRAME_GET_PACKED && len == 3) {
+				#if LINK_PACK
+				// Datensätze eines Speicherbereichs komprimiert abfragen (ersetzt eine offene Abfrage)
+				storage_region_t r;
+				if (storage_region(payload[0], &r) && payload[1] < r.size / sizeof(SensorValue) && payload[2]) {
+					uint8_t n = payload[2];
+					uint8_t records = r.size / sizeof(SensorValue);
+					if (n > LINK_PACK_MAX)           n = LINK_PACK_MAX;
+					if (n > records - payload[1])    n = records - payload[1];
+					chunk_req_region = payload[0];
+					chunk_req_offset = payload[1] * sizeof(SensorValue);
+					chunk_req_len    = n;
+					chunk_req_packed = 1;
+				}
+				#endif
+			}
+		}
+		#else
+		// Wenn Zeilenende erreicht ist
+		if (received == '\n' || received == '\r') {
+			if (cmd_index > 0) {  // Wenn Befehls-Puffer nicht leer ist
+				cmd_buffer[cmd_index] = '\0';  // String beenden
+				uint8_t cmd = atoi(cmd_buffer);  // String zu Zahl konvertieren
 				
-				// Alle Display-Seiten neu zeichnen
-				for (uint8_t pg = 0; pg < SCREEN_H / 8; pg++) {
-					clearPage(pg);                    // Seite löschen
-					renderScene(pageNumber - 1, pg);  // Neue Szene rendern
-					ks0108_write_page(pg, pageBuf);   // Seite zum Display senden
+				// Prüfen, ob gültige Seitennummer (1-5)
+				if (cmd >= 1 && cmd <= 5) {
+					pageNumber = cmd;  // Seite wechseln
+					// Der nächste periodische Loop wird die Änderung übernehmen
 				}
+				cmd_index = 0;  // Puffer zurücksetzen
+			}
+		} else if (cmd_index < sizeof(cmd_buffer) - 1) {
+			// Zeichen zum Puffer hinzufügen (mit Überlaufschutz)
+			cmd_buffer[cmd_index++] = received;
+		}
+		#endif
+	}
+}
 
-				// Daten SOFORT an ESP8266 senden
-				send_data_packet(pageNumber);
+// Taster-Ereignisse für den Seitenwechsel auswerten
+// Druck und Wiederholung: nächste Seite (1->2->3->4->5->1...), langer Druck: zurück zu Seite 1
+// Mehrere wartende Ereignisse ergeben nur ein neues Bild
+void task_button(void) {
+	button_event_t ev;
+	while (button_get(&ev)) {
+		if (ev.type == BUTTON_EV_LONG) pageNumber = 1;
+		else                           pageNumber = (pageNumber % 5) + 1;
+		TRACE(TRACE_PAGE, pageNumber, TRACE_SRC_BUTTON);
+		sched_trigger(TASK_DISPLAY);  // Display SOFORT aktualisieren, die 6 s beginnen neu
+	}
+}
 
-				// Timer zurücksetzen, um doppeltes Senden zu vermeiden
-				last_refrehed = timestamp;
-			}
+// Periodische Aktualisierung und Daten Senden (alle 6 Sekunden, nach Seitenwechsel sofort)
+void task_display(void) {
+	// Aktuelle Werte zuerst: eine Neu-Einrichtung des Sensors belegt den gemeinsamen Bereich (ARENA_BOOT)
+	update_current_values(SAMPLE_MAX_AGE_DISPLAY_MS);  // Aktuelle Werte (aus dem Cache)
+
+	// Verlauf laden und in Pixelzeilen umrechnen, danach ARENA_RENDER (Zeilen + Seitenpuffer)
+	if (pageNumber <= SERIES_COUNT) {
+		arena_begin(ARENA_GRAPH);
+		PROFILE_BEGIN(PROF_LOAD_GRAPH);
+		storage_load_graph(pageNumber, arena.graph.values);  // Daten laden
+		PROFILE_END(PROF_LOAD_GRAPH);
+		prepareGraph();
+	} else {
+		arena_begin(ARENA_RENDER);
+	}
+	
+	// Alle Display-Seiten neu zeichnen
+	for (uint8_t pg = 0; pg < SCREEN_H / 8; pg++) {
+		clearPage(pg);                    // Seite löschen
+		PROFILE_BEGIN(PROF_RENDER);
+		renderScene(pageNumber - 1, pg);  // Szene rendern
+		PROFILE_END(PROF_RENDER);
+		PROFILE_BEGIN(PROF_LCD_WRITE);
+		ks0108_write_page(pg, arena.render.page);  // Seite senden
+		PROFILE_END(PROF_LCD_WRITE);
+	}
+	arena_end();
+	lcd_frame_done();
+	#if DIAG_ENABLE
+	ram_scan();      // Stacktiefe nach dem Zeichnen (tiefste Aufrufkette) aktualisieren
+	button_shown();  // Latenz eines Seitenwechsels per Taster messen
+	#endif
+	
+	// Daten an ESP8266 senden
+	PROFILE_BEGIN(PROF_SEND_PACKET);
+	send_data_packet(pageNumber);  // Inklusive Fehlerzähler für die Statusanzeige
+	PROFILE_END(PROF_SEND_PACKET);
+}
+
+// Sensor-Messung und EEPROM-Speicherung
+// Im Abstand von storage_interval() (2-32 s, adaptiv)
+void task_measure(void) {
+	// Aktuelle Sensordaten lesen (neue Abfrage nur, wenn der Cache zu alt ist)
+	// Antwortet der Sensor nicht, wird eine Lücke statt alter Werte gespeichert
+	PROFILE_BEGIN(PROF_SENSOR);
+	uint8_t status = update_current_values(SAMPLE_MAX_AGE_STORE_MS);
+	PROFILE_END(PROF_SENSOR);
+	int16_t st = dataT; uint16_t sp = dataP; uint16_t sh = dataH;  // Zu speichernde Werte
+	if (status == SAMPLE_OK) {
+		filter_apply(&st, &sp, &sh);  // Ausreißer entfernen und glätten (nur Speicherpfad)
+	} else {
+		filter_reset();  // Nach der Lücke neu einschwingen
+	}
+	
+	// Mittelwerte sammeln, Rohdaten nur bei Änderung schreiben
+	PROFILE_BEGIN(PROF_STORE);
+	storage_add_sample(timebase_seconds(), status, st, sp, sh);
+	PROFILE_END(PROF_STORE);
+
+	// Das Intervall kann sich mit der Messung geändert haben
+	sched_set_period(TASK_MEASURE, storage_interval() * SCHED_TICKS_PER_S);
+}
+
+// --- Implementierung der Hilfsfunktionen ---
+
+#if LINK_BINARY
+// Einen Verlaufspunkt als gesicherten APPEND senden (Platz muss geprüft sein)
+// Der Wert wird aus dem EEPROM gelesen, damit eine Wiederholung nur Verlauf und Nummer braucht
+static void send_append(uint8_t lseq, uint8_t s, uint16_t point_seq) {
+	uint16_t age = storage_series_seq(s) - point_seq;
+	link_begin(LINK_FRAME_APPEND, 1 + 3 + 2);
+	link_u8(lseq);
+	link_u8(s);
+	link_u16(point_seq);
+	link_i16(age < DISPLAY_COUNT ? storage_series_point(s, age) : SAMPLE_GAP_VALUE);
+	link_end();
+}
+
+// Schreibt den nächsten Teil einer Verlaufs-Antwort oder eines APPEND in den Sendepuffer
+// Antworten auf GET_SERIES werden stückweise aus dem EEPROM gelesen (Bursts von
+// SERIES_BURST Punkten) und nachgeschoben, solange Platz im Sendepuffer ist
+// Rückgabe: 1 = es gibt noch etwas zu senden (später erneut aufrufen)
+static uint8_t send_series_step(void) {
+	uint32_t now = timebase_seconds();
+	if (job_series != JOB_NONE) {
+		// Wurde inzwischen eine Zeitspanne abgeschlossen, sind die Punkte gewandert
+		uint8_t shift = storage_series_seq(job_series) - job_seq;
+		while (job_point < job_count) {
+			uint8_t n = job_count - job_point;
+			if (n > SERIES_BURST)            n = SERIES_BURST;
+			if (n > rs232_tx_free() / 4)     n = rs232_tx_free() / 4;  // i16, beide Bytes maskiert
+			if (n == 0) return 1;
+
+			int16_t buf[SERIES_BURST];
+			uint16_t age = job_from + job_point + shift;
+			storage_series_read(job_series, age < DISPLAY_COUNT ? age : DISPLAY_COUNT, n, buf);
+			for (uint8_t i = 0; i < n; i++) link_i16(buf[i]);
+			job_point += n;
 		}
-		last_button_state = current_button_state;  // Zustand für nächsten Durchlauf speichern
-
-		// --- Periodische Aktualisierung und Daten Senden ---
-		// Alle 6 Sekunden oder beim ersten Start
-		if ((timestamp - last_refrehed) >= 6 || first_run) {
-			last_refrehed = timestamp;  // Timer zurücksetzen
-
-			// Display aktualisieren
-			loadDataGraph(pageNumber);  // Daten laden
-			bmp280_read_temperature_and_pressure(&dataT, &dataP);  // Aktuelle Werte lesen
-			
-			// Alle Display-Seiten neu zeichnen
-			for (uint8_t pg = 0; pg < SCREEN_H / 8; pg++) {
-				clearPage(pg);                    // Seite löschen
-				renderScene(pageNumber - 1, pg);  // Szene rendern
-				ks0108_write_page(pg, pageBuf);   // Seite senden
-			}
-			
-			// Daten an ESP8266 senden
-			send_data_packet(pageNumber);
+		if (rs232_tx_free() < 4) return 1;      // CRC, beide Bytes maskiert
+		link_end();
+		job_series = JOB_NONE;
+	}
+
+	// Unbestätigte APPEND wiederholen (Go-Back-N)
+	if (linkseq_resend_due(now)) {
+		if (!link_room(1 + 3 + 2)) return 1;
+		uint8_t lseq, s; uint16_t point_seq;
+		linkseq_resend(&lseq, &s, &point_seq, now);
+		send_append(lseq, s, point_seq);
+		return 1;
+	}
+
+	// Offene Abfragen beantworten
+	for (uint8_t s = 0; s < SERIES_COUNT; s++) {
+		if (!req_count[s]) continue;
+		if (!link_room(5)) return 1;            // Platz für den Rahmenkopf
+		job_series = s;
+		job_from   = req_from[s];
+		job_count  = req_count[s];
+		job_point  = 0;
+		job_seq    = storage_series_seq(s);
+		req_count[s] = 0;
+		link_begin(LINK_FRAME_SERIES, 5 + job_count * 2);
+		link_u8(s);
+		link_u16(job_seq);
+		link_u8(job_from);
+		link_u8(job_count);
+		return 1;
+	}
+
+	// Neue Punkte melden (ältester zuerst)
+	for (uint8_t s = 0; s < SERIES_COUNT; s++) {
+		uint16_t seq     = storage_series_seq(s);
+		uint16_t missing = seq - series_sent[s];
+		if (missing > DISPLAY_COUNT) {
+			// ESP8266 hat zu viel verpasst, er erkennt die Lücke an der Nummer und fragt selbst ab
+			series_sent[s] = seq;
+		} else if (missing) {
+			// Volles Fenster: warten, bis der ESP8266 bestätigt (Punkte bleiben im EEPROM)
+			if (!linkseq_space() || !link_room(1 + 3 + 2)) return 1;
+			uint16_t point_seq = seq - missing + 1;
+			send_append(linkseq_push(s, point_seq, now), s, point_seq);
+			series_sent[s]++;
+			return 1;
 		}
+	}
+	return 0;
+}
+#endif
 
-		// --- Sensor-Messung und EEPROM-Speicherung ---
-		// Alle 2 Sekunden oder beim ersten Start
-		if ((timestamp - last_measured) >= 2 || first_run) {
-			last_measured = timestamp;  // Timer zurücksetzen
-			
-			// Aktuelle Sensordaten lesen
-			bmp280_read_temperature_and_pressure(&dataT, &dataP);
-			
-			// Rohdaten für 24h-Speicherung
-			store_sensor_value(EEPROM_ADDR_RAW_24H, raw_index_24h, timestamp, dataT, dataP);
-			raw_index_24h = (raw_index_24h + 1) % RAW_BUFFER_24H_COUNT;  // Index erhöhen (Ringpuffer)
-			
-			// Rohdaten für 7-Tage-Speicherung
-			store_sensor_value(EEPROM_ADDR_RAW_7D, raw_index_7d, timestamp, dataT, dataP);
-			raw_index_7d = (raw_index_7d + 1) % RAW_BUFFER_7D_COUNT;  // Index erhöhen (Ringpuffer)
-			
-			// Wenn 24h-Ringpuffer voll ist, Durchschnitt berechnen
-			if (raw_index_24h == 0) {
-				int32_t temp_sum = 0; uint32_t press_sum = 0; uint32_t time_sum = 0;
-				// Alle Rohdaten lesen und summieren
-				read_raw_values(EEPROM_ADDR_RAW_24H, RAW_BUFFER_24H_COUNT, &temp_sum, &press_sum, &time_sum);
-				// Durchschnitt speichern
-				store_sensor_value(EEPROM_ADDR_24H, index_24h, time_sum / RAW_BUFFER_24H_COUNT, temp_sum / RAW_BUFFER_24H_COUNT, press_sum / RAW_BUFFER_24H_COUNT);
-				index_24h = (index_24h + 1) % DISPLAY_COUNT;  // Index erhöhen (Ringpuffer)
-			}
-			
-			// Wenn 7-Tage-Ringpuffer voll ist, Durchschnitt berechnen
-			if (raw_index_7d == 0) {
-				int32_t temp_sum = 0; uint32_t press_sum = 0; uint32_t time_sum = 0;
-				// Alle Rohdaten lesen und summieren
-				read_raw_values(EEPROM_ADDR_RAW_7D, RAW_BUFFER_7D_COUNT, &temp_sum, &press_sum, &time_sum);
-				// Durchschnitt speichern
-				store_sensor_value(EEPROM_ADDR_7D, index_7d, time_sum / RAW_BUFFER_7D_COUNT, temp_sum / RAW_BUFFER_7D_COUNT, press_sum / RAW_BUFFER_7D_COUNT);
-				index_7d = (index_7d + 1) % DISPLAY_COUNT;  // Index erhöhen (Ringpuffer)
+#if LINK_BULK
+// Schreibt den nächsten Teil eines Bulk-Abschnitts (CHUNK oder PACKED) in den Sendepuffer
+// Die Rohbytes werden in Bursts von CHUNK_BURST Bytes aus dem EEPROM gelesen,
+// Seq und Head im Rahmenkopf sagen dem ESP8266, wo der Ring gerade steht
+// Wird zwischen Zählen und Senden eines PACKED-Rahmens ein Datensatz geschrieben,
+// stimmt die Länge nicht mehr: der ESP8266 verwirft den Rahmen (CRC) und fragt erneut
+// Rückgabe: 1 = es gibt noch etwas zu senden (später erneut aufrufen)
+static uint8_t send_chunk_step(void) {
+	if (chunk_open) {
+		while (chunk_left) {
+			#if LINK_PACK
+			if (chunk_packed) {
+				// Datensatz für Datensatz kodieren, sobald der längste Fall in den Sendepuffer passt
+				if (rs232_tx_free() < 2 * PACK_MAX_RECORD) return 1;
+				SensorValue v;
+				uint8_t buf[PACK_MAX_RECORD];
+				eeprom_read_block(chunk_addr, (uint8_t*)&v, sizeof(v));
+				uint8_t n = pack_record(&chunk_pack, &v, buf);
+				for (uint8_t i = 0; i < n; i++) link_u8(buf[i]);
+				chunk_addr += sizeof(v);
+				chunk_left--;
+				continue;
 			}
-			
-			first_run = false;  // Erste Ausführung beendet
+			#endif
+			uint8_t n = chunk_left;
+			if (n > CHUNK_BURST)             n = CHUNK_BURST;
+			if (n > rs232_tx_free() / 2)     n = rs232_tx_free() / 2;  // jedes Byte evtl. maskiert
+			if (n == 0) return 1;
+
+			uint8_t buf[CHUNK_BURST];
+			eeprom_read_block(chunk_addr, buf, n);
+			for (uint8_t i = 0; i < n; i++) link_u8(buf[i]);
+			chunk_addr += n;
+			chunk_left -= n;
 		}
+		if (rs232_tx_free() < 4) return 1;      // CRC, beide Bytes maskiert
+		link_end();
+		chunk_open = 0;
+	}
 
-		// --- Befehlsverarbeitung bei ANFRAGE vom ESP (für Seitenwechsel) ---
-		// Prüfen, ob Daten vom ESP8266 verfügbar sind
-		if (rs232_data_ready()) {
-			char received = rs232_getchar();  // Ein Zeichen lesen
-			
-			// Wenn Zeilenende erreicht ist
-			if (received == '\n' || received == '\r') {
-				if (cmd_index > 0) {  // Wenn Befehls-Puffer nicht leer ist
-					cmd_buffer[cmd_index] = '\0';  // String beenden
-					uint8_t cmd = atoi(cmd_buffer);  // String zu Zahl konvertieren
-					
-					// Prüfen, ob gültige Seitennummer (1-5)
-					if (cmd >= 1 && cmd <= 5) {
-						pageNumber = cmd;  // Seite wechseln
-						// Der nächste periodische Loop wird die Änderung übernehmen
-					}
-					cmd_index = 0;  // Puffer zurücksetzen
-				}
-			} else if (cmd_index < sizeof(cmd_buffer) - 1) {
-				// Zeichen zum Puffer hinzufügen (mit Überlaufschutz)
-				cmd_buffer[cmd_index++] = received;
-			}
+	if (!chunk_req_len) return 0;
+	if (!link_room(6)) return 1;                // Platz für den Rahmenkopf
+	storage_region_t r;
+	storage_region(chunk_req_region, &r);
+	chunk_addr   = r.addr + chunk_req_offset;
+	chunk_left   = chunk_req_len;
+	chunk_open   = 1;
+	chunk_req_len = 0;
+
+	#if LINK_PACK
+	chunk_packed = chunk_req_packed;
+	if (chunk_packed) {
+		// Die Rahmenlänge steht vor den Nutzdaten: erst kodieren und nur zählen
+		// (ein Burst über alle Datensätze), danach beim Senden erneut kodieren
+		_Static_assert(6 + LINK_PACK_MAX * PACK_MAX_RECORD <= 255, "PACKED-Rahmen zu lang");
+		uint8_t len = 6;
+		uint8_t buf[PACK_MAX_RECORD];
+		SensorValue v;
+		pack_init(&chunk_pack);
+		eeprom_read_begin(chunk_addr);
+		for (uint8_t k = 0; k < chunk_left; k++) {
+			for (uint8_t i = 0; i < sizeof(v); i++) ((uint8_t*)&v)[i] = eeprom_read_next();
+			len += pack_record(&chunk_pack, &v, buf);
 		}
+		eeprom_read_end();
+		pack_init(&chunk_pack);
+
+		link_begin(LINK_FRAME_PACKED, len);
+		link_u8(chunk_req_region);
+		link_u8(chunk_req_offset / sizeof(SensorValue));
+		link_u16(r.seq);
+		link_u8(r.head);
+		link_u8(chunk_left);
+		return 1;
 	}
-	return 0;  // Wird nie erreicht, da while(1) endlos läuft
+	#endif
+	link_begin(LINK_FRAME_CHUNK, 6 + chunk_left);
+	link_u8(chunk_req_region);
+	link_u16(chunk_req_offset);
+	link_u16(r.seq);
+	link_u8(r.head);
+	return 1;
 }
+#endif
 
-// --- Implementierung der Hilfsfunktionen ---
+#if LINK_BINARY && DIAG_ENABLE
+// Statistik eines Treibers (tx_driver) als DRIVER_STATUS-Rahmen senden
+// Alle drei Treiber passen nicht in einen Rahmen (LINK_TX_MAX_PAYLOAD), deshalb reihum
+// Rückgabe: 0 = kein Platz im Sendepuffer, später erneut versuchen
+static uint8_t send_driver_status(void) {
+	if (tx_driver == DRIVER_EEPROM) {
+		eeprom_stats_t ee;
+		storage_stats_t st;
+		if (!link_room(2 + 3 * 4 + 2 + REGION_COUNT * 2 + 4)) return 0;
+		eeprom_get_stats(&ee);
+		storage_get_stats(&st, timebase_seconds());
+		link_begin(LINK_FRAME_DRIVER_STATUS, 2 + 3 * 4 + 2 + REGION_COUNT * 2 + 4);
+		link_u8(DRIVER_EEPROM);
+		link_u8(DRIVER_COUNT);
+		link_u32(ee.bytes_read);          // Gelesene Bytes
+		link_u32(ee.bytes_written);       // Geschriebene Bytes (= Schreibzyklen)
+		link_u32(ee.wip_wait);            // Wartezeit auf Schreibzyklen (1/3600 s)
+		link_u16(ee.wip_wait_max);        // Längste Wartezeit (1/3600 s)
+		for (uint8_t r = 0; r < REGION_COUNT; r++) {
+			link_u16(st.region_writes[r]);  // Geschriebene Datensätze je Bereich
+		}
+		link_u32(st.writes_avoided);      // Eingesparte Rohdatensätze (32 Bit, im Statuspaket nur bis 65535)
+	} else if (tx_driver == DRIVER_LCD) {
+		lcd_stats_t lcd;
+		if (!link_room(2 + 2 * 4 + 2 * 2)) return 0;
+		lcd_get_stats(&lcd);
+		link_begin(LINK_FRAME_DRIVER_STATUS, 2 + 2 * 4 + 2 * 2);
+		link_u8(DRIVER_LCD);
+		link_u8(DRIVER_COUNT);
+		link_u32(lcd.data_bytes_sent);    // Datenbytes
+		link_u32(lcd.commands_sent);      // Kommandos
+		link_u16(lcd.read_operations);    // Lesezugriffe
+		link_u16(lcd.frames);             // Bilder
+	} else {
+		rs232_status_t ser;
+		if (!link_room(2 + 6 * 2 + 1)) return 0;
+		rs232_get_status(&ser);
+		link_begin(LINK_FRAME_DRIVER_STATUS, 2 + 6 * 2 + 1);
+		link_u8(DRIVER_UART);
+		link_u8(DRIVER_COUNT);
+		link_u16(ser.bytes_sent);         // Gesendete Bytes
+		link_u16(ser.bytes_received);     // Empfangene Bytes
+		link_u16(ser.rx_overflows);       // Empfangspuffer voll
+		link_u16(ser.rx_errors);          // Hardware-Überlauf / Rahmenfehler
+		link_u16(ser.tx_full);            // Abgewiesene Bytes (Sendepuffer voll)
+		link_u16(ser.tx_waits);           // Blockierende Aufrufe mit Wartezeit
+		link_u8(ser.tx_peak);             // Höchster Füllstand des Sendepuffers
+	}
+	link_end();
+	return 1;
+}
+#endif
+
+// Schreibt vorgemerkte Rahmen in den Sendepuffer, ohne zu warten
+// Wird in jedem Durchlauf der Hauptschleife aufgerufen
+void send_pump(void) {
+	#if LINK_BINARY
+	// Ein angefangener Rahmen (Verlauf oder Bulk-Abschnitt) wird zuerst fertig gesendet,
+	// bis dahin beginnt kein anderer Rahmen (die Paketmessung läuft weiter)
+	if (job_series != JOB_NONE || BULK_OPEN) {
+		if (job_series != JOB_NONE) send_series_step();
+		#if LINK_BULK
+		else                        send_chunk_step();
+		#endif
+		return;
+	}
+
+	// Baudraten-Aushandlung zuerst (kurze Antworten)
+	uint8_t busy = linkrate_pump(timebase_seconds());
+
+	if ((tx_pending & TX_CURRENT) && link_room(1 + 3 * 2)) {
+		// Aktuelle Werte und angezeigte Seite (für die Synchronisation der Webseite)
+		// Meist ein Treffer im Cache (gerade angezeigt), bei GET_CURRENT höchstens 2 s alt
+		update_current_values(SAMPLE_MAX_AGE_SERIAL_MS);
+		link_begin(LINK_FRAME_CURRENT, 1 + 3 * 2);
+		link_u8(tx_page);
+		link_i16(dataT);           // Temperatur
+		link_u16(dataP);           // Druck
+		link_u16(dataH);           // Feuchte
+		link_end();
+		tx_pending &= ~TX_CURRENT;
+	}
+	if ((tx_pending & TX_STATUS) && link_room(STATUS_LEN)) {
+		send_status_packet();
+		tx_pending &= ~TX_STATUS;
+	}
+	if ((tx_pending & TX_LINK_STATUS) && link_room(LINK_STATUS_VALUES * 2)) {
+		// Verluste auf beiden Seiten der Leitung sichtbar machen
+		link_stats_t lnk;
+		rs232_status_t ser;
+		linkseq_stats_t seq;
+		link_get_stats(&lnk);
+		rs232_get_status(&ser);
+		linkseq_get_stats(&seq);
+		_Static_assert(LINK_STATUS_VALUES * 2 <= LINK_TX_MAX_PAYLOAD, "LINK_STATUS passt nicht in den Sendepuffer");
+		link_begin(LINK_FRAME_LINK_STATUS, LINK_STATUS_VALUES * 2);
+		link_u16(lnk.crc_errors);    // Verworfene Rahmen vom ESP8266
+		link_u16(ser.rx_overflows);  // Empfangspuffer voll
+		link_u16(ser.rx_errors);     // Hardware-Überlauf / Rahmenfehler
+		link_u16(seq.frames);        // Gesicherte Rahmen
+		link_u16(seq.retransmits);   // Wiederholungen
+		link_u16(seq.timeouts);      // Zeitüberschreitungen ohne ACK
+		link_u16(seq.resyncs);       // Neuabgleiche nach Neustart
+		link_u16(lnk.packet_bytes);  // Bytes des letzten Datenpakets
+		link_u16(lnk.packet_ms);     // Sendedauer des letzten Datenpakets
+		link_u16(ser.tx_waits);      // Aufrufe, die auf Platz im Sendepuffer warten mussten
+		link_u16(rs232_get_rate());  // Baudraten-Stufe (0 = 28800 ... 3 = 230400)
+		link_end();
+		tx_pending &= ~TX_LINK_STATUS;
+	}
+	#if DIAG_ENABLE
+	if ((tx_pending & TX_TASK_STATUS) && link_room(TASK_STATUS_LEN)) {
+		// Laufzeitbericht einer Aufgabe, mit jedem Rahmen die nächste
+		sched_task_stats_t tsk;
+		sched_stats_t sch;
+		sched_get_task_stats(tx_task, &tsk);
+		sched_get_stats(&sch);
+		link_begin(LINK_FRAME_TASK_STATUS, TASK_STATUS_LEN);
+		link_u8(tx_task);                // Aufgabe (TASK_*)
+		link_u8(sched_task_count());     // Anzahl Aufgaben
+		link_u16(tsk.runs);              // Aufrufe
+		link_u16(tsk.run_max);           // Längste Laufzeit (1/3600 s)
+		link_u16(tsk.late_max);          // Größte Verspätung (Ticks)
+		link_u16(tsk.overruns);          // Deadline überschritten
+		link_u8(sch.idle_pct);           // Idle-Anteil der CPU (%)
+		link_u16(sch.queue_overflows);   // Verlorene Ereignisse
+		link_end();
+		if (++tx_task >= sched_task_count()) tx_task = 0;
+		tx_pending &= ~TX_TASK_STATUS;
+	}
+	if ((tx_pending & TX_INPUT_STATUS) && link_room(INPUT_STATUS_VALUES * 2)) {
+		// Taster: Drücke und Zeit bis zum neuen Bild
+		button_stats_t btn;
+		button_get_stats(&btn);
+		link_begin(LINK_FRAME_INPUT_STATUS, INPUT_STATUS_VALUES * 2);
+		link_u16(btn.presses);           // Kurze Drücke
+		link_u16(btn.longs);             // Lange Drücke
+		link_u16(btn.repeats);           // Wiederholungen
+		link_u16(btn.dropped);           // Verworfene Ereignisse
+		link_u16(btn.latency_last_ms);   // Druck bis neues Bild (ms), letzter Druck
+		link_u16(btn.latency_max_ms);    // Druck bis neues Bild (ms), größter Wert
+		link_u16(btn.late);              // Drücke über BUTTON_LATENCY_MAX_MS
+		link_end();
+		tx_pending &= ~TX_INPUT_STATUS;
+	}
+	if ((tx_pending & TX_DRIVER_STATUS) && send_driver_status()) {
+		if (++tx_driver >= DRIVER_COUNT) tx_driver = 0;
+		tx_pending &= ~TX_DRIVER_STATUS;
+	}
+	if ((tx_pending & TX_RAM_STATUS) && link_room(RAM_STATUS_LEN)) {
+		// RAM: Summen, Stacktiefe und statischer RAM eines Moduls
+		ram_stats_t ram;
+		ram_get_stats(&ram);
+		link_begin(LINK_FRAME_RAM_STATUS, RAM_STATUS_LEN);
+		link_u16(ram.data);                          // .data (Bytes)
+		link_u16(ram.bss);                           // .bss (Bytes)
+		link_u16(ram.stack_max);                     // Größte Stacktiefe (Bytes)
+		link_u16(ram.headroom_min);                  // Kleinste Reserve (Bytes)
+		link_u8(tx_ram_mod);                         // Modul (RAM_MOD_*)
+		link_u8(RAM_MOD_COUNT);                      // Anzahl Module
+		link_u16(ram_module_bytes(tx_ram_mod));      // Statischer RAM des Moduls (Bytes)
+		link_end();
+		if (++tx_ram_mod >= RAM_MOD_COUNT) tx_ram_mod = 0;
+		tx_pending &= ~TX_RAM_STATUS;
+	}
+	#endif
+	#if PROFILE_ENABLE
+	while ((tx_pending & TX_PROFILE) && link_room(PROFILE_LEN)) {
+		// Laufzeitbericht: ein Rahmen je Messpunkt, so viele wie gerade in den Sendepuffer passen
+		profile_stats_t prf;
+		profile_get(prof_next, &prf);
+		link_begin(LINK_FRAME_PROFILE, PROFILE_LEN);
+		link_u8(prof_next);                                  // Messpunkt (PROF_*)
+		link_u8(PROF_COUNT);                                 // Anzahl Messpunkte
+		link_u16(prf.count);                                 // Messungen
+		link_u32(prf.min);                                   // CPU-Takte Minimum
+		link_u32(prf.max);                                   // CPU-Takte Maximum
+		link_u32(prf.count ? prf.sum / prf.count : 0);       // CPU-Takte Mittelwert
+		link_end();
+		if (++prof_next >= PROF_COUNT) {
+			if (prof_reset_after) profile_reset();
+			tx_pending &= ~TX_PROFILE;
+		}
+	}
+	#endif
+
+	// Verläufe und Bulk-Abschnitte zuletzt: ein hier begonnener Rahmen sperrt alle weiteren
+	busy |= send_series_step();
+	#if LINK_BULK
+	if (job_series == JOB_NONE)    busy |= send_chunk_step();
+	#endif
+	busy |= tx_pending;
+
+	#if TRACE_ENABLE
+	// Ablaufprotokoll nur in freier Zeit: kein anderer Rahmen offen oder vorgemerkt
+	while (!busy && trace_count()) {
+		uint8_t n = trace_count();
+		if (n > TRACE_FRAME_MAX) n = TRACE_FRAME_MAX;
+		if (!link_room(TRACE_FRAME_HEADER + n * 5)) break;
+		link_begin(LINK_FRAME_TRACE, TRACE_FRAME_HEADER + n * 5);
+		link_u32(timebase_counts());       // Sendezeitpunkt (ergänzt die 16-Bit-Zeitpunkte)
+		for (uint8_t i = 0; i < n; i++) {
+			trace_rec_t rec;
+			trace_take(&rec);
+			link_u8(rec.id);
+			link_u16(rec.time);
+			link_u8(rec.a);
+			link_u8(rec.b);
+		}
+		link_end();
+	}
+	#endif
+	#else
+	uint8_t busy = 0;
+	#endif
+
+	// Paketmessung endet, wenn alles im Sendepuffer gelandet und der Puffer leer ist
+	if (tx_measuring && !busy && rs232_tx_free() == RS232_TX_BUFFER_SIZE - 1) {
+		link_measure_end();
+		tx_measuring = 0;
+	}
+}
 
 // Sendet ein Datenpaket an den ESP8266
+// Binär: aktuelle Werte plus neue Verlaufspunkte (über send_pump, kehrt sofort zurück),
+// Text: d:X:Wert;Wert;... (kompletter Graph, wartet wenn der Sendepuffer voll ist)
+// Bytes und Sendedauer bis zum leeren Sendepuffer werden gemessen (link_get_stats)
 void send_data_packet(uint8_t page_num) {
+	if (!tx_measuring) {
+		link_measure_begin();
+		tx_measuring = 1;
+	}
+
+	#if LINK_BINARY
+	tx_page     = page_num;
+	tx_pending |= TX_CURRENT | pgm_read_byte(&tx_rotation[tx_status]);
+	if (++tx_status >= sizeof(tx_rotation)) tx_status = 0;
+	#else
 	// Header im Format: d:X: senden
 	rs232_putchar('d');           // Datenpaket-Kennung
 	rs232_putchar(':');           // Trennzeichen
@@ -223,80 +825,103 @@ void send_data_packet(uint8_t page_num) {
 	rs232_putchar(':');           // Trennzeichen
 
 	// Daten-Payload senden
-	if (page_num <= 4) {
+	if (page_num <= SERIES_COUNT) {
 		// Für Seiten 1-4: Graph-Daten senden (96 Werte)
-		for (uint8_t i = 0; i < DISPLAY_COUNT; i++) {
-			rs232_send_int_semicolon(dataGraph[i]);  // Wert + Semikolon senden
+		// Der geladene Verlauf ist schon in Pixelzeilen umgerechnet: in Bursts neu aus dem EEPROM lesen
+		for (uint8_t i = 0; i < DISPLAY_COUNT; i += SERIES_BURST) {
+			int16_t buf[SERIES_BURST];
+			storage_series_read(page_num - 1, i, SERIES_BURST, buf);
+			for (uint8_t k = 0; k < SERIES_BURST; k++) {
+				rs232_send_int_semicolon(buf[k]);  // Wert + Semikolon senden
+			}
 		}
 	} else {
 		// Für Seite 5: Aktuelle Werte senden
+		update_current_values(SAMPLE_MAX_AGE_SERIAL_MS);
 		rs232_send_int_semicolon(dataT);  // Temperatur senden
-		rs232_send_int_semicolon(dataP);  // Druck senden
+		rs232_send_uint_semicolon(dataP); // Druck senden
+		rs232_send_uint_semicolon(dataH); // Feuchte senden
 	}
 	// Paket mit Newline abschließen
 	rs232_putchar('\n');
+	send_status_packet();
+	#endif
 }
 
-// Timer1 für Zeitmessung initialisieren
-void timer1_init(void) {
-	TCCR1B |= (1 << WGM12);           // CTC-Modus (Clear Timer on Compare Match)
-	TCCR1B |= (1 << CS12) | (1 << CS10); // Prescaler 1024 (bei 3.6864 MHz = ~1 Sekunde)
-	OCR1A   = 3599;                   // Compare-Wert für ~1 Sekunde Intervall
-	TIMSK  |= (1 << OCIE1A);          // Timer1 Compare A Interrupt aktivieren
+#if !LINK_BINARY
+// 32-Bit-Wert mit Semikolon senden (Textformat)
+static void send_u32_semicolon(uint32_t value) {
+	char buf[FMT_U32_LEN];
+	fmt_u32(value, buf);
+	rs232_puts(buf);
+	rs232_putchar(';');
 }
+#endif
 
-// Speichert einen Sensorwert im EEPROM
-void store_sensor_value(uint16_t base_addr, uint8_t index, uint32_t ts, int16_t temp, uint16_t press) {
-	SensorValue val;  // Temporäre Struktur für die Daten
-	val.timestamp = ts;    // Zeitstempel setzen
-	val.temp      = temp;  // Temperatur setzen
-	val.press     = press; // Druck setzen
-	
-	// Adresse im EEPROM berechnen (Basis + Index * Größe der Struktur)
-	uint16_t addr = base_addr + index * sizeof(SensorValue);
-	
-	// Struktur ins EEPROM schreiben
-	eeprom_write_block(addr, (uint8_t*)&val, sizeof(SensorValue));
-}
+// Sendet die Fehlerzähler an den ESP8266
+// Reihenfolge: I2C-Fehler; I2C-Timeouts; Bus-Recoveries; Messlücken; Filter-Takte;
+//              EEPROM-Schreibvorgänge; Eingespart; Lebensdauer-Tage; Intervall (u16);
+//              Anfragen an den Messwert-Cache; davon aus dem Cache beantwortet (u32)
+// Binär als LINK_FRAME_STATUS, Text als s:Wert;Wert;...
+// Paket-Bytes, Paket-Dauer (ms), Warten auf den Sendepuffer und Baudraten-Stufe stehen binär
+// im LINK_STATUS-Rahmen (der STATUS-Rahmen wäre sonst zu lang), im Textformat am Ende von s:
+void send_status_packet(void) {
+	i2c_stats_t     i2c;  // I2C-Zähler
+	sample_stats_t  smp;  // Cache-Zähler (enthält die Lücken)
+	filter_stats_t  flt;  // Filter-Laufzeit
+	storage_stats_t sto;  // EEPROM-Schreibstatistik
+	i2c_get_stats(&i2c);
+	sample_get_stats(&smp);
+	filter_get_stats(&flt);
+	storage_get_stats(&sto, timebase_seconds());
 
-// Liest mehrere Rohwerte aus dem EEPROM und summiert sie
-void read_raw_values(uint16_t base_addr, uint8_t count, int32_t* temp_sum, uint32_t* press_sum, uint32_t* time_sum) {
-	SensorValue val;  // Temporäre Struktur für gelesene Daten
-	
-	// Summen initialisieren
-	*temp_sum = 0; *press_sum = 0; *time_sum = 0;
-	
-	// Alle Werte lesen und summieren
-	for (uint8_t i = 0; i < count; i++) {
-		uint16_t addr = base_addr + i * sizeof(SensorValue);  // Adresse berechnen
-		eeprom_read_block(addr, (uint8_t*)&val, sizeof(SensorValue));  // Daten lesen
-		*temp_sum  += val.temp;      // Temperatur addieren
-		*press_sum += val.press;     // Druck addieren
-		*time_sum  += val.timestamp; // Zeitstempel addieren
-	}
-}
+	const uint16_t values[] = {
+		i2c.errors,          // Alle I2C-Fehler
+		i2c.timeouts,        // Davon Timeouts
+		i2c.recoveries,      // Bus-Recovery-Sequenzen
+		smp.gaps,            // Messungen ohne Sensor-Antwort
+		flt.cycles_max,      // Maximale Filter-Laufzeit in CPU-Takten
+		sto.writes,          // Geschriebene Datensätze
+		sto.writes_avoided > 0xFFFF ? 0xFFFF : (uint16_t)sto.writes_avoided,  // Eingesparte Rohdatensätze (bleibt bei 65535 stehen, genau: DRIVER_STATUS)
+		sto.lifetime_days,   // Hochgerechnete EEPROM-Lebensdauer
+		sto.interval_s,      // Aktuelles Abtastintervall
+	};
+	const uint8_t count = sizeof(values) / sizeof(values[0]);
+	_Static_assert(sizeof(values) / sizeof(values[0]) == STATUS_VALUES, "STATUS_VALUES anpassen");
+	_Static_assert(STATUS_LEN <= LINK_TX_MAX_PAYLOAD, "Statuspaket passt nicht in den Sendepuffer");
 
-// Lädt Daten für Display-Graphen basierend auf der gewählten Seite
-void loadDataGraph(uint8_t mode) {
-	uint16_t base_addr;  // Basis-Adresse im EEPROM
-	uint8_t  idx;        // Aktueller Index
-	bool     wantTemp;   // Flag: Temperatur oder Druck?
-
-	// Konfiguration basierend auf der Seite
-	switch (mode) {
-		case 1: base_addr = EEPROM_ADDR_24H; idx = index_24h; wantTemp = true;  break;  // Temp 24h
-		case 2: base_addr = EEPROM_ADDR_24H; idx = index_24h; wantTemp = false; break;  // Druck 24h
-		case 3: base_addr = EEPROM_ADDR_7D;  idx = index_7d;  wantTemp = true;  break;  // Temp 7 Tage
-		case 4: base_addr = EEPROM_ADDR_7D;  idx = index_7d;  wantTemp = false; break;  // Druck 7 Tage
-		default: return;  // Ungültige Seite
-	}
+	#if LINK_BINARY
+	link_begin(LINK_FRAME_STATUS, STATUS_LEN);
+	for (uint8_t i = 0; i < count; i++) link_u16(values[i]);
+	link_u32(smp.requests);  // Anfragen an den Messwert-Cache
+	link_u32(smp.saved);     // Davon ohne Sensor-Abfrage beantwortet
+	link_end();
+	#else
+	link_stats_t   lnk;  // Bytes und Dauer des letzten Datenpakets
+	rs232_status_t ser;  // Sendepuffer
+	link_get_stats(&lnk);
+	rs232_get_status(&ser);
+	rs232_putchar('s');  // Statuspaket-Kennung
+	rs232_putchar(':');  // Trennzeichen
+	for (uint8_t i = 0; i < count; i++) rs232_send_uint_semicolon(values[i]);
+	send_u32_semicolon(smp.requests);
+	send_u32_semicolon(smp.saved);
+	rs232_send_uint_semicolon(lnk.packet_bytes);
+	rs232_send_uint_semicolon(lnk.packet_ms);
+	rs232_send_uint_semicolon(ser.tx_waits);
+	rs232_send_uint_semicolon(rs232_get_rate());
+	rs232_putchar('\n');
+	#endif
+}
 
-	// 96 Datenpunkte für Display laden (rückwärts, da neueste Daten zuerst)
-	for (uint8_t i = 0; i < DISPLAY_COUNT; i++) {
-		uint8_t j = (idx + DISPLAY_COUNT - 1 - i) % DISPLAY_COUNT;  // Index rückwärts berechnen
-		SensorValue sv;  // Temporäre Struktur
-		uint16_t    addr = base_addr + j * sizeof(SensorValue);  // EEPROM-Adresse
-		eeprom_read_block(addr, (uint8_t*)&sv, sizeof(sv));  // Daten lesen
-		dataGraph[i] = wantTemp ? sv.temp : (int16_t)sv.press;  // Temperatur oder Druck speichern
-	}
-}
\ No newline at end of file
+// Aktualisiert dataT/dataP/dataH aus dem Messwert-Cache
+// Der Sensor wird nur abgefragt, wenn die letzte Messung älter als max_age_ms ist
+// Bei einer Lücke (SAMPLE_GAP) bleiben die zuletzt gültigen Werte auf dem Display stehen
+// Rückgabe: Zustand der Messung (SAMPLE_OK oder SAMPLE_GAP)
+uint8_t update_current_values(uint16_t max_age_ms) {
+	const sample_t* s = sample_get(timebase_ms(), max_age_ms);
+	dataT = s->temp;   // Temperatur übernehmen
+	dataP = s->press;  // Druck übernehmen
+	dataH = s->hum;    // Feuchte übernehmen
+	return s->status;
+}
@@ -4,25 +4,24 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
+#include "fmt.h"
 
-/* Hilfsfunktion: Zahl ? ASCII */
+/* Hilfsfunktion: Zahl ? ASCII
+ * Basis 10 ber fmt.c (ohne Division), Basis 16 ber Nibbles */
 static char* itoa_simple(uint32_t value, char *buf, int base, int is_signed) {
-    char *p = buf, *p1 = buf, tmp;
-    uint32_t u = value;
-    if (is_signed && ((int32_t)value) < 0) {
-        *p++ = '-';
-        p1++;
-        u = (uint32_t)(-((int32_t)value));
+    if (base == 10) {
+        if (is_signed) fmt_i32((int32_t)value, buf);
+        else           fmt_u32(value, buf);
+        return buf;
     }
-    do {
-        int digit = u % base;
+    char *p = buf;
+    int shift = 28;
+    while (shift > 0 && !(value >> shift)) shift -= 4;  /* Fhrende Nullen weglassen */
+    for (; shift >= 0; shift -= 4) {
+        int digit = (value >> shift) & 0x0F;
         *p++ = (digit < 10 ? '0' + digit : 'a' + digit - 10);
-        u /= base;
-    } while (u);
-    *p = '\0';
-    for (--p; p1 < p; ++p1, --p) {
-        tmp = *p; *p = *p1; *p1 = tmp;
     }
+    *p = '\0';
     return buf;
 }
 
@@ -0,0 +1,64 @@
+/*
+ * pack.c
+ *
+ * Kompression der Datensätze beim Bulk-Export
+ * Wetterdaten ändern sich zwischen zwei Datensätzen kaum: der Zeitabstand ist
+ * meist gleich, Feuchte und Druck oft unverändert. Unveränderte Felder kosten
+ * nur 2 Bit im Kopfbyte. Kein Wörterbuch, kein Puffer: der Zustand ist nur der
+ * vorherige Datensatz (12 Bytes RAM)
+ *
+ * Created: 18.10.2026 15:02:41
+ *  Author: morri
+ */
+
+#include <string.h>
+#include "pack.h"
+#include "link.h"
+
+#if LINK_PACK
+
+// Zeitstempel sind 24 Bit breit und laufen über
+#define TS_MASK   0xFFFFFFUL
+
+// Differenz als Zigzag mit 0, 1, 2 oder 4 Bytes schreiben
+// Zigzag: 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 (kleine Beträge = wenige Bytes)
+// Rückgabe: Längenkennung für das Kopfbyte (0..3)
+static uint8_t put_field(uint8_t* out, uint8_t* n, int32_t value) {
+	uint32_t z = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+	uint8_t tag = (z == 0) ? 0 : (z < 0x100) ? 1 : (z < 0x10000) ? 2 : 3;
+	uint8_t len = (tag == 3) ? 4 : tag;
+	for (uint8_t i = 0; i < len; i++) {
+		out[(*n)++] = (uint8_t)z;
+		z >>= 8;
+	}
+	return tag;
+}
+
+// Zustand zurücksetzen
+void pack_init(pack_state_t* st) {
+	memset(st, 0, sizeof(*st));
+}
+
+// Einen Datensatz kodieren: Kopfbyte, dann Zeit (Differenz der Abstände), Feuchte, Temperatur, Druck
+// Kopfbyte: Bit 0-1 Zeit, 2-3 Feuchte, 4-5 Temperatur, 6-7 Druck
+uint8_t pack_record(pack_state_t* st, const SensorValue* v, uint8_t* out) {
+	uint32_t ts = v->timestamp;
+	int32_t dts = (int32_t)(((ts - st->ts) & TS_MASK) << 8) >> 8;  // 24-Bit-Differenz mit Vorzeichen
+	uint8_t n = 1;
+	uint8_t head;
+
+	head  = put_field(out, &n, dts - st->dts);
+	head |= put_field(out, &n, (int16_t)v->hum - st->hum) << 2;
+	head |= put_field(out, &n, (int32_t)v->temp - st->temp) << 4;
+	head |= put_field(out, &n, (int32_t)v->press - st->press) << 6;
+	out[0] = head;
+
+	st->ts    = ts;
+	st->dts   = dts;
+	st->hum   = v->hum;
+	st->temp  = v->temp;
+	st->press = v->press;
+	return n;
+}
+
+#endif
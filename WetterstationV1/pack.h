@@ -0,0 +1,39 @@
+/*
+ * pack.h
+ *
+ * Header-Datei für die Kompression der Datensätze beim Bulk-Export
+ * Jeder Datensatz wird als Differenz zum vorherigen kodiert (Zeitstempel als
+ * Differenz der Abstände). Ein Kopfbyte enthält je Feld 2 Bit Länge
+ * (0, 1, 2 oder 4 Bytes), danach folgen die Differenzen als Zigzag, Little Endian
+ *
+ * Created: 18.10.2026 15:02:41
+ *  Author: morri
+ */
+
+#ifndef PACK_H_
+#define PACK_H_
+
+#include <stdint.h>
+#include "storage.h"
+
+// Längste Kodierung eines Datensatzes (Kopf 1, Zeit 4, Feuchte 2, Temperatur 4, Druck 4 Bytes)
+#define PACK_MAX_RECORD    15
+
+// Zustand des Kodierers (vorheriger Datensatz)
+// Der Dekodierer auf dem ESP8266 führt denselben Zustand mit
+typedef struct {
+	uint32_t ts;      // Zeitstempel (24 Bit)
+	int32_t  dts;     // Abstand zum vorletzten Zeitstempel
+	uint8_t  hum;
+	int16_t  temp;
+	uint16_t press;
+} pack_state_t;
+
+// Zustand zurücksetzen (am Anfang jedes Abschnitts)
+void pack_init(pack_state_t* st);
+
+// Einen Datensatz kodieren
+// out muss PACK_MAX_RECORD Bytes fassen, Rückgabe: Anzahl geschriebener Bytes
+uint8_t pack_record(pack_state_t* st, const SensorValue* v, uint8_t* out);
+
+#endif /* PACK_H_ */
@@ -0,0 +1,81 @@
+/*
+ * profile.c
+ *
+ * Laufzeitmessung der Verarbeitungsstufen
+ * Timer2 zählt mit Takt/8, jeder Überlauf (alle 2048 Takte) erhöht den
+ * oberen Teil des Zählers. Timer2 ist sonst unbenutzt, Timer0 (Filter-
+ * Laufzeit) und Timer1 (Zeitbasis) bleiben unverändert.
+ *
+ * Created: 18.10.2026 18:57:40
+ *  Author: morri
+ */
+
+#include "profile.h"
+
+#if PROFILE_ENABLE
+
+#include <avr/interrupt.h>
+#include "hal.h"
+
+static volatile uint16_t cycles_hi;  // Überläufe von Timer2
+static uint8_t overhead;             // Takte einer leeren Messung
+
+static profile_stats_t stats[PROF_COUNT];
+
+ISR(TIMER2_OVF_vect) {
+	cycles_hi++;
+}
+
+void profile_init(void) {
+	hal_timer2_init();
+
+	// Aufwand einer leeren Messung (Aufruf und Lesen des Zählers)
+	uint8_t sreg = SREG;
+	sei();
+	uint32_t start = profile_cycles();
+	overhead = (profile_cycles() - start) & PROFILE_CYCLE_MASK;
+	SREG = sreg;
+	profile_reset();
+}
+
+uint32_t profile_cycles(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t hi = cycles_hi;
+	uint8_t  lo = hal_timer2_count();
+	// Überlauf schon passiert, ISR aber noch nicht gelaufen
+	if (hal_timer2_pending() && lo < 0x80) hi++;
+	SREG = sreg;
+	return (((uint32_t)hi << 8) | lo) << 3;
+}
+
+void profile_add(uint8_t probe, uint32_t cycles) {
+	profile_stats_t* s = &stats[probe];
+	cycles &= PROFILE_CYCLE_MASK;
+	cycles = cycles > overhead ? cycles - overhead : 0;
+
+	// Summe und Anzahl halbieren, bevor eines überläuft (Mittelwert bleibt erhalten)
+	if (s->count == 0xFFFF || s->sum > 0xFFFFFFFFUL - cycles) {
+		s->count >>= 1;
+		s->sum   >>= 1;
+	}
+	if (!s->count || cycles < s->min) s->min = cycles;
+	if (cycles > s->max)              s->max = cycles;
+	s->count++;
+	s->sum += cycles;
+}
+
+void profile_get(uint8_t probe, profile_stats_t* out) {
+	*out = stats[probe];
+}
+
+void profile_reset(void) {
+	for (uint8_t i = 0; i < PROF_COUNT; i++) {
+		stats[i].count = 0;
+		stats[i].min   = 0;
+		stats[i].max   = 0;
+		stats[i].sum   = 0;
+	}
+}
+
+#endif
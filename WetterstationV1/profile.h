@@ -0,0 +1,73 @@
+/*
+ * profile.h
+ *
+ * Header-Datei für die Laufzeitmessung der Verarbeitungsstufen
+ * Messpunkte stehen mit PROFILE_BEGIN/PROFILE_END um die Stufen (Rendern,
+ * Display-Transfer, Speichern, ...). Gemessen wird mit Timer2 (Takt/8,
+ * Überlauf in Software verlängert), je Messpunkt werden Anzahl, Minimum,
+ * Maximum und Summe der CPU-Takte im RAM gesammelt.
+ *
+ * Mit PROFILE_ENABLE 0 (Standard) werden die Makros zu nichts, Timer2 und
+ * der RAM für die Statistik bleiben unbenutzt.
+ *
+ * Created: 18.10.2026 18:57:40
+ *  Author: morri
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+
+// Laufzeitmessung ein-/ausschalten (zur Compile-Zeit, z.B. -DPROFILE_ENABLE=1)
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE     0
+#endif
+
+// Messpunkte (Reihenfolge = Nummer im PROFILE-Rahmen, Namen auf der Webseite)
+#define PROF_LOAD_GRAPH    0  // storage_load_graph(): Verlauf aus dem EEPROM laden
+#define PROF_RENDER        1  // renderScene(): eine Display-Seite zeichnen
+#define PROF_LCD_WRITE     2  // ks0108_write_page(): eine Seite zum Display übertragen
+#define PROF_SEND_PACKET   3  // send_data_packet(): Datenpaket vormerken bzw. senden (Text)
+#define PROF_SENSOR        4  // update_current_values(): Sensor abfragen (oder Cache)
+#define PROF_STORE         5  // storage_add_sample(): Filter-Ergebnis speichern (EEPROM)
+#define PROF_COUNT         6
+
+// Statistik eines Messpunkts (CPU-Takte, Auflösung 8 Takte)
+typedef struct {
+	uint16_t count;   // Messungen
+	uint32_t min;     // Kürzeste Laufzeit
+	uint32_t max;     // Längste Laufzeit
+	uint32_t sum;     // Summe (wird mit count halbiert, bevor sie überläuft)
+} profile_stats_t;
+
+#if PROFILE_ENABLE
+
+// Timer2 starten und den Aufwand einer leeren Messung bestimmen
+void profile_init(void);
+
+// CPU-Takte seit dem Start, 27 Bit (läuft nach ca. 36 s über, nur Differenzen verwenden)
+uint32_t profile_cycles(void);
+#define PROFILE_CYCLE_MASK  0x07FFFFFFUL
+
+// Eine Messung eintragen (Differenz zweier profile_cycles(), wird auf 27 Bit maskiert)
+// Der Aufwand der Messung selbst wird abgezogen
+void profile_add(uint8_t probe, uint32_t cycles);
+
+// Statistik eines Messpunkts abrufen, alle Messpunkte zurücksetzen
+void profile_get(uint8_t probe, profile_stats_t* stats);
+void profile_reset(void);
+
+#define PROFILE_INIT()      profile_init()
+#define PROFILE_BEGIN(p)    uint32_t prof_start_##p = profile_cycles()
+#define PROFILE_END(p)      profile_add(p, profile_cycles() - prof_start_##p)
+
+#else
+
+#define PROFILE_INIT()      ((void)0)
+#define PROFILE_BEGIN(p)    ((void)0)
+#define PROFILE_END(p)      ((void)0)
+
+#endif
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,73 @@
+/*
+ * ram.c
+ *
+ * RAM-Überwachung: Füllmuster beim Start, Stacktiefe, statischer RAM je Modul
+ * Nur mit DIAG_ENABLE (diag.h), sonst bleibt das Modul leer.
+ *
+ * Created: 18.10.2026 19:41:12
+ *  Author: morri
+ */
+
+#include <avr/io.h>
+#include "ram.h"
+#include "diag.h"
+
+#if DIAG_ENABLE
+
+// Grenzen aus dem Linker-Skript
+extern uint8_t __data_start, __data_end;
+extern uint8_t __bss_start, __bss_end;
+extern uint8_t __heap_start;  // Erstes freies Byte nach allen Variablen
+
+// Einträge der Module (RAM_ACCOUNT)
+extern const uint16_t ram_account_main PROGMEM;
+extern const uint16_t ram_account_display PROGMEM;
+extern const uint16_t ram_account_rs232 PROGMEM;
+extern const uint16_t ram_account_link PROGMEM;
+extern const uint16_t ram_account_linkseq PROGMEM;
+extern const uint16_t ram_account_sched PROGMEM;
+extern const uint16_t ram_account_button PROGMEM;
+extern const uint16_t ram_account_storage PROGMEM;
+extern const uint16_t ram_account_sample PROGMEM;
+extern const uint16_t ram_account_filter PROGMEM;
+extern const uint16_t ram_account_arena PROGMEM;
+extern const uint16_t ram_account_trace PROGMEM;
+
+static const uint16_t* const accounts[RAM_MOD_COUNT] PROGMEM = {
+	&ram_account_main, &ram_account_display, &ram_account_rs232, &ram_account_link,
+	&ram_account_linkseq, &ram_account_sched, &ram_account_button, &ram_account_storage,
+	&ram_account_sample, &ram_account_filter, &ram_account_arena, &ram_account_trace
+};
+
+static uint16_t headroom_min;  // Ergebnis des letzten ram_scan()
+
+// Freien RAM bis RAMEND mit dem Muster füllen
+// Läuft in .init3: der Stackpointer steht schon, .data/.bss werden erst danach
+// initialisiert (liegen unterhalb von __heap_start, werden also nicht berührt).
+// Noch ist nichts auf dem Stack, ohne Prolog/Epilog (naked) fällt der Code in .init4 durch.
+void ram_paint(void) __attribute__((naked, used, section(".init3")));
+void ram_paint(void) {
+	uint8_t* p = &__heap_start;
+	while (p <= (uint8_t*)RAMEND) *p++ = RAM_CANARY;
+}
+
+uint16_t ram_scan(void) {
+	const uint8_t* p = &__heap_start;
+	while (p <= (const uint8_t*)RAMEND && *p == RAM_CANARY) p++;
+	headroom_min = p - &__heap_start;
+	return headroom_min;
+}
+
+void ram_get_stats(ram_stats_t* stats) {
+	stats->data         = &__data_end - &__data_start;
+	stats->bss          = &__bss_end - &__bss_start;
+	stats->stack_max    = (uint8_t*)RAMEND + 1 - &__heap_start - headroom_min;
+	stats->headroom_min = headroom_min;
+}
+
+uint16_t ram_module_bytes(uint8_t mod) {
+	if (mod >= RAM_MOD_COUNT) return 0;
+	return pgm_read_word((const uint16_t*)pgm_read_ptr(&accounts[mod]));
+}
+
+#endif
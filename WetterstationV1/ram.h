@@ -0,0 +1,64 @@
+/*
+ * ram.h
+ *
+ * Header-Datei für die RAM-Überwachung
+ * Beim Start wird der freie RAM zwischen den statischen Variablen (.data/.bss)
+ * und dem Stack mit einem Muster gefüllt. Was der Stack einmal benutzt hat,
+ * trägt das Muster nicht mehr: ram_scan() zählt von unten die unberührten
+ * Bytes und liefert so die kleinste Reserve seit dem Start (inklusive ISRs).
+ *
+ * Module mit größeren Puffern melden ihren statischen RAM mit RAM_ACCOUNT
+ * (Konstante im Flash, kostet keinen RAM). Die Summe enthält jede statische
+ * Variable des Moduls, auch Zähler und Positionen. Der Rest der Summe aus .data
+ * und .bss gehört den Treibern und Modulen ohne eigenen Eintrag.
+ *
+ * Created: 18.10.2026 19:41:12
+ *  Author: morri
+ */
+
+#ifndef RAM_H_
+#define RAM_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+// Füllmuster des freien RAMs
+#define RAM_CANARY         0xC5
+
+// Module mit eigenem Eintrag (Reihenfolge = Nummer im RAM_STATUS-Rahmen, Namen auf der Webseite)
+#define RAM_MOD_MAIN       0  // Befehlspuffer, Sendeaufträge
+#define RAM_MOD_DISPLAY    1  // Wertebereich des Verlaufs
+#define RAM_MOD_RS232      2  // Empfangs- und Sendepuffer
+#define RAM_MOD_LINK       3  // Empfangsrahmen
+#define RAM_MOD_LINKSEQ    4  // Fenster unbestätigter Rahmen
+#define RAM_MOD_SCHED      5  // Aufgabentabelle, Ereignis-Warteschlange
+#define RAM_MOD_BUTTON     6  // Ereignis-Warteschlange
+#define RAM_MOD_STORAGE    7  // Mittelwert-Akkumulatoren
+#define RAM_MOD_SAMPLE     8  // Messwert-Cache
+#define RAM_MOD_FILTER     9  // Median- und IIR-Zustand
+#define RAM_MOD_ARENA      10 // Gemeinsamer Bereich: Verlauf, Seitenpuffer, Kalibrierdaten (arena.h)
+#define RAM_MOD_TRACE      11 // Ablaufprotokoll (trace.h)
+#define RAM_MOD_COUNT      12
+
+// Statischen RAM eines Moduls melden (im Modul, nach den gezählten Variablen)
+#define RAM_ACCOUNT(mod, bytes)  const uint16_t ram_account_##mod PROGMEM = (bytes)
+
+// RAM-Statistik (Bytes, nur mit DIAG_ENABLE, diag.h)
+typedef struct {
+	uint16_t data;          // Initialisierte Variablen (.data)
+	uint16_t bss;           // Mit 0 initialisierte Variablen (.bss)
+	uint16_t stack_max;     // Größte Stacktiefe seit dem Start (inklusive ISRs)
+	uint16_t headroom_min;  // Kleinste Reserve zwischen Variablen und Stack seit dem Start
+} ram_stats_t;
+
+// Unberührte Bytes des Füllmusters zählen (Dauer proportional zur Reserve)
+// Rückgabe: kleinste Reserve seit dem Start
+uint16_t ram_scan(void);
+
+// Statistik abrufen (mit dem Stand des letzten ram_scan())
+void ram_get_stats(ram_stats_t* stats);
+
+// Statischer RAM eines Moduls (RAM_MOD_*)
+uint16_t ram_module_bytes(uint8_t mod);
+
+#endif /* RAM_H_ */
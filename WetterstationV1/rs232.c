@@ -9,73 +9,159 @@
  */ 
 //#define F_CPU 3686400UL
 
-#include <avr/io.h>
-#include <avr/interrupt.h>
 #include <string.h>
+#include "hal.h"
 #include "rs232.h"
+#include "fmt.h"
+#include "sched.h"
+#include "ram.h"
 
 // UART-Puffer für eingehende Daten vom ESP8266
 // Ringpuffer-Implementierung für effiziente Datenverwaltung
-volatile uint8_t uart_rx_buffer[UART_RX_BUFFER_SIZE];
-volatile uint8_t uart_rx_head = 0;  // Schreibposition im Puffer
-volatile uint8_t uart_rx_tail = 0;  // Leseposition im Puffer
+volatile uint8_t rs232_rx_buffer[RS232_RX_BUFFER_SIZE];
+volatile uint8_t rs232_rx_head = 0;  // Schreibposition im Puffer
+volatile uint8_t rs232_rx_tail = 0;  // Leseposition im Puffer
+
+// Sendepuffer (wird vom UDRE-Interrupt geleert)
+// Head schreibt nur das Hauptprogramm, Tail nur die ISR
+volatile uint8_t rs232_tx_buffer[RS232_TX_BUFFER_SIZE];
+volatile uint8_t rs232_tx_head = 0;  // Schreibposition im Puffer
+volatile uint8_t rs232_tx_tail = 0;  // Leseposition im Puffer
+
+// Zähler für die Statusabfrage
+static rs232_status_t rs232_status;
+
+static uint8_t rs232_rate;                 // Aktuelle Baudraten-Stufe
+static volatile uint8_t rs232_tx_started;  // 1 = seit dem letzten TXC wurde gesendet
+
+RAM_ACCOUNT(rs232, sizeof(rs232_rx_buffer) + sizeof(rs232_rx_head) + sizeof(rs232_rx_tail)
+                   + sizeof(rs232_tx_buffer) + sizeof(rs232_tx_head) + sizeof(rs232_tx_tail)
+                   + sizeof(rs232_status) + sizeof(rs232_rate) + sizeof(rs232_tx_started));
 
 // UART-Initialisierung für Kommunikation mit ESP8266
 // Konfiguriert Baudrate, Datenbits, Stoppbits und Interrupts
-void uart_init(void) {
+void rs232_init(void) {
 	// UBRR (USART Baud Rate Register) berechnen
 	// Formel: UBRR = (F_CPU / (16 * BAUD)) - 1
-	// Bei 3.6864 MHz und 9600 Baud: UBRR = (3686400 / (16 * 9600)) - 1 = 23
-	UBRRH = 0;  // High-Byte des UBRR (0 bei 9600 Baud)
-	UBRRL = 23; // Low-Byte des UBRR
-	
-	// UCSRC (USART Control and Status Register C) konfigurieren
-	// URSEL = 1 (UCSRC wird geschrieben), UCSZ1:0 = 11 (8 Datenbits), USBS = 0 (1 Stoppbit)
-	UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0);
-	
-	// UCSRB (USART Control and Status Register B) konfigurieren
-	// RXEN = 1 (Receiver Enable), TXEN = 1 (Transmitter Enable), RXCIE = 1 (RX Complete Interrupt Enable)
-	UCSRB = (1 << RXEN) | (1 << TXEN) | (1 << RXCIE);
+	// Bei 3.6864 MHz und 28800 Baud: UBRR = (3686400 / (16 * 28800)) - 1 = 7
+	// 8 Datenbits, 1 Stoppbit, Sender, Empfänger und Empfangs-Interrupt an
+	hal_uart_init((F_CPU / (16UL * RS232_BAUDRATE)) - 1);
+}
+
+// Nächstes Byte aus dem Sendepuffer ins UDR schreiben
+// Aufruf nur bei gesetztem UDRE (aus der ISR oder mit gesperrten Interrupts)
+static inline void rs232_tx_next(void) {
+	if (rs232_tx_tail != rs232_tx_head) {
+		rs232_tx_started = 1;
+		hal_uart_put(rs232_tx_buffer[rs232_tx_tail]);  // Löscht TXC, wird nach diesem Byte wieder gesetzt
+		rs232_tx_tail = (rs232_tx_tail + 1) % RS232_TX_BUFFER_SIZE;
+	} else {
+		hal_uart_udre_irq(0);  // Puffer leer: Interrupt abschalten
+	}
+}
+
+// USART Data Register Empty Interrupt Service Routine
+// Wird aufgerufen, sobald das UDR ein neues Byte aufnehmen kann
+ISR(USART_UDRE_vect) {
+	rs232_tx_next();
+}
+
+// Freie Bytes im Sendepuffer (ein Platz bleibt frei, damit voll und leer unterscheidbar sind)
+uint8_t rs232_tx_free(void) {
+	return (uint8_t)(rs232_tx_tail - rs232_tx_head - 1) % RS232_TX_BUFFER_SIZE;
+}
+
+// Ein Byte in den Sendepuffer stellen, 0 = Puffer voll
+static uint8_t rs232_enqueue(uint8_t data) {
+	uint8_t next_head = (rs232_tx_head + 1) % RS232_TX_BUFFER_SIZE;
+	if (next_head == rs232_tx_tail) return 0;
+
+	rs232_tx_buffer[rs232_tx_head] = data;
+	rs232_tx_head = next_head;
+	hal_uart_udre_irq(1);  // Interrupt einschalten (löst sofort aus, wenn UDR frei ist)
+	rs232_status.bytes_sent++;
+
+	uint8_t fill = RS232_TX_BUFFER_SIZE - 1 - rs232_tx_free();
+	if (fill > rs232_status.tx_peak) rs232_status.tx_peak = fill;
+	return 1;
+}
+
+// Ein Byte in den Sendepuffer schreiben (nicht blockierend)
+uint8_t rs232_write(uint8_t data) {
+	if (rs232_enqueue(data)) return 1;
+	rs232_status.tx_full++;
+	return 0;  // Puffer voll: Aufrufer entscheidet, ob er später erneut sendet
 }
 
 // Ein Byte über UART senden (blockierend)
-// Wartet bis der Transmitter bereit ist
-void uart_putc(uint8_t data) {
-	// Warten bis UDRE (USART Data Register Empty) gesetzt ist
-	// Das bedeutet, der Transmitter ist bereit für neue Daten
-	while (!(UCSRA & (1 << UDRE)));
-	
-	UDR = data;  // Daten in USART Data Register schreiben
+// Wartet nur, wenn der Sendepuffer voll ist
+void rs232_putchar(uint8_t data) {
+	if (rs232_enqueue(data)) return;
+	rs232_status.tx_waits++;
+
+	while (!rs232_enqueue(data)) {
+		// Interrupts gesperrt (z.B. vor sei()): Puffer selbst weiterschieben
+		if (!(SREG & (1 << SREG_I)) && hal_uart_tx_free()) {
+			rs232_tx_next();
+		}
+	}
+}
+
+// Warten bis alles gesendet ist
+void rs232_flush_tx(void) {
+	while (rs232_tx_head != rs232_tx_tail);  // Puffer wird von der ISR geleert
+	if (rs232_tx_started) {
+		while (!hal_uart_tx_done());         // Schieberegister leer
+		rs232_tx_started = 0;
+	}
+}
+
+// Baudrate umschalten
+void rs232_set_rate(uint8_t rate) {
+	if (rate >= RS232_RATE_COUNT) return;
+	rs232_flush_tx();  // Kein Byte mit zwei verschiedenen Raten senden
+
+	if (rate == 0) {
+		hal_uart_baud((F_CPU / (16UL * RS232_BAUDRATE)) - 1, 0);          // Normale Abtastung (16-fach): 7
+	} else {
+		hal_uart_baud((F_CPU / (8UL * RS232_RATE_BAUD(rate))) - 1, 1);    // Doppelte Geschwindigkeit (8-fach): 7, 3, 1
+	}
+	rs232_rate = rate;
+}
+
+// Aktuelle Baudraten-Stufe
+uint8_t rs232_get_rate(void) {
+	return rs232_rate;
 }
 
 // Ein String über UART senden (blockierend)
 // Sendet Zeichen für Zeichen bis zum Null-Terminator
-void uart_puts(const char* str) {
+void rs232_puts(const char* str) {
 	while (*str) {  // Schleife bis Null-Terminator erreicht ist
-		uart_putc(*str++);  // Aktuelles Zeichen senden und Pointer erhöhen
+		rs232_putchar(*str++);  // Aktuelles Zeichen senden und Pointer erhöhen
 	}
 }
 
 // Prüfen ob Daten im Empfangspuffer verfügbar sind
 // Gibt 1 zurück wenn Daten vorhanden, sonst 0
-uint8_t uart_available(void) {
+uint8_t rs232_data_ready(void) {
 	// Wenn Head und Tail unterschiedlich sind, sind Daten im Puffer
-	return (uart_rx_head != uart_rx_tail);
+	return (rs232_rx_head != rs232_rx_tail);
 }
 
 // Ein Byte aus dem Empfangspuffer lesen
 // Gibt 0 zurück wenn keine Daten verfügbar sind
-uint8_t uart_getc(void) {
+uint8_t rs232_getchar(void) {
 	// Prüfen ob Daten verfügbar sind
-	if (uart_rx_head == uart_rx_tail) {
+	if (rs232_rx_head == rs232_rx_tail) {
 		return 0;  // Keine Daten im Puffer
 	}
 	
 	// Daten aus Puffer lesen
-	uint8_t data = uart_rx_buffer[uart_rx_tail];
+	uint8_t data = rs232_rx_buffer[rs232_rx_tail];
 	
 	// Tail-Pointer erhöhen (mit Überlauf-Schutz)
-	uart_rx_tail = (uart_rx_tail + 1) % UART_RX_BUFFER_SIZE;
+	rs232_rx_tail = (rs232_rx_tail + 1) % RS232_RX_BUFFER_SIZE;
 	
 	return data;  // Gelesenes Byte zurückgeben
 }
@@ -83,52 +169,107 @@ uint8_t uart_getc(void) {
 // UART Receive Complete Interrupt Service Routine
 // Wird automatisch aufgerufen wenn ein Byte empfangen wurde
 ISR(USART_RXC_vect) {
+	// Fehlerbits gelten für das Byte in UDR und müssen vor UDR gelesen werden
+	// DOR: ein Byte ging verloren, weil die ISR zu spät kam; FE: Rahmenfehler (falsche Baudrate)
+	if (hal_uart_rx_error()) rs232_status.rx_errors++;
+
 	// Empfangenes Byte aus UDR lesen
-	uint8_t data = UDR;
+	uint8_t data = hal_uart_get();
 	
 	// Nächste Position im Ringpuffer berechnen
-	uint8_t next_head = (uart_rx_head + 1) % UART_RX_BUFFER_SIZE;
+	uint8_t next_head = (rs232_rx_head + 1) % RS232_RX_BUFFER_SIZE;
 	
 	// Prüfen ob Puffer voll ist (Head würde Tail überholen)
-	if (next_head != uart_rx_tail) {
+	if (next_head != rs232_rx_tail) {
 		// Puffer nicht voll - Daten speichern
-		uart_rx_buffer[uart_rx_head] = data;
-		uart_rx_head = next_head;  // Head-Pointer erhöhen
+		rs232_rx_buffer[rs232_rx_head] = data;
+		rs232_rx_head = next_head;  // Head-Pointer erhöhen
+		rs232_status.bytes_received++;
+		sched_post(SCHED_EV_RX);  // Empfangsaufgabe wecken
+	} else {
+		// Wenn Puffer voll ist, werden die Daten verworfen (Overflow)
+		rs232_status.rx_overflows++;
 	}
-	// Wenn Puffer voll ist, werden die Daten verworfen (Overflow)
 }
 
 // Empfangspuffer leeren
 // Setzt Head und Tail auf 0 zurück
-void uart_flush_rx_buffer(void) {
-	uart_rx_head = 0;  // Schreibposition zurücksetzen
-	uart_rx_tail = 0;  // Leseposition zurücksetzen
+void rs232_flush_rx_buffer(void) {
+	rs232_rx_head = 0;  // Schreibposition zurücksetzen
+	rs232_rx_tail = 0;  // Leseposition zurücksetzen
 }
 
 // Mehrere Bytes über UART senden
 // Sendet ein Array von Bytes mit angegebener Länge
-void uart_send_bytes(const uint8_t* data, uint8_t length) {
+void rs232_send_bytes(const uint8_t* data, uint8_t length) {
 	for (uint8_t i = 0; i < length; i++) {
-		uart_putc(data[i]);  // Ein Byte senden
+		rs232_putchar(data[i]);  // Ein Byte senden
 	}
 }
 
 // String mit Zeilenumbruch senden
 // Fügt automatisch \r\n am Ende hinzu
-void uart_puts_ln(const char* str) {
-	uart_puts(str);     // String senden
-	uart_putc('\r');    // Carriage Return
-	uart_putc('\n');    // Line Feed
+void rs232_puts_ln(const char* str) {
+	rs232_puts(str);     // String senden
+	rs232_putchar('\r');    // Carriage Return
+	rs232_putchar('\n');    // Line Feed
 }
 
-// Prüfen ob UART-Transmitter bereit ist
+// Prüfen ob im Sendepuffer Platz ist
 // Gibt 1 zurück wenn bereit, sonst 0
-uint8_t uart_tx_ready(void) {
-	return (UCSRA & (1 << UDRE));  // UDRE-Bit prüfen
+uint8_t rs232_tx_ready(void) {
+	return rs232_tx_free() != 0;
 }
 
 // Prüfen ob UART-Empfänger Daten hat
 // Gibt 1 zurück wenn Daten verfügbar, sonst 0
-uint8_t uart_rx_ready(void) {
-	return (UCSRA & (1 << RXC));   // RXC-Bit prüfen
-}
\ No newline at end of file
+uint8_t rs232_rx_ready(void) {
+	return hal_uart_rx_ready();   // RXC-Bit prüfen
+}
+
+// Text senden (bis zum Null-Terminator)
+static void rs232_send_text(const char* s) {
+	while (*s) rs232_putchar(*s++);
+}
+
+// Vorzeichenlosen Wert als Dezimalzahl senden
+static void rs232_send_uint(uint16_t value) {
+	char buf[FMT_U16_LEN];
+	fmt_u16(value, buf);  // Ohne Division (fmt.c)
+	rs232_send_text(buf);
+}
+
+// Integer-Wert als String über UART senden
+void rs232_send_int(int16_t value) {
+	char buf[FMT_I16_LEN];
+	fmt_i16(value, buf);
+	rs232_send_text(buf);
+}
+
+// Integer-Wert mit Semikolon senden
+void rs232_send_int_semicolon(int16_t value) {
+	rs232_send_int(value);
+	rs232_putchar(';');
+}
+
+// Vorzeichenlosen Wert mit Semikolon senden
+void rs232_send_uint_semicolon(uint16_t value) {
+	rs232_send_uint(value);
+	rs232_putchar(';');
+}
+
+// UART-Status abrufen (die Empfangszähler ändert die ISR: mit gesperrten Interrupts kopieren)
+void rs232_get_status(rs232_status_t* status) {
+	uint8_t sreg = SREG;
+	cli();
+	*status = rs232_status;
+	SREG = sreg;
+}
+
+// UART-Status zurücksetzen
+void rs232_reset_status(void) {
+	uint8_t sreg = SREG;
+	cli();
+	rs232_status = (rs232_status_t){0};
+	SREG = sreg;
+}
@@ -15,76 +15,88 @@
 
 // UART-Konfiguration für ESP8266-Kommunikation
 // Diese Werte bestimmen die serielle Kommunikation
-#define UART_BAUDRATE     9600    // Baudrate für serielle Kommunikation
-#define UART_RX_BUFFER_SIZE 64    // Größe des Empfangspuffers (Ringpuffer)
+#define RS232_BAUDRATE     28800   // Baudrate für serielle Kommunikation (wie SoftwareSerial im ESP8266)
+#define RS232_RX_BUFFER_SIZE 64    // Größe des Empfangspuffers (Ringpuffer)
+#define RS232_TX_BUFFER_SIZE 64    // Größe des Sendepuffers (Ringpuffer, Zweierpotenz, max. 128)
+
+// Baudraten für die Aushandlung mit dem ESP8266 (linkrate.h)
+// Rate n = RS232_BAUDRATE * 2^n. 3.6864 MHz ist ein Baudratenquarz, mit U2X
+// (8-fache Abtastung) sind alle Stufen exakt: UBRR = 16 / 2^n - 1
+// 0 = 28800 (Startrate, ohne U2X), 1 = 57600, 2 = 115200, 3 = 230400
+#define RS232_RATE_COUNT   4
+#define RS232_RATE_BAUD(n) ((uint32_t)RS232_BAUDRATE << (n))
 
 // UART-Initialisierung
 // Konfiguriert die UART-Hardware für Kommunikation mit ESP8266
-void uart_init(void);
+void rs232_init(void);
+
+// Ein Byte in den Sendepuffer schreiben (nicht blockierend)
+// Gibt 1 zurück wenn das Byte übernommen wurde, 0 wenn der Puffer voll ist
+// Der UDRE-Interrupt sendet den Puffer im Hintergrund
+uint8_t rs232_write(uint8_t data);
+
+// Freie Bytes im Sendepuffer
+// Damit kann ein Aufrufer prüfen, ob eine Nachricht ohne Warten hineinpasst
+uint8_t rs232_tx_free(void);
 
 // Ein Byte über UART senden (blockierend)
-// Wartet bis der Transmitter bereit ist
-void uart_putc(uint8_t data);
+// Wartet nur, wenn der Sendepuffer voll ist
+void rs232_putchar(uint8_t data);
 
 // Ein String über UART senden (blockierend)
 // Sendet Zeichen für Zeichen bis zum Null-Terminator
-void uart_puts(const char* str);
+void rs232_puts(const char* str);
+
+// Warten bis der Sendepuffer leer und das letzte Byte vollständig gesendet ist
+// Nur mit freigegebenen Interrupts aufrufen
+void rs232_flush_tx(void);
+
+// Baudrate umschalten (Stufe 0 bis RS232_RATE_COUNT - 1)
+// Sendet vorher den Sendepuffer vollständig aus
+void rs232_set_rate(uint8_t rate);
+
+// Aktuelle Baudraten-Stufe
+uint8_t rs232_get_rate(void);
 
 // Prüfen ob Daten im Empfangspuffer verfügbar sind
 // Gibt 1 zurück wenn Daten vorhanden, sonst 0
-uint8_t uart_available(void);
+uint8_t rs232_data_ready(void);
 
 // Ein Byte aus dem Empfangspuffer lesen
 // Gibt 0 zurück wenn keine Daten verfügbar sind
-uint8_t uart_getc(void);
+uint8_t rs232_getchar(void);
 
 // Empfangspuffer leeren
 // Setzt Head und Tail auf 0 zurück
-void uart_flush_rx_buffer(void);
+void rs232_flush_rx_buffer(void);
 
 // Mehrere Bytes über UART senden
 // Sendet ein Array von Bytes mit angegebener Länge
-void uart_send_bytes(const uint8_t* data, uint8_t length);
+void rs232_send_bytes(const uint8_t* data, uint8_t length);
 
 // String mit Zeilenumbruch senden
 // Fügt automatisch \r\n am Ende hinzu
-void uart_puts_ln(const char* str);
+void rs232_puts_ln(const char* str);
 
-// Prüfen ob UART-Transmitter bereit ist
-// Gibt 1 zurück wenn bereit, sonst 0
-uint8_t uart_tx_ready(void);
+// Prüfen ob im Sendepuffer Platz ist
+// Gibt 1 zurück wenn mindestens ein Byte ohne Warten gesendet werden kann, sonst 0
+uint8_t rs232_tx_ready(void);
 
 // Prüfen ob UART-Empfänger Daten hat
 // Gibt 1 zurück wenn Daten verfügbar, sonst 0
-uint8_t uart_rx_ready(void);
+uint8_t rs232_rx_ready(void);
 
 // Integer-Wert als String über UART senden
 // Konvertiert eine Zahl in einen String und sendet sie
-void uart_send_int(int16_t value);
+void rs232_send_int(int16_t value);
 
 // Integer-Wert mit Semikolon senden
 // Sendet eine Zahl gefolgt von einem Semikolon (für Daten-Streaming)
-void uart_send_int_semicolon(int16_t value);
-
-// Integer-Wert mit Zeilenumbruch senden
-// Sendet eine Zahl gefolgt von \r\n
-void uart_send_int_ln(int16_t value);
+void rs232_send_int_semicolon(int16_t value);
 
-// Hexadezimalen Wert über UART senden
-// Konvertiert ein Byte in Hex-String und sendet es
-void uart_send_hex(uint8_t value);
-
-// Debug-Ausgabe mit Zeitstempel
-// Sendet eine Debug-Nachricht mit aktueller Zeit
-void uart_debug(const char* message);
-
-// Fehler-Ausgabe
-// Sendet eine Fehlermeldung mit Präfix
-void uart_error(const char* message);
-
-// Warnung-Ausgabe
-// Sendet eine Warnung mit Präfix
-void uart_warning(const char* message);
+// Vorzeichenlosen Wert mit Semikolon senden
+// Für Zähler, die über 32767 hinausgehen können
+void rs232_send_uint_semicolon(uint16_t value);
 
 // UART-Status-Informationen
 // Struktur für UART-Statistiken und Status
@@ -92,34 +104,19 @@ typedef struct {
 	uint16_t bytes_sent;       // Anzahl gesendeter Bytes
 	uint16_t bytes_received;   // Anzahl empfangener Bytes
 	uint16_t rx_overflows;     // Anzahl Empfangspuffer-Überläufe
-	uint16_t tx_errors;        // Anzahl Sendefehler
-	uint16_t rx_errors;        // Anzahl Empfangsfehler
-	uint8_t  is_connected;     // Verbindungsstatus (1=verbunden, 0=getrennt)
-} uart_status_t;
+	uint16_t tx_full;          // Abgewiesene Bytes (rs232_write bei vollem Puffer)
+	uint16_t tx_waits;         // Blockierende Aufrufe, die auf Platz warten mussten
+	uint8_t  tx_peak;          // Höchster Füllstand des Sendepuffers
+	uint16_t rx_errors;        // Anzahl Empfangsfehler (Hardware-Überlauf DOR oder Rahmenfehler FE)
+} rs232_status_t;
 
 // UART-Status abrufen
 // Liest aktuelle UART-Statistiken
-void uart_get_status(uart_status_t* status);
+void rs232_get_status(rs232_status_t* status);
 
 // UART-Status zurücksetzen
 // Setzt alle Zähler zurück
-void uart_reset_status(void);
-
-// UART-Verbindung testen
-// Sendet ein Test-Signal und wartet auf Antwort
-uint8_t uart_test_connection(void);
-
-// UART-Echo-Modus aktivieren/deaktivieren
-// Sendet empfangene Daten automatisch zurück
-void uart_set_echo_mode(uint8_t enable);
-
-// UART-Flow-Control konfigurieren
-// Aktiviert/deaktiviert Hardware-Flow-Control (falls verfügbar)
-void uart_set_flow_control(uint8_t enable);
-
-// UART-Parameter konfigurieren
-// Ändert Baudrate, Datenbits, Stoppbits, Parität
-void uart_set_parameters(uint32_t baudrate, uint8_t data_bits, uint8_t stop_bits, uint8_t parity);
+void rs232_reset_status(void);
 
 // UART-Interrupt-Handler
 // Wird automatisch aufgerufen bei Empfang von Daten
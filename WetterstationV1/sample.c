@@ -0,0 +1,53 @@
+/*
+ * sample.c
+ *
+ * Messwert-Cache für den BME280
+ * Jede Sensor-Abfrage kostet eine komplette I2C-Transaktion plus Kompensation.
+ * Alle Verbraucher holen ihre Werte hier ab und teilen sich eine Abfrage,
+ * solange die letzte Messung jung genug ist.
+ *
+ * Created: 18.10.2026 09:12:40
+ *  Author: morri
+ */
+
+#include "sample.h"
+#include "Sensor.h"
+#include "timebase.h"
+#include "ram.h"
+#include "trace.h"
+
+// Zuletzt gelesene Messung und Zähler
+static sample_t       cache;
+static sample_stats_t stats;
+
+RAM_ACCOUNT(sample, sizeof(cache) + sizeof(stats));
+
+// Liefert eine Messung, die höchstens max_age_ms alt ist
+const sample_t* sample_get(uint32_t now_ms, uint16_t max_age_ms) {
+	stats.requests++;
+
+	// Cache-Treffer: Messung ist noch frisch genug
+	if (cache.status != SAMPLE_EMPTY && TIME_ELAPSED(now_ms, cache.time_ms) <= max_age_ms) {
+		stats.saved++;
+		return &cache;
+	}
+
+	// Neue Messung vom Sensor holen
+	// Bei einem Fehler bleiben die Werte der letzten gültigen Messung stehen
+	uint8_t err = bme280_read_measurement(&cache.temp, &cache.press, &cache.hum);
+	if (err == 0) {
+		cache.status = SAMPLE_OK;
+	} else {
+		cache.status = SAMPLE_GAP;
+		stats.gaps++;
+		TRACE(TRACE_SENSOR_GAP, err, 0);
+	}
+	cache.time_ms = now_ms;
+
+	return &cache;
+}
+
+// Cache-Statistiken abrufen
+void sample_get_stats(sample_stats_t* out) {
+	*out = stats;
+}
@@ -0,0 +1,60 @@
+/*
+ * sample.h
+ *
+ * Header-Datei für den Messwert-Cache
+ * Hält die letzte Messung mit Zeitstempel vor, damit Anzeige, serielle
+ * Ausgabe und Speicherung eine gemeinsame Sensor-Abfrage teilen
+ *
+ * Created: 18.10.2026 09:12:40
+ *  Author: morri
+ */
+
+#ifndef SAMPLE_H_
+#define SAMPLE_H_
+
+#include <stdint.h>
+
+// Maximales Alter eines Messwerts je Verbraucher (in Millisekunden)
+// Ist der zwischengespeicherte Wert jünger, wird keine neue I2C-Abfrage gestartet
+#define SAMPLE_MAX_AGE_DISPLAY_MS  2000  // Display-Aktualisierung
+#define SAMPLE_MAX_AGE_SERIAL_MS   2000  // Datenpaket an den ESP8266
+#define SAMPLE_MAX_AGE_STORE_MS    1000  // EEPROM-Speicherung (muss möglichst frisch sein)
+
+// Eine zwischengespeicherte Messung
+typedef struct {
+	uint32_t time_ms;  // Zeitpunkt der Messung (Millisekunden seit Start)
+	int16_t  temp;     // Temperatur in Zehntel-Grad (z.B. 235 = 23.5°C)
+	uint16_t press;    // Druck in Zehntel-hPa (z.B. 10132 = 1013.2 hPa)
+	uint16_t hum;      // Luftfeuchtigkeit in Zehntel-Prozent (z.B. 455 = 45.5%)
+	uint8_t  status;   // SAMPLE_EMPTY, SAMPLE_OK oder SAMPLE_GAP
+} sample_t;
+
+// Zustand des Caches
+#define SAMPLE_EMPTY  0  // Noch keine Messung
+#define SAMPLE_OK     1  // Gültige Messung
+#define SAMPLE_GAP    2  // Sensor hat nicht geantwortet - Werte sind die der letzten gültigen Messung
+
+// Kennwert für eine Lücke in gespeicherten Temperaturwerten
+// Wird statt eines Messwerts gespeichert, wenn der Sensor nicht erreichbar war
+#define SAMPLE_GAP_VALUE  INT16_MIN
+
+// Cache-Statistiken
+// Anfragen kommen bis zu einmal je Sekunde: 32 Bit, damit die Zähler nicht nach
+// einem Tag überlaufen (Sensor-Abfragen = requests - saved)
+typedef struct {
+	uint32_t requests;      // Anzahl Anfragen an den Cache
+	uint32_t saved;         // Anzahl eingesparter Sensor-Abfragen (Cache-Treffer)
+	uint16_t gaps;          // Anzahl fehlgeschlagener Sensor-Abfragen (Lücken)
+} sample_stats_t;
+
+// Liefert eine Messung, die höchstens max_age_ms alt ist
+// Liest den Sensor nur dann neu aus, wenn der Cache leer oder zu alt ist
+// Schlägt die Abfrage fehl, wird status = SAMPLE_GAP gesetzt und ebenfalls für
+// max_age_ms zwischengespeichert - ein defekter Sensor kostet so höchstens eine
+// begrenzte Abfrage pro Intervall
+const sample_t* sample_get(uint32_t now_ms, uint16_t max_age_ms);
+
+// Cache-Statistiken abrufen
+void sample_get_stats(sample_stats_t* stats);
+
+#endif /* SAMPLE_H_ */
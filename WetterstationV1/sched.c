@@ -0,0 +1,243 @@
+/*
+ * sched.c
+ *
+ * Kooperativer Scheduler
+ * Der Tick-Interrupt zählt nur Ticks und Sekunden, alle Aufgaben laufen in
+ * sched_run() nacheinander bis zum Ende (kein Verdrängen). Ereignisse aus
+ * ISRs landen in einer kleinen Warteschlange und machen die Aufgaben fällig,
+ * die sie abonniert haben.
+ *
+ * Created: 18.10.2026 17:02:14
+ *  Author: morri
+ */
+
+#include "hal.h"
+#include "sched.h"
+#include "button.h"
+#include "ram.h"
+#include "trace.h"
+
+// Laufzeit je Aufruf messen: für die Statistik (diag.h) und das Ablaufprotokoll
+#define SCHED_MEASURE  (DIAG_ENABLE || TRACE_ENABLE)
+
+// Eintrag der Aufgabentabelle
+typedef struct {
+	sched_fn_t fn;
+	uint16_t   period;     // Ticks, SCHED_EVERY_PASS oder SCHED_NO_PERIOD
+	uint16_t   deadline;   // Ticks von der Fälligkeit bis zum Ende
+	uint16_t   next;       // Nächste Fälligkeit (Ticks)
+	uint16_t   due;        // Fälligkeit bei Ereignis/Trigger (Ticks)
+	uint8_t    events;     // Abonnierte Ereignisse
+	uint8_t    ready;      // 1 = durch Ereignis oder Trigger fällig
+} sched_task_t;
+
+// Ereignis-Warteschlange (ISR schreibt, sched_run liest)
+static volatile uint8_t queue[SCHED_QUEUE_SIZE];
+static volatile uint8_t q_head, q_tail;
+static volatile uint8_t q_pending;    // Bitmaske der wartenden Ereignisse
+
+static sched_task_t       tasks[SCHED_MAX_TASKS];
+static uint8_t            task_count;
+
+#if DIAG_ENABLE
+static sched_task_stats_t task_stats[SCHED_MAX_TASKS];
+static sched_stats_t stats;
+static uint32_t idle_counts;          // Schlafzeit der laufenden Sekunde (Timer1-Schritte)
+static uint16_t idle_since;           // Beginn der laufenden Sekunde (Ticks)
+
+RAM_ACCOUNT(sched, sizeof(queue) + sizeof(q_head) + sizeof(q_tail) + sizeof(q_pending)
+                   + sizeof(tasks) + sizeof(task_stats) + sizeof(task_count)
+                   + sizeof(stats) + sizeof(idle_counts) + sizeof(idle_since));
+#else
+RAM_ACCOUNT(sched, sizeof(queue) + sizeof(q_head) + sizeof(q_tail) + sizeof(q_pending)
+                   + sizeof(tasks) + sizeof(task_count));
+#endif
+
+// Tick: alle TIMEBASE_TICK_MS (aus dem Interrupt der Zeitbasis)
+// Tastet auch den Taster ab (PC3 hat keinen eigenen Interrupt)
+void sched_tick(uint8_t new_second) {
+	button_tick();
+	if (new_second) sched_post(SCHED_EV_SECOND);
+}
+
+void sched_init(void) {
+	hal_sleep_init();                       // Idle-Modus: Timer und UART laufen im Schlaf weiter
+}
+
+uint8_t sched_add(sched_fn_t fn, uint16_t period, uint16_t deadline, uint8_t events) {
+	sched_task_t* t = &tasks[task_count];
+	t->fn       = fn;
+	t->period   = period;
+	t->deadline = deadline;
+	t->next     = timebase_ticks();
+	t->events   = events;
+	return task_count++;
+}
+
+void sched_trigger(uint8_t task) {
+	tasks[task].ready = 1;
+	tasks[task].due   = timebase_ticks();
+}
+
+void sched_set_period(uint8_t task, uint16_t period) {
+	tasks[task].period = period;
+}
+
+void sched_post(uint8_t ev) {
+	uint8_t sreg = SREG;
+	cli();
+	if (!(q_pending & SCHED_EV_MASK(ev))) {
+		uint8_t next = (q_head + 1) & (SCHED_QUEUE_SIZE - 1);
+		if (next != q_tail) {
+			queue[q_head] = ev;
+			q_head = next;
+			q_pending |= SCHED_EV_MASK(ev);
+		} else {
+			DIAG(stats.queue_overflows++);
+		}
+	}
+	SREG = sreg;
+}
+
+// Nächstes Ereignis aus der Warteschlange holen, 0xFF = keines
+static uint8_t sched_pop(void) {
+	uint8_t ev = 0xFF;
+	cli();
+	if (q_tail != q_head) {
+		ev = queue[q_tail];
+		q_tail = (q_tail + 1) & (SCHED_QUEUE_SIZE - 1);
+		q_pending &= ~SCHED_EV_MASK(ev);
+	}
+	sei();
+	return ev;
+}
+
+// Prüfen ob eine Aufgabe fällig ist, due = Zeitpunkt der Fälligkeit
+static uint8_t sched_due(const sched_task_t* t, uint16_t now, uint16_t* due) {
+	if (t->ready) {
+		*due = t->due;
+		return 1;
+	}
+	if (t->period == SCHED_EVERY_PASS) {
+		*due = now;
+		return 1;
+	}
+	if (t->period != SCHED_NO_PERIOD && TIME16_REACHED(now, t->next)) {
+		*due = t->next;
+		return 1;
+	}
+	return 0;
+}
+
+// Eine Aufgabe aufrufen und messen
+static void sched_call(uint8_t i, uint16_t due) {
+	sched_task_t* t = &tasks[i];
+
+	uint8_t triggered = t->ready;
+	t->ready = 0;  // Vor dem Aufruf, damit die Aufgabe sich selbst erneut auslösen kann
+
+	#if SCHED_MEASURE
+	uint32_t start = timebase_counts();
+	uint16_t late  = timebase_ticks() - due;
+	#endif
+	t->fn();
+	#if SCHED_MEASURE
+	uint32_t run = timebase_counts() - start;
+	#endif
+
+	if (t->period != SCHED_EVERY_PASS && t->period != SCHED_NO_PERIOD) {
+		// Nächste Fälligkeit im festen Raster, nach einem Trigger ab jetzt
+		// Verpasste Aufrufe werden nicht nachgeholt
+		uint16_t now = timebase_ticks();
+		t->next = (triggered ? now : due) + t->period;
+		if (TIME16_REACHED(now, t->next)) t->next = now + t->period;
+	}
+
+	#if SCHED_MEASURE
+	// Aufgaben aus jedem Durchlauf nicht protokollieren (würden den Ring füllen)
+	if (t->period != SCHED_EVERY_PASS) TRACE(TRACE_TASK, i, run > 0xFF ? 0xFF : run);
+
+	#if DIAG_ENABLE
+	sched_task_stats_t* s = &task_stats[i];
+	s->runs++;
+	if (run > s->run_max)  s->run_max  = run > 0xFFFF ? 0xFFFF : run;
+	if (late > s->late_max) s->late_max = late;
+	#endif
+	if ((uint32_t)late * TIMEBASE_COUNTS_PER_TICK + run > (uint32_t)t->deadline * TIMEBASE_COUNTS_PER_TICK) {
+		DIAG(s->overruns++);
+		TRACE(TRACE_OVERRUN, i, late > 0xFF ? 0xFF : late);
+	}
+	#endif
+}
+
+void sched_run(void) {
+	DIAG(idle_since = timebase_ticks());
+	for (;;) {
+		// Ereignisse an die Aufgaben verteilen, die sie abonniert haben
+		uint8_t ev;
+		while ((ev = sched_pop()) != 0xFF) {
+			for (uint8_t i = 0; i < task_count; i++) {
+				if ((tasks[i].events & SCHED_EV_MASK(ev)) && !tasks[i].ready) {
+					tasks[i].ready = 1;
+					tasks[i].due   = timebase_ticks();
+				}
+			}
+		}
+
+		// Fällige Aufgaben in Tabellenreihenfolge aufrufen
+		uint8_t pending = 0;
+		for (uint8_t i = 0; i < task_count; i++) {
+			uint16_t due;
+			if (sched_due(&tasks[i], timebase_ticks(), &due)) sched_call(i, due);
+		}
+		// Ist durch die Aufrufe etwas Neues fällig geworden, sofort weiter
+		uint16_t now = timebase_ticks();
+		for (uint8_t i = 0; i < task_count; i++) {
+			uint16_t due;
+			if (tasks[i].period != SCHED_EVERY_PASS && sched_due(&tasks[i], now, &due)) pending = 1;
+		}
+
+		// Schlafen bis zum nächsten Interrupt
+		// Nach sei() wird sleep noch ausgeführt, bevor ein wartender Interrupt läuft:
+		// ein Ereignis zwischen Prüfung und Schlaf weckt die CPU also sofort wieder
+		if (!pending) {
+			#if DIAG_ENABLE
+			uint32_t before = timebase_counts();
+			#endif
+			cli();
+			if (q_tail == q_head) {
+				hal_sleep();
+			}
+			sei();
+			DIAG(idle_counts += timebase_counts() - before);
+		}
+
+		#if DIAG_ENABLE
+		// Idle-Anteil einmal pro Sekunde auswerten
+		now = timebase_ticks();
+		if ((uint16_t)(now - idle_since) >= SCHED_TICKS_PER_S) {
+			uint32_t total = (uint32_t)(uint16_t)(now - idle_since) * TIMEBASE_COUNTS_PER_TICK;
+			stats.idle_pct = idle_counts * 100 / total;
+			idle_counts = 0;
+			idle_since  = now;
+		}
+		#endif
+	}
+}
+
+#if DIAG_ENABLE
+uint8_t sched_task_count(void) {
+	return task_count;
+}
+
+void sched_get_task_stats(uint8_t task, sched_task_stats_t* out) {
+	*out = task_stats[task];
+}
+
+void sched_get_stats(sched_stats_t* out) {
+	uint8_t sreg = SREG;
+	cli();
+	*out = stats;
+	SREG = sreg;
+}
+#endif
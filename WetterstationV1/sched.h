@@ -0,0 +1,87 @@
+/*
+ * sched.h
+ *
+ * Header-Datei für den kooperativen Scheduler
+ * Der Tick kommt von der Zeitbasis (timebase.h, alle 10 ms), Perioden und
+ * Deadlines zählen in Ticks. Aufgaben laufen periodisch, auf Ereignis (von ISRs
+ * gemeldet) oder in jedem Durchlauf. Ist nichts fällig, schläft die CPU im
+ * Idle-Modus bis zum nächsten Interrupt (Tick, UART, ...).
+ *
+ * Created: 18.10.2026 17:02:14
+ *  Author: morri
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include <stdint.h>
+#include "timebase.h"
+#include "diag.h"
+
+// Perioden und Deadlines in Ticks
+#define SCHED_TICKS_PER_S    TIMEBASE_TICKS_PER_S
+
+// Größen der Tabellen
+#define SCHED_MAX_TASKS      6
+#define SCHED_QUEUE_SIZE     8     // Ereignis-Warteschlange (Zweierpotenz)
+
+// Besondere Perioden
+#define SCHED_EVERY_PASS     0       // In jedem Durchlauf der Hauptschleife aufrufen
+#define SCHED_NO_PERIOD      0xFFFF  // Nur auf Ereignis oder sched_trigger()
+
+// Ereignisse (Bitnummer in der Ereignismaske einer Aufgabe)
+#define SCHED_EV_RX          0     // Byte vom ESP8266 empfangen (rs232)
+#define SCHED_EV_SECOND      1     // Neue Sekunde (Zeitstempel erhöht)
+#define SCHED_EV_BUTTON      2     // Taster-Ereignis in der Warteschlange (button.h)
+#define SCHED_EV_MASK(ev)    (1 << (ev))
+
+typedef void (*sched_fn_t)(void);
+
+// Laufzeit-Statistik einer Aufgabe (nur mit DIAG_ENABLE, diag.h)
+typedef struct {
+	uint16_t runs;        // Aufrufe
+	uint16_t run_max;     // Längste Laufzeit (Timer1-Schritte, 1/3600 s)
+	uint16_t late_max;    // Größte Verspätung des Starts gegenüber der Fälligkeit (Ticks)
+	uint16_t overruns;    // Aufrufe, die erst nach ihrer Deadline fertig wurden
+} sched_task_stats_t;
+
+// Statistik des Schedulers
+typedef struct {
+	uint8_t  idle_pct;         // Anteil der letzten vollen Sekunde im Idle-Schlaf (%)
+	uint16_t queue_overflows;  // Verlorene Ereignisse (Warteschlange voll)
+} sched_stats_t;
+
+// Scheduler einrichten (Idle-Schlaf), die Zeitbasis muss laufen
+void sched_init(void);
+
+// Tick aus dem Interrupt der Zeitbasis: Taster abtasten, Sekunden-Ereignis melden
+void sched_tick(uint8_t new_second);
+
+// Aufgabe eintragen, Rückgabe: Nummer der Aufgabe (Reihenfolge = Priorität im Durchlauf)
+// period:   Ticks zwischen zwei Aufrufen, SCHED_EVERY_PASS oder SCHED_NO_PERIOD
+// deadline: erlaubte Ticks von der Fälligkeit bis zum Ende des Aufrufs
+// events:   Maske der Ereignisse (SCHED_EV_MASK), die die Aufgabe sofort fällig machen
+// Periodische Aufgaben sind beim Start sofort fällig
+uint8_t sched_add(sched_fn_t fn, uint16_t period, uint16_t deadline, uint8_t events);
+
+// Aufgabe sofort fällig machen, die Periode beginnt nach dem Aufruf neu
+void sched_trigger(uint8_t task);
+
+// Periode ändern (gilt schon für die Fälligkeit nach dem laufenden Aufruf)
+void sched_set_period(uint8_t task, uint16_t period);
+
+// Ereignis melden (aus ISRs oder dem Hauptprogramm)
+// Ein bereits wartendes Ereignis wird nicht doppelt eingetragen
+void sched_post(uint8_t ev);
+
+// Hauptschleife: Ereignisse verteilen, fällige Aufgaben aufrufen, schlafen (kehrt nicht zurück)
+void sched_run(void);
+
+#if DIAG_ENABLE
+// Statistiken abrufen
+uint8_t sched_task_count(void);
+void sched_get_task_stats(uint8_t task, sched_task_stats_t* stats);
+void sched_get_stats(sched_stats_t* stats);
+#endif
+
+#endif /* SCHED_H_ */
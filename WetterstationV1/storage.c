@@ -0,0 +1,303 @@
+/*
+ * storage.c
+ *
+ * Messwert-Speicherung im externen EEPROM
+ * Mittelwerte werden im RAM aufsummiert und erst beim Abschluss einer
+ * Zeitspanne (15 bzw. 105 Minuten) geschrieben. Rohdaten landen nur dann
+ * im Ringpuffer, wenn ein Wert das Totband verlässt. Das Abtastintervall
+ * verdoppelt sich bei stabilen Werten und halbiert sich bei schnellen Änderungen.
+ *
+ * Created: 18.10.2026 12:20:03
+ *  Author: morri
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+#include "storage.h"
+#include "sample.h"
+#include "EEPROM.h"
+#include "timebase.h"
+#include "ram.h"
+#include "trace.h"
+
+// Ein Datensatz darf nicht größer werden (EEPROM-Layout der Ringpuffer)
+_Static_assert(sizeof(SensorValue) == 8, "SensorValue muss 8 Bytes gross bleiben");
+// storage_series_read() liest Temperatur und Druck in einem Stück
+_Static_assert(offsetof(SensorValue, press) == offsetof(SensorValue, temp) + 2, "Feldreihenfolge");
+
+// Umrechnung Feuchte 0.1% -> 0.5% (kompakte Speicherung im EEPROM)
+#define HUM_TO_STORED(h)   ((uint8_t)(((h) + 2) / 5))
+
+// Aufsummierte Messungen einer Zeitspanne (im RAM)
+typedef struct {
+	uint32_t start;      // Beginn der Zeitspanne (s)
+	int32_t  temp_sum;   // Summe Temperatur (0.1°C)
+	uint32_t press_sum;  // Summe Druck (0.1 hPa)
+	uint32_t hum_sum;    // Summe Feuchte (0.1%)
+	uint16_t count;      // Anzahl gültiger Messungen
+	uint8_t  index;      // Nächste Schreibposition im Verlauf
+	uint16_t seq;        // Anzahl abgeschlossener Zeitspannen (laufende Nummer)
+} bucket_t;
+
+static bucket_t bucket_24h;  // Verlauf 24h
+static bucket_t bucket_7d;   // Verlauf 7 Tage
+
+// Rohdaten-Ringpuffer
+static uint8_t  raw_index;   // Nächste Schreibposition
+static uint32_t raw_writes;  // Anzahl geschriebener Rohdatensätze (für die Lebensdauer)
+static uint8_t  last_gap = 1;  // 1 = zuletzt wurde eine Lücke (oder noch nichts) gespeichert
+
+// Adaptive Abtastung (bei fester Abtastung ist das Intervall SAMPLE_INTERVAL_MIN_S)
+#if ADAPTIVE_SAMPLING
+static int16_t  last_t;      // Zuletzt gespeicherte Werte (Referenz für das Totband)
+static uint16_t last_p;
+static uint16_t last_h;
+static uint8_t  interval = SAMPLE_INTERVAL_MIN_S;  // Aktuelles Abtastintervall (s)
+static int16_t  prev_t;      // Vorherige Messung (für die Änderungsrate)
+static uint16_t prev_p;
+#endif
+
+static uint8_t  started;     // 1 = erste Messung empfangen (Zeitspannen laufen)
+static storage_stats_t stats;
+
+#if ADAPTIVE_SAMPLING
+#define STORAGE_RAM_ADAPTIVE  (sizeof(last_t) + sizeof(last_p) + sizeof(last_h) + sizeof(interval) \
+                               + sizeof(prev_t) + sizeof(prev_p))
+#else
+#define STORAGE_RAM_ADAPTIVE  0
+#endif
+RAM_ACCOUNT(storage, sizeof(bucket_24h) + sizeof(bucket_7d) + sizeof(raw_index) + sizeof(raw_writes)
+                     + sizeof(last_gap) + STORAGE_RAM_ADAPTIVE + sizeof(started) + sizeof(stats));
+
+// Schreibt einen Datensatz ins EEPROM
+static void write_record(uint16_t base_addr, uint8_t index, uint32_t ts, int16_t temp, uint16_t press, uint8_t hum) {
+	SensorValue val;  // Temporäre Struktur für die Daten
+	val.timestamp = ts;    // Zeitstempel setzen (untere 24 Bit)
+	val.hum       = hum;   // Feuchte setzen (0.5%-Schritte)
+	val.temp      = temp;  // Temperatur setzen
+	val.press     = press; // Druck setzen
+
+	// Adresse im EEPROM berechnen (Basis + Index * Größe der Struktur)
+	eeprom_write_block(base_addr + index * sizeof(SensorValue), (uint8_t*)&val, sizeof(SensorValue));
+	stats.writes++;
+	uint8_t region;
+	if      (base_addr == EEPROM_ADDR_24H) region = REGION_24H;
+	else if (base_addr == EEPROM_ADDR_7D)  region = REGION_7D;
+	else                                   region = REGION_RAW;
+	stats.region_writes[region]++;
+	TRACE(TRACE_STORE, region, index);
+}
+
+// Eine Messung zur Zeitspanne addieren, abgelaufene Zeitspanne abschließen
+static void bucket_add(bucket_t* b, uint16_t base_addr, uint16_t len_s, uint32_t now_s,
+                       uint8_t status, int16_t temp, uint16_t press, uint16_t hum) {
+	// Zeitspanne abgelaufen: Mittelwert (oder Lücke) schreiben
+	if (TIME_ELAPSED(now_s, b->start) >= len_s) {
+		uint32_t mid = b->start + len_s / 2;  // Zeitstempel = Mitte der Zeitspanne
+		if (b->count == 0) {
+			write_record(base_addr, b->index, mid, SAMPLE_GAP_VALUE, 0, 0);
+		} else {
+			write_record(base_addr, b->index, mid, b->temp_sum / b->count,
+			             b->press_sum / b->count, HUM_TO_STORED(b->hum_sum / b->count));
+		}
+		b->index = (b->index + 1) % DISPLAY_COUNT;  // Index erhöhen (Ringpuffer)
+		b->seq++;                                   // Neuer Punkt im Verlauf
+
+		// Nächste Zeitspanne (lange Pausen ohne Messung nicht nachholen)
+		b->start += len_s;
+		if (TIME_ELAPSED(now_s, b->start) >= len_s) b->start = now_s;
+		b->temp_sum = 0; b->press_sum = 0; b->hum_sum = 0; b->count = 0;
+	}
+
+	if (status != SAMPLE_OK) return;  // Lücken gehen nicht in den Mittelwert ein
+	b->temp_sum  += temp;
+	b->press_sum += press;
+	b->hum_sum   += hum;
+	b->count++;
+}
+
+#if ADAPTIVE_SAMPLING
+// Prüft ob a und b weiter als band auseinanderliegen
+static uint8_t outside(int16_t a, int16_t b, int16_t band) {
+	return abs(a - b) > band;
+}
+#endif
+
+// Speicherung initialisieren
+void storage_init(void) {
+	started  = 0;
+#if ADAPTIVE_SAMPLING
+	interval = SAMPLE_INTERVAL_MIN_S;
+#endif
+	last_gap = 1;
+}
+
+// Eine Messung übergeben
+void storage_add_sample(uint32_t now_s, uint8_t status, int16_t temp, uint16_t press, uint16_t hum) {
+	if (!started) {
+		bucket_24h.start = now_s;
+		bucket_7d.start  = now_s;
+		started = 1;
+	}
+	stats.samples++;
+
+	// Mittelwerte im RAM sammeln, abgeschlossene Zeitspannen schreiben
+	bucket_add(&bucket_24h, EEPROM_ADDR_24H, BUCKET_24H_S, now_s, status, temp, press, hum);
+	bucket_add(&bucket_7d,  EEPROM_ADDR_7D,  BUCKET_7D_S,  now_s, status, temp, press, hum);
+
+	// Rohdaten: bei fester Abtastung jede Messung, sonst nur bei Verlassen des Totbands
+	uint8_t write;
+	if (status != SAMPLE_OK) {
+		write = !last_gap;  // Beginn einer Lücke einmal markieren
+	} else {
+#if ADAPTIVE_SAMPLING
+		write = last_gap
+		     || outside(temp, last_t, STORAGE_DEADBAND_T)
+		     || outside(press, last_p, STORAGE_DEADBAND_P)
+		     || outside(hum, last_h, STORAGE_DEADBAND_H);
+#else
+		write = 1;
+#endif
+	}
+
+	if (write) {
+		if (status == SAMPLE_OK) {
+			write_record(EEPROM_ADDR_RAW, raw_index, now_s, temp, press, HUM_TO_STORED(hum));
+#if ADAPTIVE_SAMPLING
+			last_t = temp; last_p = press; last_h = hum;
+#endif
+			last_gap = 0;
+		} else {
+			write_record(EEPROM_ADDR_RAW, raw_index, now_s, SAMPLE_GAP_VALUE, 0, 0);
+			last_gap = 1;
+		}
+		raw_index = (raw_index + 1) % RAW_BUFFER_COUNT;  // Index erhöhen (Ringpuffer)
+		raw_writes++;
+	}
+
+#if ADAPTIVE_SAMPLING
+	// Eingesparte Schreibvorgänge gegenüber einem Rohdatensatz alle 2 s
+	stats.writes_avoided += interval / SAMPLE_INTERVAL_MIN_S - write;
+
+	// Abtastintervall an die Änderungsrate anpassen
+	if (status == SAMPLE_OK) {
+		if (outside(temp, prev_t, STORAGE_DEADBAND_T) || outside(press, prev_p, STORAGE_DEADBAND_P)) {
+			interval = SAMPLE_INTERVAL_MIN_S;  // Schnelle Änderung: sofort dicht abtasten
+		} else if (!outside(temp, prev_t, STORAGE_DEADBAND_T / 2) && !outside(press, prev_p, STORAGE_DEADBAND_P / 2)
+		           && interval < SAMPLE_INTERVAL_MAX_S) {
+			interval *= 2;                     // Stabil: Intervall verdoppeln
+		}
+		prev_t = temp; prev_p = press;
+	} else {
+		interval = SAMPLE_INTERVAL_MIN_S;      // Sensor-Fehler: bald erneut versuchen
+	}
+#endif
+}
+
+// Abstand bis zur nächsten Messung
+uint8_t storage_interval(void) {
+#if ADAPTIVE_SAMPLING
+	return interval;
+#else
+	return SAMPLE_INTERVAL_MIN_S;
+#endif
+}
+
+// Laufende Nummer des neuesten Punkts eines Verlaufs
+uint16_t storage_series_seq(uint8_t series) {
+	return (series < SERIES_T7D) ? bucket_24h.seq : bucket_7d.seq;
+}
+
+// count aufeinanderfolgende Punkte ab age lesen (neuester zuerst)
+// Ältere Punkte liegen an niedrigeren Adressen, deshalb wird jeder zusammenhängende
+// Abschnitt aufsteigend gelesen und rückwärts in out eingetragen
+void storage_series_read(uint8_t series, uint8_t age, uint8_t count, int16_t* out) {
+	const bucket_t* b  = (series < SERIES_T7D) ? &bucket_24h : &bucket_7d;
+	uint16_t base_addr = (series < SERIES_T7D) ? EEPROM_ADDR_24H : EEPROM_ADDR_7D;
+	uint8_t  i = 0;
+
+	while (i < count) {
+		uint8_t a = age + i;
+		if (a >= DISPLAY_COUNT) {  // Älter als der Verlauf
+			out[i++] = SAMPLE_GAP_VALUE;
+			continue;
+		}
+
+		// Index des neuesten Punkts im Abschnitt, Abschnitt endet bei Index 0 (Ringumbruch)
+		uint8_t j   = (b->index + DISPLAY_COUNT - 1 - a) % DISPLAY_COUNT;
+		uint8_t run = count - i;
+		if (run > j + 1)             run = j + 1;
+		if (run > DISPLAY_COUNT - a) run = DISPLAY_COUNT - a;
+
+		// Nur Temperatur und Druck jedes Datensatzes lesen, den Rest überspringen
+		eeprom_read_begin(base_addr + (j + 1 - run) * sizeof(SensorValue) + offsetof(SensorValue, temp));
+		for (uint8_t k = run; k > 0; k--) {
+			uint16_t t = eeprom_read_next();        // Temperatur, Little Endian
+			t |= (uint16_t)eeprom_read_next() << 8;
+			uint16_t p = eeprom_read_next();        // Druck
+			p |= (uint16_t)eeprom_read_next() << 8;
+			if (k > 1) {
+				for (uint8_t skip = 0; skip < sizeof(SensorValue) - 4; skip++) eeprom_read_next();
+			}
+			if ((int16_t)t == SAMPLE_GAP_VALUE) out[i + k - 1] = SAMPLE_GAP_VALUE;  // Lücke auch im Druckverlauf
+			else out[i + k - 1] = (series & 1) ? (int16_t)p : (int16_t)t;          // Ungerade Series = Druck
+		}
+		eeprom_read_end();
+		i += run;
+	}
+}
+
+// Einen Punkt eines Verlaufs lesen (age 0 = neuester Punkt)
+int16_t storage_series_point(uint8_t series, uint8_t age) {
+	int16_t v;
+	storage_series_read(series, age, 1, &v);
+	return v;
+}
+
+// Einen Verlauf für das Display laden (neuester Wert zuerst)
+void storage_load_graph(uint8_t page, int16_t* out) {
+	if (page < 1 || page > SERIES_COUNT) return;  // Ungültige Seite
+	storage_series_read(page - 1, 0, DISPLAY_COUNT, out);  // 96 Punkte in höchstens zwei Bursts
+}
+
+// Beschreibung eines Speicherbereichs abrufen
+uint8_t storage_region(uint8_t region, storage_region_t* out) {
+	switch (region) {
+	case REGION_24H:
+		out->addr = EEPROM_ADDR_24H; out->size = DISPLAY_COUNT * sizeof(SensorValue);
+		out->seq  = bucket_24h.seq;  out->head = bucket_24h.index;
+		return 1;
+	case REGION_7D:
+		out->addr = EEPROM_ADDR_7D;  out->size = DISPLAY_COUNT * sizeof(SensorValue);
+		out->seq  = bucket_7d.seq;   out->head = bucket_7d.index;
+		return 1;
+	case REGION_RAW:
+		out->addr = EEPROM_ADDR_RAW; out->size = RAW_BUFFER_COUNT * sizeof(SensorValue);
+		out->seq  = (uint16_t)raw_writes; out->head = raw_index;
+		return 1;
+	}
+	return 0;
+}
+
+// Speicher-Statistiken abrufen
+void storage_get_stats(storage_stats_t* out, uint32_t now_s) {
+	stats.interval_s = storage_interval();
+
+	// Lebensdauer: Am stärksten beansprucht wird der Rohdaten-Ringpuffer.
+	// Jeder Eintrag erhält raw_writes / RAW_BUFFER_COUNT Schreibzyklen in now_s Sekunden.
+	// Gerechnet über den mittleren Schreibabstand in 1/100 s, damit alles in 32 Bit bleibt.
+	uint16_t days = 0xFFFF;
+	if (raw_writes) {
+		uint32_t n = now_s, w = raw_writes;
+		while (w >= 0x02000000UL) { n >>= 1; w >>= 1; }  // Rest * 100 passt in 32 Bit
+		uint32_t q = n / w;
+		if (q < 100) {                                    // Ab 100 s Abstand ohnehin unbegrenzt
+			uint32_t iv = q * 100 + (n % w) * 100 / w;
+			uint32_t d  = iv * (EEPROM_ENDURANCE * RAW_BUFFER_COUNT / 10000UL) / 864UL;
+			if (d < 0xFFFF) days = (uint16_t)d;
+		}
+	}
+	stats.lifetime_days = days;
+
+	*out = stats;
+}
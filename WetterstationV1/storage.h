@@ -0,0 +1,126 @@
+/*
+ * storage.h
+ *
+ * Header-Datei für die Messwert-Speicherung im externen EEPROM
+ * Definiert das Speicherlayout (Verläufe und Rohdaten-Ringpuffer),
+ * die adaptive Abtastung und die Schreibstatistik
+ *
+ * Created: 18.10.2026 12:20:03
+ *  Author: morri
+ */
+
+#ifndef STORAGE_H_
+#define STORAGE_H_
+
+#include <stdint.h>
+
+// --- Abtastung ---
+// 1 = Abtastintervall passt sich der Änderungsrate an, Rohdaten nur bei Verlassen des Totbands
+// 0 = Festes Intervall, jede Messung wird als Rohdatensatz gespeichert
+#ifndef ADAPTIVE_SAMPLING
+#define ADAPTIVE_SAMPLING      1
+#endif
+
+#define SAMPLE_INTERVAL_MIN_S  2     // Kürzestes Abtastintervall (s) - auch das feste Intervall
+#define SAMPLE_INTERVAL_MAX_S  32    // Längstes Abtastintervall bei stabilen Werten (s)
+
+// Totband für die Rohdaten-Speicherung (und Schwelle für schnelleres Abtasten)
+// Ein Rohdatensatz wird erst geschrieben, wenn ein Wert um mehr als das Totband
+// vom zuletzt gespeicherten abweicht
+#define STORAGE_DEADBAND_T     2     // Temperatur in 0.1°C (0.2°C)
+#define STORAGE_DEADBAND_P     3     // Druck in 0.1 hPa (0.3 hPa)
+#define STORAGE_DEADBAND_H     10    // Feuchte in 0.1% (1%)
+
+// --- Verläufe ---
+// Jeder Verlauf besteht aus DISPLAY_COUNT Mittelwerten fester Zeitspanne
+#define DISPLAY_COUNT          96    // Datenpunkte je Verlauf (= Graphenbreite)
+#define BUCKET_24H_S           900   // 24 h / 96 = 15 Minuten je Datenpunkt
+#define BUCKET_7D_S            6300  // 7 Tage / 96 = 105 Minuten je Datenpunkt
+
+// --- EEPROM-Layout ---
+#define EEPROM_ADDR_24H        0x0000  // 96 Mittelwerte 24h (768 Bytes)
+#define EEPROM_ADDR_7D         0x0300  // 96 Mittelwerte 7 Tage (768 Bytes)
+#define EEPROM_ADDR_RAW        0x0600  // Rohdaten-Ringpuffer (512 Bytes)
+#define RAW_BUFFER_COUNT       64      // Anzahl Rohdatensätze im Ringpuffer
+
+// Schreibzyklen pro Byte laut Datenblatt (25LCxxx)
+#define EEPROM_ENDURANCE       1000000UL
+
+// Ein Datensatz im EEPROM
+// Feuchte und Zeitstempel teilen sich 32 Bit, damit ein Datensatz bei 8 Bytes bleibt
+// Der Zeitstempel läuft nach 2^24 s (194 Tage) über. Die Firmware vergleicht ihn nie,
+// Leser rechnen nur mit Abständen modulo 2^24 (pack.c, Spiegel im ESP8266); ein gelöschter
+// Datensatz ist an der Feuchte 0xFF zu erkennen, nicht am Zeitstempel 0xFFFFFF
+typedef struct {
+	uint32_t timestamp : 24; // Zeitstempel (Sekunden seit Start, untere 24 Bit)
+	uint32_t hum       : 8;  // Luftfeuchtigkeit in halben Prozent (z.B. 91 = 45.5%)
+	int16_t  temp;       // Temperatur in Zehntel-Grad (z.B. 235 = 23.5°C), SAMPLE_GAP_VALUE = Lücke
+	uint16_t press;      // Druck in Zehntel-hPa (z.B. 10132 = 1013.2 hPa)
+} SensorValue;
+
+// Speicherbereiche (Bulk-Export als Rohbytes, Schreibzähler je Bereich)
+#define REGION_24H             0     // Mittelwerte 24h
+#define REGION_7D              1     // Mittelwerte 7 Tage
+#define REGION_RAW             2     // Rohdaten-Ringpuffer
+#define REGION_COUNT           3
+
+// Speicher-Statistiken
+typedef struct {
+	uint16_t samples;         // Anzahl übergebener Messungen
+	uint16_t writes;          // Anzahl geschriebener Datensätze (Rohdaten + Mittelwerte)
+	uint16_t region_writes[REGION_COUNT];  // Geschriebene Datensätze je Bereich (REGION_*)
+	uint32_t writes_avoided;  // Eingesparte Rohdatensätze gegenüber festem 2-s-Intervall (ca. 40000 pro Woche)
+	uint8_t  interval_s;      // Aktuelles Abtastintervall (s)
+	uint16_t lifetime_days;   // Hochgerechnete EEPROM-Lebensdauer (Tage, 65535 = unbegrenzt)
+} storage_stats_t;
+
+// Speicherung initialisieren (Zähler und Akkumulatoren zurücksetzen)
+void storage_init(void);
+
+// Eine Messung übergeben (Werte in 0.1°C, 0.1 hPa, 0.1%)
+// status ist SAMPLE_OK oder SAMPLE_GAP (dann werden die Werte ignoriert)
+// Schließt abgelaufene Zeitspannen und schreibt deren Mittelwert ins EEPROM
+void storage_add_sample(uint32_t now_s, uint8_t status, int16_t temp, uint16_t press, uint16_t hum);
+
+// Abstand bis zur nächsten Messung (s)
+uint8_t storage_interval(void);
+
+// Einen Verlauf für das Display laden (neuester Wert zuerst)
+// page: 1 = Temp 24h, 2 = Druck 24h, 3 = Temp 7 Tage, 4 = Druck 7 Tage (= Series + 1)
+void storage_load_graph(uint8_t page, int16_t* out);
+
+// Verläufe (Series) für die Übertragung zum ESP8266
+#define SERIES_T24             0     // Temperatur 24h (Seite 1)
+#define SERIES_P24             1     // Druck 24h (Seite 2)
+#define SERIES_T7D             2     // Temperatur 7 Tage (Seite 3)
+#define SERIES_P7D             3     // Druck 7 Tage (Seite 4)
+#define SERIES_COUNT           4
+
+// Laufende Nummer des neuesten Punkts eines Verlaufs
+// Erhöht sich mit jeder abgeschlossenen Zeitspanne (läuft bei 65535 über)
+uint16_t storage_series_seq(uint8_t series);
+
+// Einen Punkt eines Verlaufs lesen (age 0 = neuester Punkt)
+// Lücken werden als SAMPLE_GAP_VALUE geliefert
+int16_t storage_series_point(uint8_t series, uint8_t age);
+
+// count aufeinanderfolgende Punkte ab age lesen (neuester zuerst)
+// Liest aus dem EEPROM in Bursts (ein Chip Select je zusammenhängendem Abschnitt)
+// Punkte mit age >= DISPLAY_COUNT werden als SAMPLE_GAP_VALUE geliefert
+void storage_series_read(uint8_t series, uint8_t age, uint8_t count, int16_t* out);
+
+typedef struct {
+	uint16_t addr;   // Startadresse im EEPROM
+	uint16_t size;   // Größe in Bytes
+	uint16_t seq;    // Schreibzähler des Rings (ändert sich, sobald ein Datensatz dazukommt)
+	uint8_t  head;   // Nächste Schreibposition (ältester Datensatz)
+} storage_region_t;
+
+// Beschreibung eines Speicherbereichs abrufen
+// Rückgabe: 0 = unbekannter Bereich
+uint8_t storage_region(uint8_t region, storage_region_t* out);
+
+// Speicher-Statistiken abrufen (now_s für die Lebensdauer-Hochrechnung)
+void storage_get_stats(storage_stats_t* stats, uint32_t now_s);
+
+#endif /* STORAGE_H_ */
@@ -0,0 +1,108 @@
+/*
+ * timebase.c
+ *
+ * Zeitbasis aus Timer1 (Tick alle 10 ms)
+ * Die ISR schreibt Ticks, Millisekunden, Timer1-Schritte und Sekunden fort.
+ * Gelesen wird mit gesperrten Interrupts; ist der Compare-Match schon
+ * passiert, die ISR aber noch nicht gelaufen (OCF1A gesetzt), wird der
+ * ausstehende Tick mitgezählt, damit die Zeit nie rückwärts läuft.
+ *
+ * Created: 18.10.2026 18:21:07
+ *  Author: morri
+ */
+
+#include "hal.h"
+#include "timebase.h"
+#include "sched.h"
+
+static volatile uint32_t seconds;     // Sekunden seit dem Start
+static volatile uint32_t ms_base;     // Millisekunden bis zum letzten Tick
+static volatile uint32_t counts_base; // Timer1-Schritte bis zum letzten Tick
+static volatile uint16_t ticks;       // Ticks seit dem Start
+static uint8_t  sub_ticks;            // Ticks in der laufenden Sekunde (nur ISR)
+
+// Tick: alle TIMEBASE_TICK_MS
+ISR(TIMER1_COMPA_vect) {
+	ticks++;
+	ms_base     += TIMEBASE_TICK_MS;
+	counts_base += TIMEBASE_COUNTS_PER_TICK;
+	uint8_t new_second = 0;
+	if (++sub_ticks >= TIMEBASE_TICKS_PER_S) {
+		sub_ticks = 0;
+		seconds++;
+		new_second = 1;
+	}
+	sched_tick(new_second);
+}
+
+void timebase_init(void) {
+	// CTC-Modus, Prescaler 1024 (3600 Schritte pro Sekunde), Compare-Interrupt nach einem Tick
+	hal_tick_init(TIMEBASE_COUNTS_PER_TICK - 1);
+}
+
+// Bruchteil des laufenden Ticks in Millisekunden (c < TIMEBASE_COUNTS_PER_TICK)
+static inline uint8_t counts_to_ms(uint8_t c) {
+	#if TIMEBASE_COUNTS_PER_TICK == 36 && TIMEBASE_TICK_MS == 10
+	return ((uint16_t)c * 143) >> 9;           // = c * 5 / 18 für c < 36, ohne Division
+	#else
+	return (uint16_t)c * TIMEBASE_TICK_MS / TIMEBASE_COUNTS_PER_TICK;
+	#endif
+}
+
+void timebase_now(timebase_t* now) {
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t c = hal_tick_count();
+	uint8_t pending = hal_tick_pending();
+	if (pending) c = hal_tick_count();         // Timer steht schon im nächsten Tick
+	now->ticks  = ticks;
+	now->ms     = ms_base;
+	now->counts = counts_base;
+	now->s      = seconds;
+	if (pending) {
+		now->ticks++;
+		now->ms     += TIMEBASE_TICK_MS;
+		now->counts += TIMEBASE_COUNTS_PER_TICK;
+		if (sub_ticks == TIMEBASE_TICKS_PER_S - 1) now->s++;
+	}
+	SREG = sreg;
+	now->ms     += counts_to_ms(c);
+	now->counts += c;
+}
+
+uint32_t timebase_seconds(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t s = seconds;
+	if (hal_tick_pending() && sub_ticks == TIMEBASE_TICKS_PER_S - 1) s++;
+	SREG = sreg;
+	return s;
+}
+
+uint32_t timebase_ms(void) {
+	timebase_t now;
+	timebase_now(&now);
+	return now.ms;
+}
+
+uint32_t timebase_counts(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t base = counts_base;
+	uint8_t c = hal_tick_count();
+	if (hal_tick_pending()) {
+		base += TIMEBASE_COUNTS_PER_TICK;
+		c = hal_tick_count();
+	}
+	SREG = sreg;
+	return base + c;
+}
+
+uint16_t timebase_ticks(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t t = ticks;
+	if (hal_tick_pending()) t++;
+	SREG = sreg;
+	return t;
+}
@@ -0,0 +1,58 @@
+/*
+ * timebase.h
+ *
+ * Header-Datei für die Zeitbasis
+ * Timer1 läuft im CTC-Modus mit Prescaler 1024 (3600 Schritte pro Sekunde)
+ * und löst alle TIMEBASE_TICK_MS einen Interrupt aus. Sekunden, Millisekunden
+ * und Timer1-Schritte seit dem Start werden dort fortgeschrieben, der Stand
+ * von TCNT1 liefert den Bruchteil des laufenden Ticks.
+ *
+ * Alle Werte sind mehrbytig und werden von der ISR geändert: nur über die
+ * Funktionen lesen (atomar), Zeitpunkte nur mit den TIME_*-Makros vergleichen.
+ *
+ * Created: 18.10.2026 18:21:07
+ *  Author: morri
+ */
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+
+// Tick-Länge
+#define TIMEBASE_TICK_MS         10
+#define TIMEBASE_TICKS_PER_S     (1000 / TIMEBASE_TICK_MS)
+// Timer1-Schritte pro Sekunde (Prescaler 1024) und pro Tick
+#define TIMEBASE_COUNTS_PER_S    (F_CPU / 1024)
+#define TIMEBASE_COUNTS_PER_TICK (TIMEBASE_COUNTS_PER_S / TIMEBASE_TICKS_PER_S)  // 36 bei 3.6864 MHz
+
+// Timer1-Schritte in Millisekunden bzw. Mikrosekunden umrechnen
+#define TIMEBASE_COUNTS_TO_MS(c) ((uint32_t)(c) * 1000 / TIMEBASE_COUNTS_PER_S)
+#define TIMEBASE_COUNTS_TO_US(c) ((uint32_t)(c) * 2500 / 9)  // 1e6 / 3600, bis ca. 1,7 Mio. Schritte
+
+// Wrap-sichere Vergleiche (Zähler laufen über, Abstände müssen kleiner als der halbe Bereich sein)
+#define TIME_ELAPSED(now, since)     ((uint32_t)((now) - (since)))          // Vergangene Zeit
+#define TIME_REACHED(now, deadline)  ((int32_t)((now) - (deadline)) >= 0)   // Zeitpunkt erreicht
+#define TIME16_REACHED(now, deadline) ((int16_t)((uint16_t)(now) - (uint16_t)(deadline)) >= 0)
+
+// Zusammenhängender Zeitpunkt (alle Felder aus demselben Tick)
+typedef struct {
+	uint32_t s;       // Sekunden seit dem Start
+	uint32_t ms;      // Millisekunden seit dem Start (läuft nach ca. 49 Tagen über)
+	uint32_t counts;  // Timer1-Schritte seit dem Start (läuft nach ca. 13 Tagen über)
+	uint16_t ticks;   // Ticks seit dem Start (läuft nach ca. 11 Minuten über)
+} timebase_t;
+
+// Timer1 einrichten und starten
+void timebase_init(void);
+
+// Atomarer Schnappschuss aller Zähler
+void timebase_now(timebase_t* now);
+
+// Einzelne Zähler (atomar gelesen)
+uint32_t timebase_seconds(void);
+uint32_t timebase_ms(void);
+uint32_t timebase_counts(void);
+uint16_t timebase_ticks(void);
+
+#endif /* TIMEBASE_H_ */
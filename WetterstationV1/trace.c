@@ -0,0 +1,78 @@
+/*
+ * trace.c
+ *
+ * Ablaufprotokoll: Ring binärer Einträge (Format siehe trace.h)
+ * Schreiben mit gesperrten Interrupts (auch aus ISRs), gelesen wird nur im
+ * Hauptprogramm. Der Leser verschiebt nur tail, der Schreiber nur head.
+ *
+ * Created: 18.10.2026 20:52:16
+ *  Author: morri
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "trace.h"
+#include "timebase.h"
+#include "ram.h"
+
+#if TRACE_ENABLE
+
+_Static_assert((TRACE_SIZE & (TRACE_SIZE - 1)) == 0 && TRACE_SIZE <= 128, "TRACE_SIZE muss eine Zweierpotenz bis 128 sein");
+
+static trace_rec_t      ring[TRACE_SIZE];
+static volatile uint8_t head, tail;   // Schreib- und Leseposition (frei laufend, maskiert)
+static uint16_t          lost;        // Verworfene Einträge, noch ohne TRACE_LOST im Ring
+
+RAM_ACCOUNT(trace, sizeof(ring) + sizeof(head) + sizeof(tail) + sizeof(lost));
+
+// Eintrag an Position h schreiben (Platz ist geprüft, Interrupts gesperrt)
+static void put(uint8_t h, uint16_t time, uint8_t id, uint8_t a, uint8_t b) {
+	trace_rec_t* r = &ring[h & (TRACE_SIZE - 1)];
+	r->id   = id;
+	r->time = time;
+	r->a    = a;
+	r->b    = b;
+}
+
+void trace_event(uint8_t id, uint8_t a, uint8_t b) {
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t h    = head;
+	uint8_t used = h - tail;
+	uint16_t now = (uint16_t)timebase_counts();
+	if (lost) {
+		// Nach verworfenen Einträgen zuerst TRACE_LOST an der richtigen Stelle eintragen
+		if (used >= TRACE_SIZE - 1) {
+			if (lost != 0xFFFF) lost++;
+			SREG = sreg;
+			return;
+		}
+		put(h++, now, TRACE_LOST, (uint8_t)lost, lost >> 8);
+		lost = 0;
+	} else if (used >= TRACE_SIZE) {
+		lost = 1;
+		SREG = sreg;
+		return;
+	}
+	put(h, now, id, a, b);
+	head = h + 1;
+	SREG = sreg;
+}
+
+uint8_t trace_count(void) {
+	return (uint8_t)(head - tail);
+}
+
+uint8_t trace_take(trace_rec_t* rec) {
+	uint8_t t = tail;
+	if (t == head) return 0;
+	*rec = ring[t & (TRACE_SIZE - 1)];
+	tail = t + 1;  // Erst nach dem Kopieren freigeben
+	return 1;
+}
+
+#else
+
+RAM_ACCOUNT(trace, 0);
+
+#endif
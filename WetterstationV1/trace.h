@@ -0,0 +1,89 @@
+/*
+ * trace.h
+ *
+ * Header-Datei für das Ablaufprotokoll (Trace)
+ * Ereignisse werden binär in einen Ring im RAM geschrieben: Kennung, Zeitpunkt
+ * (untere 16 Bit von timebase_counts(), 1/3600 s) und zwei Argument-Bytes.
+ * Ein Eintrag kostet nur ein paar Takte, formatiert wird nichts. send_pump()
+ * leert den Ring in freier Zeit als LINK_FRAME_TRACE-Rahmen, lesbar wird das
+ * Protokoll erst auf der Gegenseite (ESP8266 /trace, tools/trace_decode.py).
+ *
+ * Ist der Ring voll, werden neue Ereignisse verworfen und gezählt. Sobald
+ * wieder Platz ist, steht ein TRACE_LOST-Eintrag mit der Anzahl an der Stelle
+ * der Lücke. Zeitpunkte sind eindeutig, solange ein Eintrag höchstens 18 s
+ * (65536 Schritte) auf das Senden wartet.
+ *
+ * Created: 18.10.2026 20:52:16
+ *  Author: morri
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include "link.h"
+
+// Ablaufprotokoll ein-/ausschalten (zur Compile-Zeit, z.B. -DTRACE_ENABLE=1)
+// Standard aus (Flash-Budget des ATmega8), geleert wird der Ring nur im Binärformat
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE       0
+#endif
+#if TRACE_ENABLE && !LINK_BINARY
+#error "TRACE_ENABLE braucht LINK_BINARY"
+#endif
+
+// Einträge im Ring (Zweierpotenz, 5 Bytes je Eintrag)
+#ifndef TRACE_SIZE
+#define TRACE_SIZE         16
+#endif
+
+// Ereignisse (Argumente a, b; Namen im Decoder tools/trace_decode.py)
+#define TRACE_LOST         0   // Lücke im Protokoll: verworfene Einträge (a | b << 8)
+#define TRACE_BOOT         1   // Start: Reset-Ursache (MCUCSR), -
+#define TRACE_TASK         2   // Aufgabe gelaufen: Aufgabe, Laufzeit (1/3600 s, max. 255)
+#define TRACE_OVERRUN      3   // Deadline überschritten: Aufgabe, Verspätung (Ticks, max. 255)
+#define TRACE_SENSOR_GAP   4   // Sensor hat nicht geantwortet: Fehlercode, -
+#define TRACE_I2C_RECOVERY 5   // Bus-Recovery: Fehlercode, -
+#define TRACE_STORE        6   // Datensatz geschrieben: Bereich (REGION_*), Index
+#define TRACE_PAGE         7   // Seitenwechsel: Seite, Quelle (TRACE_SRC_*)
+#define TRACE_RX_FRAME     8   // Rahmen vom ESP8266: Typ, Länge
+#define TRACE_CRC_ERROR    9   // Rahmen verworfen: Typ, Länge
+#define TRACE_RATE         10  // Baudrate umgeschaltet: Stufe, 0 = ausgehandelt / 1 = zurückgefallen
+#define TRACE_RESEND       11  // Gesicherter Rahmen wiederholt: LinkSeq, Verlauf
+#define TRACE_ARENA        12  // Belegung abgewiesen: belegte Phase, angeforderte Phase (ARENA_*)
+
+// Quelle eines Seitenwechsels
+#define TRACE_SRC_BUTTON   0
+#define TRACE_SRC_ESP      1
+
+// Ein Eintrag (Felder in dieser Reihenfolge auch im Rahmen)
+typedef struct {
+	uint8_t  id;       // TRACE_*
+	uint16_t time;     // Untere 16 Bit von timebase_counts() (1/3600 s)
+	uint8_t  a, b;     // Argumente
+} trace_rec_t;
+
+// Größte Anzahl Einträge je Rahmen: Sendezeitpunkt (u32), dann Einträge (5 Bytes)
+#define TRACE_FRAME_HEADER 4
+#define TRACE_FRAME_MAX    ((LINK_TX_MAX_PAYLOAD - TRACE_FRAME_HEADER) / 5)
+
+#if TRACE_ENABLE
+
+// Ereignis eintragen (auch aus ISRs)
+void trace_event(uint8_t id, uint8_t a, uint8_t b);
+
+// Anzahl wartender Einträge
+uint8_t trace_count(void);
+
+// Ältesten Eintrag holen (nur aus dem Hauptprogramm), Rückgabe: 1 = Eintrag in rec
+uint8_t trace_take(trace_rec_t* rec);
+
+#define TRACE(id, a, b)    trace_event(id, a, b)
+
+#else
+
+#define TRACE(id, a, b)    ((void)0)
+
+#endif
+
+#endif /* TRACE_H_ */
@@ -3,16 +3,21 @@
  *
  * Hardware-I2C-Treiber für ATmega8 (TWI-Interface)
  * Implementiert die I2C-Kommunikation über die Hardware-TWI-Schnittstelle
- * Alternative zur Software-I2C-Implementierung in i2cMaster.c
- * 
+ * Alle Wartestellen sind zeitlich begrenzt - ein hängender Sensor oder
+ * eine festgehaltene SDA-Leitung blockiert die Hauptschleife nicht mehr
+ *
  * Original: Peter Fleury <pfleury@gmx.ch>
  * Modified: 25.05.2025 14:11:18
  * Author: morri
- */ 
+ */
 
 #include <inttypes.h>
 #include <compat/twi.h>
+#include <util/delay.h>
+#include <util/delay_basic.h>
+#include "hal.h"
 #include "i2cMaster.h"
+#include "trace.h"
 
 // CPU-Frequenz-Definition (falls nicht im Makefile definiert)
 // Diese Frequenz wird für die TWI-Taktberechnung benötigt
@@ -24,187 +29,264 @@
 // Standard-I2C-Frequenz für die meisten Sensoren
 #define SCL_CLOCK  100000L
 
+// I2C-Pins für die Bus-Recovery (werden dann per GPIO angesteuert): hal.h
+#define I2C_SDA   HAL_I2C_SDA  // Serial Data Line (PC4)
+#define I2C_SCL   HAL_I2C_SCL  // Serial Clock Line (PC5)
+
+// Wartezeit einer Busoperation in Abfragen von TWCR
+// Eine Abfrage dauert I2C_POLL_CYCLES CPU-Takte: _delay_loop_1() braucht genau 3 Takte
+// je Durchlauf, dazu kommen Lesen und Prüfen von TWCR, Zähler und Rücksprung der
+// Schleife in i2c_poll() (I2C_POLL_OVERHEAD, aus dem Assembler-Listing mit -Os, aufgerundet)
+// Bei 3,6864 MHz: 108 Abfragen zu 34 Takten = 996 µs
+#define I2C_POLL_DELAY     8
+#define I2C_POLL_OVERHEAD  10
+#define I2C_POLL_CYCLES    (3 * I2C_POLL_DELAY + I2C_POLL_OVERHEAD)
+#define I2C_WAIT_POLLS     ((uint16_t)((F_CPU / 1000) * I2C_WAIT_TIMEOUT_US / 1000 / I2C_POLL_CYCLES))
+_Static_assert(I2C_WAIT_POLLS > 0, "I2C_WAIT_TIMEOUT_US kürzer als eine Abfrage");
+
+// Fehler der laufenden Transaktion (wird bei i2c_start() zurückgesetzt)
+static uint8_t     i2c_status;
+// Zähler für die Statistik
+static i2c_stats_t i2c_stats;
+
+// Fehler merken und zählen
+// Nur der erste Fehler einer Transaktion wird als Status gemerkt
+static uint8_t i2c_fail(uint8_t error) {
+	if (i2c_status == I2C_OK) i2c_status = error;
+	i2c_stats.errors++;
+	if (error == I2C_ERROR_TIMEOUT) i2c_stats.timeouts++;
+	if (error == I2C_ERROR_NACK)    i2c_stats.nacks++;
+	return error;
+}
+
+// TWCR abfragen, bis (TWCR & mask) == value gilt
+// Rückgabe: 1 = erreicht, 0 = nach I2C_WAIT_POLLS Abfragen (höchstens I2C_WAIT_TIMEOUT_US) nicht
+static uint8_t i2c_poll(uint8_t mask, uint8_t value) {
+	for (uint16_t n = I2C_WAIT_POLLS; n; n--) {
+		if ((hal_twi_flags() & mask) == value) return 1;
+		_delay_loop_1(I2C_POLL_DELAY);
+	}
+	return 0;
+}
+
+// Warten bis TWINT gesetzt ist (Busoperation abgeschlossen)
+// Rückgabe: I2C_OK oder I2C_ERROR_TIMEOUT nach höchstens I2C_WAIT_TIMEOUT_US
+static uint8_t i2c_wait(void) {
+	if (i2c_poll(1<<TWINT, 1<<TWINT)) return I2C_OK;
+	// Hardware zurücksetzen, damit die nächste Transaktion sauber beginnt
+	hal_twi_control(0);
+	return i2c_fail(I2C_ERROR_TIMEOUT);
+}
+
 // TWI-Initialisierung
 // Konfiguriert die Hardware-TWI-Schnittstelle für I2C-Kommunikation
 void i2c_init(void) {
 	// TWI-Takt initialisieren: 100 kHz, TWPS = 0 => Prescaler = 1
 	// TWSR (TWI Status Register) auf 0 setzen = kein Prescaler
-	
-	TWSR = 0;  // Kein Prescaler (TWPS1:0 = 00)
-	
+
 	// TWBR (TWI Bit Rate Register) berechnen
 	// Formel: TWBR = ((F_CPU / SCL_CLOCK) - 16) / 2
-	// Bei 3.6864 MHz und 100 kHz: TWBR = ((3686400 / 100000) - 16) / 2 = 2
-	// Muss > 10 sein für stabile Operation
-	TWBR = ((F_CPU/SCL_CLOCK)-16)/2;
+	// Bei 3.6864 MHz und 100 kHz: TWBR = ((3686400 / 100000) - 16) / 2 = 10
+	hal_twi_init(((F_CPU/SCL_CLOCK)-16)/2);
 }
 
 // I2C-Start-Bedingung erzeugen und Geräteadresse senden
 // Sendet eine Start-Bedingung und adressiert ein I2C-Gerät
-// 
+//
 // Parameter: address - Geräteadresse mit R/W-Bit
-// Rückgabe: 0 = Gerät erreichbar, 1 = Gerät nicht erreichbar
-unsigned char i2c_start(unsigned char address) {
+// Rückgabe: I2C_OK = Gerät erreichbar, sonst Fehlercode
+uint8_t i2c_start(uint8_t address) {
 	uint8_t twst;  // TWI-Status-Variable
-	
+
+	i2c_status = I2C_OK;  // Neue Transaktion beginnt
+	i2c_stats.transactions++;
+
 	// START-Bedingung senden
 	// TWINT = 1 (Interrupt-Flag setzen), TWSTA = 1 (START senden), TWEN = 1 (TWI aktivieren)
-	TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN);
-	
-	// Warten bis Übertragung abgeschlossen ist
-	// TWINT wird automatisch auf 1 gesetzt wenn Operation abgeschlossen ist
-	while(!(TWCR & (1<<TWINT)));
-	
+	hal_twi_control((1<<TWINT) | (1<<TWSTA) | (1<<TWEN));
+
+	// Warten bis Übertragung abgeschlossen ist (mit Timeout)
+	if (i2c_wait()) return i2c_status;
+
 	// TWI-Status-Register prüfen (Prescaler-Bits maskieren)
 	// Nur die oberen 5 Bits enthalten den Status
-	twst = TW_STATUS & 0xF8;
-	
+	twst = hal_twi_status();
+
 	// Prüfen ob START oder REPEATED START erfolgreich war
 	if ((twst != TW_START) && (twst != TW_REP_START)) {
-		return 1;  // START-Bedingung fehlgeschlagen
+		return i2c_fail(I2C_ERROR_START);  // START-Bedingung fehlgeschlagen
 	}
-	
+
 	// Geräteadresse senden
-	TWDR = address;  // Adresse in TWI Data Register schreiben
-	TWCR = (1<<TWINT) | (1<<TWEN);  // Übertragung starten
-	
+	hal_twi_put(address);  // Adresse in TWI Data Register schreiben
+	hal_twi_control((1<<TWINT) | (1<<TWEN));  // Übertragung starten
+
 	// Warten bis Übertragung abgeschlossen und ACK/NACK empfangen wurde
-	while(!(TWCR & (1<<TWINT)));
-	
+	if (i2c_wait()) return i2c_status;
+
 	// TWI-Status-Register erneut prüfen
-	twst = TW_STATUS & 0xF8;
-	
+	twst = hal_twi_status();
+
 	// Prüfen ob ACK empfangen wurde (Master Transmitter oder Master Receiver)
 	if ((twst != TW_MT_SLA_ACK) && (twst != TW_MR_SLA_ACK)) {
-		return 1;  // Kein ACK empfangen = Gerät nicht erreichbar
+		return i2c_fail(I2C_ERROR_NACK);  // Kein ACK empfangen = Gerät nicht erreichbar
 	}
-	
-	return 0;  // Erfolgreich
+
+	return I2C_OK;  // Erfolgreich
 }
 
 // I2C-Start mit Warten (ACK-Polling)
 // Sendet eine Start-Bedingung und wartet bis das Gerät bereit ist
-// Verwendet ACK-Polling um auf ein beschäftigtes Gerät zu warten
-// 
+// Die Anzahl der Versuche ist begrenzt, damit ein fehlendes Gerät nicht blockiert
+//
 // Parameter: address - Geräteadresse mit R/W-Bit
-void i2c_start_wait(unsigned char address) {
-	uint8_t twst;  // TWI-Status-Variable
-	
-	// Schleife bis Gerät bereit ist
-	while (1) {
-		// START-Bedingung senden
-		TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN);
-		
-		// Warten bis Übertragung abgeschlossen ist
-		while(!(TWCR & (1<<TWINT)));
-		
-		// TWI-Status-Register prüfen
-		twst = TW_STATUS & 0xF8;
-		if ((twst != TW_START) && (twst != TW_REP_START)) {
-			continue;  // START fehlgeschlagen, erneut versuchen
-		}
-		
-		// Geräteadresse senden
-		TWDR = address;
-		TWCR = (1<<TWINT) | (1<<TWEN);
-		
-		// Warten bis Übertragung abgeschlossen ist
-		while(!(TWCR & (1<<TWINT)));
-		
-		// TWI-Status-Register prüfen
-		twst = TW_STATUS & 0xF8;
-		
-		// Prüfen ob Gerät beschäftigt ist (NACK empfangen)
-		if ((twst == TW_MT_SLA_NACK) || (twst == TW_MR_DATA_NACK)) {
-			// Gerät beschäftigt, STOP-Bedingung senden um Schreiboperation zu beenden
-			TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO);
-			
-			// Warten bis STOP-Bedingung ausgeführt und Bus freigegeben ist
-			while(TWCR & (1<<TWSTO));
-			
-			continue;  // Erneut versuchen
-		}
-		
-		break;  // Gerät bereit, Schleife verlassen
+// Rückgabe: I2C_OK oder Fehler des letzten Versuchs
+uint8_t i2c_start_wait(uint8_t address) {
+	uint8_t status = I2C_ERROR_START;
+
+	for (uint8_t attempt = 0; attempt < I2C_RETRY_COUNT; attempt++) {
+		status = i2c_start(address);
+		if (status == I2C_OK) break;  // Gerät bereit
+
+		// Gerät beschäftigt oder Bus gestört: STOP senden und erneut versuchen
+		i2c_stop();
 	}
+	return status;
 }
 
 // I2C-Repeated Start-Bedingung
 // Sendet eine wiederholte Start-Bedingung (ohne vorherigen STOP)
-// 
+//
 // Parameter: address - Geräteadresse mit R/W-Bit
-// Rückgabe: 0 = Gerät erreichbar, 1 = Gerät nicht erreichbar
-unsigned char i2c_rep_start(unsigned char address) {
+// Rückgabe: I2C_OK = Gerät erreichbar, sonst Fehlercode
+uint8_t i2c_rep_start(uint8_t address) {
 	// Repeated Start ist identisch zu normalem Start
 	return i2c_start(address);
 }
 
 // I2C-Stop-Bedingung erzeugen
 // Beendet die Datenübertragung und gibt den I2C-Bus frei
-void i2c_stop(void) {
+//
+// Rückgabe: I2C_OK oder der erste Fehler der Transaktion
+uint8_t i2c_stop(void) {
 	// STOP-Bedingung senden
 	// TWINT = 1 (Interrupt-Flag setzen), TWEN = 1 (TWI aktivieren), TWSTO = 1 (STOP senden)
-	TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO);
-	
+	hal_twi_control((1<<TWINT) | (1<<TWEN) | (1<<TWSTO));
+
 	// Warten bis STOP-Bedingung ausgeführt und Bus freigegeben ist
 	// TWSTO wird automatisch auf 0 gesetzt wenn STOP abgeschlossen ist
-	while(TWCR & (1<<TWSTO));
+	if (!i2c_poll(1<<TWSTO, 0)) {
+		hal_twi_control(0);  // Hardware zurücksetzen
+		i2c_fail(I2C_ERROR_STOP);
+	}
+
+	return i2c_status;
 }
 
 // Ein Byte an I2C-Gerät senden
 // Sendet ein Datenbyte an das zuvor adressierte I2C-Gerät
-// 
+//
 // Parameter: data - Zu sendendes Byte
-// Rückgabe: 0 = Schreiben erfolgreich, 1 = Schreiben fehlgeschlagen
-unsigned char i2c_write(unsigned char data) {
+// Rückgabe: I2C_OK = Schreiben erfolgreich, sonst Fehlercode
+uint8_t i2c_write(uint8_t data) {
 	uint8_t twst;  // TWI-Status-Variable
-	
+
+	// Nach einem Fehler nichts mehr auf den Bus legen
+	if (i2c_status) return i2c_status;
+
 	// Daten an das zuvor adressierte Gerät senden
-	TWDR = data;  // Daten in TWI Data Register schreiben
-	TWCR = (1<<TWINT) | (1<<TWEN);  // Übertragung starten
-	
-	// Warten bis Übertragung abgeschlossen ist
-	while(!(TWCR & (1<<TWINT)));
-	
+	hal_twi_put(data);  // Daten in TWI Data Register schreiben
+	hal_twi_control((1<<TWINT) | (1<<TWEN));  // Übertragung starten
+
+	// Warten bis Übertragung abgeschlossen ist (mit Timeout)
+	if (i2c_wait()) return i2c_status;
+
 	// TWI-Status-Register prüfen (Prescaler-Bits maskieren)
-	twst = TW_STATUS & 0xF8;
-	
+	twst = hal_twi_status();
+
 	// Prüfen ob ACK empfangen wurde
 	if (twst != TW_MT_DATA_ACK) {
-		return 1;  // Kein ACK = Schreiben fehlgeschlagen
+		return i2c_fail(I2C_ERROR_DATA);  // Kein ACK = Schreiben fehlgeschlagen
 	}
-	
-	return 0;  // Erfolgreich
+
+	i2c_stats.bytes_sent++;
+	return I2C_OK;  // Erfolgreich
+}
+
+// Ein Byte von I2C-Gerät lesen
+// ack = 1: ACK senden (weitere Daten), ack = 0: NACK senden (letztes Byte)
+static uint8_t i2c_read(uint8_t ack) {
+	// Nach einem Fehler nichts mehr auf den Bus legen
+	if (i2c_status) return 0xFF;
+
+	// TWINT = 1 (Interrupt-Flag setzen), TWEN = 1 (TWI aktivieren), TWEA = ACK/NACK
+	hal_twi_control((1<<TWINT) | (1<<TWEN) | (ack ? (1<<TWEA) : 0));
+
+	// Warten bis Übertragung abgeschlossen ist (mit Timeout)
+	if (i2c_wait()) return 0xFF;
+
+	i2c_stats.bytes_received++;
+
+	// Gelesenes Byte aus TWI Data Register zurückgeben
+	return hal_twi_get();
 }
 
 // Ein Byte von I2C-Gerät lesen (mit ACK)
 // Liest ein Byte vom I2C-Gerät und sendet ACK für weitere Daten
-// 
-// Rückgabe: Gelesenes Byte vom I2C-Gerät
-unsigned char i2c_readAck(void) {
-	// Byte lesen und ACK senden (für weitere Daten)
-	// TWINT = 1 (Interrupt-Flag setzen), TWEN = 1 (TWI aktivieren), TWEA = 1 (ACK senden)
-	TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWEA);
-	
-	// Warten bis Übertragung abgeschlossen ist
-	while(!(TWCR & (1<<TWINT)));
-	
-	// Gelesenes Byte aus TWI Data Register zurückgeben
-	return TWDR;
+//
+// Rückgabe: Gelesenes Byte vom I2C-Gerät (0xFF bei Fehler)
+uint8_t i2c_readAck(void) {
+	return i2c_read(1);
 }
 
 // Ein Byte von I2C-Gerät lesen (mit NACK)
 // Liest ein Byte vom I2C-Gerät und sendet NACK (letztes Byte)
-// 
-// Rückgabe: Gelesenes Byte vom I2C-Gerät
-unsigned char i2c_readNak(void) {
-	// Byte lesen und NACK senden (letztes Byte)
-	// TWINT = 1 (Interrupt-Flag setzen), TWEN = 1 (TWI aktivieren), TWEA = 0 (NACK senden)
-	TWCR = (1<<TWINT) | (1<<TWEN);
-	
-	// Warten bis Übertragung abgeschlossen ist
-	while(!(TWCR & (1<<TWINT)));
-	
-	// Gelesenes Byte aus TWI Data Register zurückgeben
-	return TWDR;
+//
+// Rückgabe: Gelesenes Byte vom I2C-Gerät (0xFF bei Fehler)
+uint8_t i2c_readNak(void) {
+	return i2c_read(0);
+}
+
+// I2C-Bus-Status prüfen
+// Gibt 1 zurück wenn SDA und SCL High sind
+uint8_t i2c_bus_free(void) {
+	return hal_i2c_lines() == (I2C_SDA | I2C_SCL);
+}
+
+// I2C-Bus freitakten (Bus-Recovery nach I2C-Spezifikation)
+// Ein Slave, der mitten in einem Lesezugriff unterbrochen wurde, hält SDA auf Low.
+// Bis zu 9 Takte auf SCL lassen ihn sein Byte zu Ende schieben, danach beendet
+// eine STOP-Bedingung die Transaktion.
+void i2c_bus_recover(void) {
+	hal_twi_control(0);  // TWI abschalten, Pins werden wieder normale GPIOs
+
+	// Open-Drain nachbilden: Low = Ausgang mit 0, High = Eingang mit Pull-up
+	hal_i2c_pull(0);
+	_delay_us(5);
+
+	// Bis zu 9 Takte, bis der Slave SDA freigibt
+	for (uint8_t i = 0; i < 9 && !(hal_i2c_lines() & I2C_SDA); i++) {
+		hal_i2c_pull(I2C_SCL);            // SCL Low
+		_delay_us(5);
+		hal_i2c_pull(0);                  // SCL High (loslassen)
+		_delay_us(5);
+	}
+
+	// STOP-Bedingung: SDA Low -> SCL High -> SDA High
+	hal_i2c_pull(I2C_SCL);                // SCL Low
+	hal_i2c_pull(I2C_SCL | I2C_SDA);      // SDA Low
+	_delay_us(5);
+	hal_i2c_pull(I2C_SDA);                // SCL High
+	_delay_us(5);
+	hal_i2c_pull(0);                      // SDA High = STOP
+	_delay_us(5);
+
+	i2c_stats.recoveries++;
+	TRACE(TRACE_I2C_RECOVERY, i2c_status, 0);
+	i2c_init();  // TWI wieder einrichten
+}
+
+// I2C-Statistiken abrufen
+void i2c_get_stats(i2c_stats_t* stats) {
+	*stats = i2c_stats;
 }
@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+#
+# avr_bench.py
+#
+# Auswertung des Benchmarks der Rechenkerne (WetterstationV1/bench/bench.c)
+# Startet das ELF unter simavr, liest die Zeilen "K:<Name>;<Aufrufe>;<Min>;<Max>;<Summe>"
+# vom UART und ergänzt je Kern den Flash-Bedarf (Symbolgrößen aus avr-nm), den
+# Stack-Rahmen (.su-Dateien von -fstack-usage) und den statischen RAM des Moduls
+# (avr-size der Objektdatei). Ausgabe als JSON (Standard) oder CSV.
+#
+# Die Kerne sind auf mehrere Abbilder verteilt (je Gruppe ein ELF, alle zusammen passen
+# nicht in 8 KB Flash): --elf mehrfach angeben, die Ergebnisse werden zusammengeführt.
+# Mit --log (je ELF einmal, gleiche Reihenfolge) werden gespeicherte simavr-Mitschnitte
+# ausgewertet statt simavr zu starten.
+#
+# Messwerte sind nur Läufe von avr-gcc-Abbildern unter simavr. Stammen Abbild oder
+# Mitschnitt aus einem anderen Compiler oder Simulator, beschreibt --estimate den
+# Aufbau; der Bericht ist dann als Schätzung gekennzeichnet (JSON "estimate",
+# CSV mit Kommentarzeile davor).
+#
+# Created: 18.10.2026 23:58:20
+#  Author: morri
+#
+
+import argparse
+import csv
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+
+# Kern: (Modul, Symbole im ELF) - das erste vorhandene Symbol zählt für den Flash,
+# fehlt die Funktion (eingebettet), wird der Einstiegspunkt des Benchmarks genommen
+KERNELS = {
+    "bme280_compensate_temp":  ("Sensor.c",  ["bme280_compensate_temp"]),
+    "bme280_compensate_press": ("Sensor.c",  ["bme280_compensate_press"]),
+    "bme280_compensate_hum":   ("Sensor.c",  ["bme280_compensate_hum"]),
+    "fmt_u16":                 ("fmt.c",     ["fmt_u16"]),
+    "fmt_i16":                 ("fmt.c",     ["fmt_i16"]),
+    "fmt_u32":                 ("fmt.c",     ["fmt_u32"]),
+    "fmt_i32":                 ("fmt.c",     ["fmt_i32"]),
+    "drawLine":                ("display.c", ["drawLine", "bench_drawLine"]),
+    "drawChar":                ("display.c", ["drawChar", "bench_drawChar"]),
+    "prepareGraph":            ("display.c", ["prepareGraph"]),
+    "drawPlot8":               ("display.c", ["drawPlot8", "bench_drawPlot8"]),
+    "renderScene":             ("display.c", ["renderScene"]),
+    "storage_load_graph":      ("storage.c", ["storage_load_graph"]),
+    "storage_add_sample":      ("storage.c", ["storage_add_sample"]),
+}
+
+ANSI = re.compile(r"\x1b\[[0-9;]*m")
+LINE = re.compile(r"K:(\w+);(\d+);(\d+);(\d+);(\d+)")
+
+
+# Zeilen des Benchmarks aus der Ausgabe von simavr (Farbcodes und Präfixe werden ignoriert)
+def parse_output(text):
+    results, done = [], False
+    for line in ANSI.sub("", text).splitlines():
+        m = LINE.search(line)
+        if m:
+            calls, lo, hi, total = (int(g) for g in m.groups()[1:])
+            results.append({"name": m.group(1), "calls": calls, "min": lo, "max": hi, "sum": total})
+        elif line.strip().endswith("END"):
+            done = True
+    return results, done
+
+
+def run_simavr(simavr, mcu, freq, elf, timeout):
+    p = subprocess.run([simavr, "-m", mcu, "-f", str(freq), elf],
+                       stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=timeout)
+    return p.stdout.decode("utf-8", "replace")
+
+
+# Symbolgrößen aus "avr-nm -S": Name -> Bytes (nur Code, Typ t/T)
+def parse_nm(text):
+    sizes = {}
+    for line in text.splitlines():
+        f = line.split()
+        if len(f) == 4 and f[2] in "tT":
+            sizes[f[3]] = sizes.get(f[3], 0) + int(f[1], 16)
+    return sizes
+
+
+# Stack-Rahmen aus den .su-Dateien: "datei.c:Zeile:Spalte:Funktion<TAB>Bytes<TAB>Art"
+def parse_su(texts):
+    frames = {}
+    for text in texts:
+        for line in text.splitlines():
+            f = line.split("\t")
+            if len(f) >= 2:
+                loc = f[0].split(":")
+                frames[(os.path.basename(loc[0]), loc[-1])] = int(f[1])
+    return frames
+
+
+# "avr-size" im Berkeley-Format: text, data, bss
+def parse_size(text):
+    for line in text.splitlines()[1:]:
+        f = line.split()
+        if len(f) >= 3 and f[0].isdigit():
+            return {"text": int(f[0]), "data": int(f[1]), "bss": int(f[2])}
+    return None
+
+
+def tool(cmd):
+    return subprocess.run(cmd, stdout=subprocess.PIPE, check=True).stdout.decode()
+
+
+# Objektdatei des Moduls (CMake: .obj, sonst .o; nicht die .d-Dateien daneben)
+def object_of(objdir, module):
+    for ext in (".o", ".obj"):
+        for path in glob.glob(os.path.join(objdir, "**", module + ext), recursive=True):
+            return path
+    return None
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Benchmark der Rechenkerne unter simavr ausführen und auswerten")
+    ap.add_argument("--elf", required=True, action="append", help="Abbild des Benchmarks (mehrfach)")
+    ap.add_argument("--objdir", help="Build-Verzeichnis (Objekt- und .su-Dateien)")
+    ap.add_argument("--log", action="append", help="Gespeicherte Ausgabe von simavr je ELF statt simavr zu starten")
+    ap.add_argument("--simavr", default="simavr")
+    ap.add_argument("--nm", default="avr-nm")
+    ap.add_argument("--size", default="avr-size")
+    ap.add_argument("--mcu", default="atmega8")
+    ap.add_argument("--freq", type=int, default=3686400)
+    ap.add_argument("--timeout", type=int, default=120, help="Höchstdauer des simavr-Laufs (s)")
+    ap.add_argument("--csv", action="store_true", help="CSV statt JSON")
+    ap.add_argument("--out", help="Ausgabedatei (Standard: stdout)")
+    ap.add_argument("--estimate", metavar="AUFBAU",
+                    help="Kein avr-gcc/simavr: Compiler und Simulator, Bericht gilt als Schätzung")
+    args = ap.parse_args()
+
+    if args.log and len(args.log) != len(args.elf):
+        ap.error("--log je --elf einmal angeben")
+
+    results, sizes, images = [], {}, []
+    for i, elf in enumerate(args.elf):
+        if args.log:
+            with open(args.log[i], encoding="utf-8", errors="replace") as f:
+                text = f.read()
+        else:
+            text = run_simavr(args.simavr, args.mcu, args.freq, elf, args.timeout)
+        r, done = parse_output(text)
+        if not done:
+            sys.stderr.write("%s: Benchmark unvollständig (kein END in der Ausgabe)\n" % elf)
+            sys.exit(1)
+        results += r
+        sizes.update(parse_nm(tool([args.nm, "-S", elf])))
+        total = parse_size(tool([args.size, "-B", elf]))
+        images.append({
+            "elf": os.path.basename(elf),
+            "flash": total["text"] + total["data"] if total else None,
+            "ram": total["data"] + total["bss"] if total else None,
+        })
+
+    su_texts, module_ram = [], {}
+    if args.objdir:
+        for path in glob.glob(os.path.join(args.objdir, "**", "*.su"), recursive=True):
+            with open(path) as f:
+                su_texts.append(f.read())
+    frames = parse_su(su_texts)
+
+    kernels = []
+    for r in results:
+        module, symbols = KERNELS.get(r["name"], (None, [r["name"]]))
+        symbol = next((s for s in symbols if s in sizes), None)
+        if module and args.objdir and module not in module_ram:
+            obj = object_of(args.objdir, module)
+            sz = parse_size(tool([args.size, "-B", obj])) if obj else None
+            module_ram[module] = sz["data"] + sz["bss"] if sz else None
+        r["mean"] = round(r["sum"] / r["calls"], 1) if r["calls"] else None
+        r["mean_us"] = round(r["mean"] * 1e6 / args.freq, 1) if r["calls"] else None
+        r["flash"] = sizes.get(symbol) if symbol else None
+        r["flash_symbol"] = symbol           # != Name: Funktion eingebettet
+        r["stack_frame"] = frames.get((module, symbol)) if symbol else None
+        r["module"] = module
+        r["module_ram"] = module_ram.get(module)
+        kernels.append(r)
+
+    report = {
+        "mcu": args.mcu,
+        "f_cpu": args.freq,
+        "estimate": args.estimate,           # None = gemessen (avr-gcc, simavr)
+        "images": images,
+        "kernels": kernels,
+    }
+
+    out = open(args.out, "w", newline="") if args.out else sys.stdout
+    if args.csv:
+        cols = ["name", "calls", "min", "max", "mean", "sum", "mean_us",
+                "flash", "flash_symbol", "stack_frame", "module", "module_ram"]
+        if args.estimate:
+            out.write("# Schätzung: %s\n" % args.estimate)
+        w = csv.DictWriter(out, fieldnames=cols, lineterminator="\n")
+        w.writeheader()
+        w.writerows(kernels)
+    else:
+        json.dump(report, out, indent=2)
+        out.write("\n")
+    if args.out:
+        out.close()
+        sys.stdout.write("%d Kerne -> %s%s\n" % (len(kernels), args.out, " (Schätzung)" if args.estimate else ""))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+#
+# ram_map.py
+#
+# Statischer RAM je Modul aus der Map-Datei des Linkers (avr-gcc/GNU ld
+# oder lld): .data und .bss jedes Objekts, Konstanten im RAM (.rodata liegt
+# beim AVR in .data), Summe und freier Platz für den Stack.
+#
+# Mit --elf (Build mit DIAG_ENABLE) werden die RAM_ACCOUNT-Einträge der
+# Module (ram_account_<modul> im Flash) mit der Map verglichen, mit
+# --min-free die Reserve für den Stack geprüft. Rückgabe 1 bei Abweichung
+# oder zu wenig Reserve.
+#
+# Created: 18.10.2026 23:58:20
+#  Author: morri
+#
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+RAM_SIZE = 1024              # SRAM des ATmega8 (Bytes)
+
+# GNU ld: Ausgabe-Abschnitt am Zeilenanfang, Eingabe-Abschnitt eingerückt, Name und
+# Adresse/Größe/Objekt stehen bei langen Namen auf zwei Zeilen
+GNU_OUT   = re.compile(r"^(\.\S+)")
+GNU_IN    = re.compile(r"^ (\S+)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+\.o\)?)$")
+GNU_NAME  = re.compile(r"^ (\S+)$")
+# lld: VMA LMA Size Align, dann Ausgabe-Abschnitt oder Objekt:(Eingabe-Abschnitt)
+LLD_OUT   = re.compile(r"^\s*[0-9a-f]+\s+[0-9a-f]+\s+[0-9a-f]+\s+\d+ (\.\S+)$")
+LLD_IN    = re.compile(r"^\s*[0-9a-f]+\s+[0-9a-f]+\s+([0-9a-f]+)\s+\d+\s+(.+):\((\S+)\)$")
+
+
+def module(obj):
+    # "Debug/main.o", "libc.a(strlen.o)", "<internal>" -> "main", "libc.a", "<internal>"
+    if obj.endswith(")") and "(" in obj:
+        obj = obj[:obj.index("(")]
+    base = os.path.basename(obj)
+    return base[:-2] if base.endswith(".o") else base
+
+
+def kind(out, sec):
+    # Eingabe-Abschnitt einordnen: Variable (.data/.bss) oder Konstante im RAM
+    if out not in (".data", ".bss", ".noinit"):
+        return None
+    if sec.startswith(".rodata"):
+        return "rodata"
+    if sec == "COMMON" or sec.startswith(".bss") or sec.startswith(".noinit"):
+        return "bss"
+    if sec.startswith(".data"):
+        return "data"
+    return None
+
+
+def parse_map(path):
+    lines = open(path, encoding="latin-1").read().splitlines()
+    lld = bool(lines) and lines[0].split()[:3] == ["VMA", "LMA", "Size"]
+    if not lld:
+        # Verworfene Abschnitte und gemeinsame Symbole am Anfang überspringen
+        for i, l in enumerate(lines):
+            if l.startswith("Linker script and memory map"):
+                lines = lines[i + 1:]
+                break
+    mods = {}
+    out, pending = None, None
+    for l in lines:
+        if lld:
+            m = LLD_OUT.match(l)
+            if m:
+                out = m.group(1)
+                continue
+            m = LLD_IN.match(l)
+            if not m:
+                continue
+            size, obj, sec = int(m.group(1), 16), m.group(2), m.group(3)
+        else:
+            m = GNU_OUT.match(l)
+            if m:
+                out, pending = m.group(1), None
+                continue
+            m = GNU_NAME.match(l)
+            if m and not l.startswith(" *"):
+                pending = m.group(1)
+                continue
+            m = GNU_IN.match(l)
+            if not m:
+                pending = None
+                continue
+            sec = m.group(1) or pending
+            size, obj = int(m.group(3), 16), m.group(4)
+            pending = None
+            if sec is None:
+                continue
+        k = kind(out, sec)
+        if k and size:
+            entry = mods.setdefault(module(obj), {"data": 0, "bss": 0, "rodata": 0})
+            entry[k] += size
+    return mods
+
+
+def read_accounts(path):
+    # ram_account_<modul> aus der Symboltabelle, Wert aus dem Abschnitt lesen
+    d = open(path, "rb").read()
+    shoff, = struct.unpack_from("<I", d, 32)
+    shentsize, shnum = struct.unpack_from("<HH", d, 46)
+    secs = [struct.unpack_from("<10I", d, shoff + i * shentsize) for i in range(shnum)]
+    accounts = {}
+    for s in secs:
+        if s[1] != 2:        # SHT_SYMTAB
+            continue
+        strtab = secs[s[6]]
+        for off in range(s[4], s[4] + s[5], 16):
+            st_name, st_value, st_size, st_info, st_other, st_shndx = struct.unpack_from("<IIIBBH", d, off)
+            end = d.index(b"\0", strtab[4] + st_name)
+            name = d[strtab[4] + st_name:end].decode()
+            if not name.startswith("ram_account_") or st_shndx == 0 or st_shndx >= shnum:
+                continue
+            sec = secs[st_shndx]
+            value, = struct.unpack_from("<H", d, sec[4] + st_value - sec[3])
+            accounts[name[len("ram_account_"):]] = value
+    return accounts
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Statischen RAM je Modul aus der Map-Datei ermitteln")
+    ap.add_argument("map", help="Map-Datei des Linkers (-Wl,-Map)")
+    ap.add_argument("--elf", help="ELF mit DIAG_ENABLE: RAM_ACCOUNT-Einträge vergleichen")
+    ap.add_argument("--min-free", type=int, default=0, help="Mindestreserve für den Stack (Bytes)")
+    args = ap.parse_args()
+
+    mods = parse_map(args.map)
+    accounts = read_accounts(args.elf) if args.elf else {}
+    errors = 0
+
+    print("%-14s %6s %6s %6s %6s %8s" % ("Modul", ".data", ".bss", "Konst.", "Summe", "Eintrag"))
+    for name in sorted(mods, key=lambda n: -sum(mods[n].values())):
+        e = mods[name]
+        var = e["data"] + e["bss"]
+        mark = ""
+        if name in accounts:
+            mark = "%8d" % accounts[name]
+            if accounts[name] != var:
+                mark += "  !="
+                errors += 1
+        print("%-14s %6d %6d %6d %6d %s" % (name, e["data"], e["bss"], e["rodata"], var + e["rodata"], mark))
+    for name in sorted(set(accounts) - set(mods)):
+        if accounts[name]:
+            print("%-14s %6s %6s %6s %6d %8d  !=" % (name, "-", "-", "-", 0, accounts[name]))
+            errors += 1
+
+    total = sum(sum(e.values()) for e in mods.values())
+    free = RAM_SIZE - total
+    print("Statisch %d Bytes, frei für den Stack %d Bytes" % (total, free))
+    if errors:
+        print("%d RAM_ACCOUNT-Einträge passen nicht zur Map" % errors, file=sys.stderr)
+    if free < args.min_free:
+        print("Reserve %d Bytes < %d Bytes" % (free, args.min_free), file=sys.stderr)
+        errors += 1
+    sys.exit(1 if errors else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# trace_decode.py
+#
+# Decoder für das Ablaufprotokoll des ATmega8 (WetterstationV1/trace.h)
+# Liest die Einträge von der /trace-Route des ESP8266 (URL oder gespeicherte
+# Antwort) oder aus einem Mitschnitt der seriellen Leitung (Rahmen 0x20) und
+# gibt sie als Text aus: Zeit seit dem ersten Eintrag, Abstand, Ereignis.
+#
+# Die Namen und Argumente müssen zu den TRACE_*-Nummern in trace.h passen.
+#
+# Created: 18.10.2026 21:14:03
+#  Author: morri
+#
+
+import argparse
+import json
+import sys
+import urllib.request
+
+COUNTS_PER_S = 3600          # Timer1-Schritte pro Sekunde (timebase.h)
+LINK_FLAG, LINK_ESC, LINK_ESC_XOR = 0x7E, 0x7D, 0x20
+LINK_FRAME_TRACE = 0x20
+
+TASKS   = ["rx", "button", "display", "measure", "pump"]            # TASK_* in main.c
+REGIONS = ["24h", "7d", "raw"]                                      # REGION_* in storage.h
+PHASES  = ["free", "boot", "graph", "render"]                       # ARENA_* in arena.h
+I2C     = ["ok", "start", "addr", "data", "stop", "timeout", "nack"]  # I2C_* in i2cMaster.h
+RATES   = [28800, 57600, 115200, 230400]                            # RS232_RATE_BAUD(n)
+SOURCES = ["button", "esp"]                                         # TRACE_SRC_*
+FRAMES  = {0x10: "PAGE", 0x11: "GET_SERIES", 0x12: "RATE_QUERY", 0x13: "RATE_SET", 0x14: "PROBE",
+           0x15: "RATE_COMMIT", 0x16: "GET_CURRENT", 0x17: "GET_CHUNK", 0x18: "GET_PACKED",
+           0x19: "ACK", 0x1A: "GET_PROFILE"}
+
+
+def name(table, i):
+    return table[i] if i < len(table) else str(i)
+
+
+def reset_cause(mcucsr):
+    bits = [n for b, n in enumerate(["power-on", "extern", "brown-out", "watchdog"]) if mcucsr & (1 << b)]
+    return "+".join(bits) or "unbekannt"
+
+
+def ms(counts):
+    return counts * 1000.0 / COUNTS_PER_S
+
+
+# Ereignis: (Name, Formatierung der Argumente a, b)
+EVENTS = {
+    0:  ("lost",         lambda a, b: "%d Einträge verworfen" % (a | b << 8)),
+    1:  ("boot",         lambda a, b: "Reset: %s (MCUCSR 0x%02X)" % (reset_cause(a), a)),
+    2:  ("task",         lambda a, b: "%-8s %s%.1f ms" % (name(TASKS, a), ">=" if b == 255 else "", ms(b))),
+    3:  ("overrun",      lambda a, b: "%-8s %s%d Ticks zu spät" % (name(TASKS, a), ">=" if b == 255 else "", b)),
+    4:  ("sensor_gap",   lambda a, b: "Fehler %d" % a),
+    5:  ("i2c_recovery", lambda a, b: "nach %s" % name(I2C, a)),
+    6:  ("store",        lambda a, b: "%-8s Index %d" % (name(REGIONS, a), b)),
+    7:  ("page",         lambda a, b: "Seite %d (%s)" % (a, name(SOURCES, b))),
+    8:  ("rx_frame",     lambda a, b: "%-11s %d Bytes" % (FRAMES.get(a, "0x%02X" % a), b)),
+    9:  ("crc_error",    lambda a, b: "Typ 0x%02X, %d Bytes" % (a, b)),
+    10: ("rate",         lambda a, b: "%d Baud%s" % (RATES[a] if a < len(RATES) else a, " (Rückfall)" if b else "")),
+    11: ("resend",       lambda a, b: "LinkSeq %d, Verlauf %d" % (a, b)),
+    12: ("arena",        lambda a, b: "%s belegt, %s abgewiesen" % (name(PHASES, a), name(PHASES, b))),
+}
+
+
+def unstuff_frames(data):
+    """Gültige Rahmen (Typ, Nutzdaten) aus einem Mitschnitt der Leitung."""
+    frames, buf, active, esc = [], bytearray(), False, False
+    for c in data:
+        if c == LINK_FLAG:
+            buf, active, esc = bytearray(), True, False
+            continue
+        if not active:
+            continue
+        if c == LINK_ESC:
+            esc = True
+            continue
+        if esc:
+            c ^= LINK_ESC_XOR
+            esc = False
+        buf.append(c)
+        if len(buf) >= 2 and len(buf) == buf[1] + 4:
+            active = False
+            crc = 0xFFFF
+            for b in buf[:-2]:
+                crc = crc_ccitt_update(crc, b)
+            if crc == buf[-2] | buf[-1] << 8:
+                frames.append((buf[0], bytes(buf[2:-2])))
+    return frames
+
+
+def crc_ccitt_update(crc, data):
+    # Wie _crc_ccitt_update() der avr-libc
+    data ^= crc & 0xFF
+    data = (data ^ (data << 4)) & 0xFF
+    return (((data << 8) | (crc >> 8)) ^ (data >> 4) ^ (data << 3)) & 0xFFFF
+
+
+def events_from_raw(data):
+    """Einträge aus 0x20-Rahmen, Zeitpunkte auf volle Timer1-Schritte ergänzt."""
+    events = []
+    for ftype, p in unstuff_frames(data):
+        if ftype != LINK_FRAME_TRACE or len(p) < 4 or (len(p) - 4) % 5:
+            continue
+        now = int.from_bytes(p[0:4], "little")
+        for k in range(4, len(p), 5):
+            t = p[k + 1] | p[k + 2] << 8
+            events.append([now - ((now - t) & 0xFFFF), p[k], p[k + 3], p[k + 4]])
+    return events
+
+
+def load(source, raw):
+    if source.startswith("http://") or source.startswith("https://"):
+        with urllib.request.urlopen(source, timeout=10) as r:
+            data = r.read()
+    elif source == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(source, "rb") as f:
+            data = f.read()
+    if raw:
+        return events_from_raw(data)
+    return json.loads(data)["events"]
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Ablaufprotokoll des ATmega8 dekodieren")
+    ap.add_argument("source", help="URL der /trace-Route, Datei oder - (stdin)")
+    ap.add_argument("--raw", action="store_true", help="Mitschnitt der seriellen Leitung statt /trace-JSON")
+    ap.add_argument("--absolute", action="store_true", help="Zeit seit dem Start des ATmega8 statt seit dem ersten Eintrag")
+    args = ap.parse_args()
+
+    events = load(args.source, args.raw)
+    if not events:
+        print("Keine Einträge")
+        return
+    t0 = 0 if args.absolute else events[0][0]
+    prev = events[0][0]
+    for counts, ev, a, b in events:
+        label, fmt = EVENTS.get(ev, ("0x%02X" % ev, lambda a, b: "a=%d b=%d" % (a, b)))
+        print("%12.4f s  %+9.1f ms  %-12s %s" % ((counts - t0) / COUNTS_PER_S, ms(counts - prev), label, fmt(a, b)))
+        prev = counts
+
+
+if __name__ == "__main__":
+    main()
@@ -17,14 +17,191 @@ ESP8266WebServer server(80);
 // Globale Variablen zum Zwischenspeichern der Daten
 volatile uint8_t page = 1;  // Aktuelle Seite (1-5)
 String dataPayloads[6];     // Array für JSON-Daten jeder Seite (Index 0-5)
+String statusPayload = "";    // JSON-Felder mit den Zählern des ATmega8 (Statuspaket)
+String linkStatusPayload = "";  // JSON-Felder mit den Verlustzählern des ATmega8 (LINK_STATUS)
+String inputStatusPayload = "";  // JSON-Felder mit der Taster-Statistik des ATmega8 (INPUT_STATUS)
+#define DRIVER_COUNT 3              // EEPROM, LCD, UART (DRIVER_* in main.c)
+String driverPayloads[DRIVER_COUNT];  // JSON-Felder der Treiber-Statistik (DRIVER_STATUS, reihum)
+
+// Laufzeitbericht der Aufgaben des ATmega8 (TASK_STATUS, eine Aufgabe je Rahmen)
+// Namen in der Reihenfolge der TASK_*-Nummern in main.c
+#define TASK_MAX 8
+const char* const taskNames[] = { "rx", "button", "display", "measure", "pump" };
+String taskPayloads[TASK_MAX];  // JSON-Objekt je Aufgabe
+uint8_t taskCount = 0;          // Anzahl Aufgaben laut ATmega8
+uint8_t schedIdlePct = 0;       // Idle-Anteil der CPU des ATmega8 (%)
+uint16_t schedEvOverflows = 0;  // Verlorene Ereignisse im Scheduler des ATmega8
+
+// RAM des ATmega8 (RAM_STATUS, Summen mit jedem Rahmen, ein Modul je Rahmen)
+// Namen in der Reihenfolge der RAM_MOD_*-Nummern in ram.h
+#define RAM_MOD_MAX 16
+const char* const ramModNames[] = { "main", "display", "rs232", "link", "linkseq", "sched", "button", "storage", "sample", "filter", "arena", "trace" };
+uint16_t ramModBytes[RAM_MOD_MAX];  // Statischer RAM je Modul (0xFFFF = noch nicht empfangen)
+uint8_t ramModCount = 0;            // Anzahl Module laut ATmega8
+uint16_t ramData, ramBss, ramStackMax, ramHeadroomMin;
+
+// Laufzeitbericht der Verarbeitungsstufen (PROFILE, nur wenn der ATmega8 mit PROFILE_ENABLE läuft)
+// Namen in der Reihenfolge der PROF_*-Nummern in profile.h
+#define PROFILE_MAX 8
+#define PROFILE_REQUEST_MS 5000  // Höchstens alle 5 s abfragen (beim Abruf von /status)
+const char* const profileNames[] = { "load_graph", "render", "lcd_write", "send_packet", "sensor", "store" };
+String profilePayloads[PROFILE_MAX];  // JSON-Objekt je Messpunkt
+uint8_t profileCount = 0;             // Anzahl Messpunkte laut ATmega8
+uint32_t profileRequestMs = 0;        // Zeitpunkt der letzten Abfrage
+
+// Ablaufprotokoll des ATmega8 (TRACE, siehe trace.h), die letzten TRACE_KEEP Einträge
+// Zeitpunkte als volle Timer1-Schritte (1/3600 s), lesbar mit tools/trace_decode.py
+#define TRACE_KEEP 128
+struct TraceEntry { uint32_t counts; uint8_t id, a, b; };
+TraceEntry traceRing[TRACE_KEEP];
+uint16_t traceHead = 0;    // Nächste Schreibposition
+uint32_t traceTotal = 0;   // Empfangene Einträge seit dem Start
+
+// Binäres Rahmenprotokoll (siehe link.h im ATmega8-Projekt)
+#define LINK_FLAG          0x7E  // Rahmenanfang
+#define LINK_ESC           0x7D  // Escape-Zeichen
+#define LINK_ESC_XOR       0x20  // Maske für maskierte Bytes
+#define LINK_FRAME_CURRENT  0x01  // Angezeigte Seite + aktuelle Werte
+#define LINK_FRAME_STATUS   0x02  // uint16-Zähler, dann 32-Bit-Zähler des Messwert-Caches
+#define STATUS_U16          9     // uint16-Zähler im STATUS-Rahmen
+#define STATUS_U32          2     // Danach: Cache-Anfragen, davon eingespart (uint32)
+#define LINK_FRAME_SERIES   0x03  // Antwort: Series, Seq, ab Alter, Anzahl, Werte
+#define LINK_FRAME_APPEND   0x04  // Ein neuer Verlaufspunkt (Series, Seq, Wert)
+#define LINK_FRAME_PAGE     0x10  // Seitenwechsel am Display (ESP -> ATmega8, nur Textformat genutzt)
+#define LINK_FRAME_GET_SERIES  0x11  // Verlauf abfragen: Series, ab Alter, Anzahl (ESP -> ATmega8)
+#define LINK_FRAME_GET_CURRENT 0x16  // Aktuelle Werte abfragen (ESP -> ATmega8)
+#define LINK_FRAME_CHUNK       0x08  // Bulk-Abschnitt: Bereich, Offset, Seq, Head, Rohbytes
+#define LINK_FRAME_GET_CHUNK   0x17  // Bulk-Abschnitt abfragen: Bereich, Offset, Länge (ESP -> ATmega8)
+#define LINK_FRAME_PACKED      0x09  // Komprimierter Abschnitt: Bereich, erster Datensatz, Seq, Head, Anzahl, Daten
+#define LINK_FRAME_GET_PACKED  0x18  // Komprimiert abfragen: Bereich, erster Datensatz, Anzahl (ESP -> ATmega8)
+#define LINK_FRAME_LINK_STATUS 0x0A  // Verlustzähler des ATmega8 (u16)
+#define LINK_FRAME_TASK_STATUS 0x0B  // Laufzeitbericht einer Aufgabe des ATmega8 (0x0B, 0x0C, 0x0E, 0x0F nur mit DIAG_ENABLE)
+#define LINK_FRAME_INPUT_STATUS 0x0C  // Taster-Statistik des ATmega8 (u16)
+#define LINK_FRAME_PROFILE     0x0D  // Laufzeit eines Messpunkts (CPU-Takte)
+#define LINK_FRAME_DRIVER_STATUS 0x0E  // Statistik eines Treibers des ATmega8 (EEPROM, LCD, UART)
+#define LINK_FRAME_RAM_STATUS  0x0F  // RAM-Bericht des ATmega8 (Summen, Stack, ein Modul)
+#define LINK_FRAME_TRACE       0x20  // Ablaufprotokoll des ATmega8 (Sendezeitpunkt, Einträge)
+#define LINK_FRAME_GET_PROFILE 0x1A  // Laufzeitbericht abfragen (ESP -> ATmega8)
+#define LINK_FRAME_ACK         0x19  // Kumulative Bestätigung gesicherter Rahmen (ESP -> ATmega8)
+#define LINKSEQ_WINDOW         4     // Fenster des ATmega8 (linkseq.h)
+#define ACK_DELAY_MS           20    // Bestätigungen sammeln (SoftwareSerial empfängt nicht beim Senden)
+
+// Baudraten-Aushandlung (siehe linkrate.h im ATmega8-Projekt)
+#define RATE_ENABLE            0     // 1 = Baudrate aushandeln (ATmega8 mit -DLINK_RATE=1)
+#define LINK_FRAME_RATE_CAPS   0x05  // Mögliche Stufen (Bitmaske), aktuelle Stufe
+#define LINK_FRAME_RATE_ACK    0x06  // ATmega8 schaltet nach diesem Rahmen um
+#define LINK_FRAME_PROBE_ECHO  0x07  // Echo des Testmusters
+#define LINK_FRAME_RATE_QUERY  0x12  // Fähigkeiten abfragen / Lebenszeichen
+#define LINK_FRAME_RATE_SET    0x13  // Stufe anfordern
+#define LINK_FRAME_PROBE       0x14  // Testmuster mit der neuen Rate
+#define LINK_FRAME_RATE_COMMIT 0x15  // Neue Rate behalten
+#define LINK_PROBE_LEN         8
+
+// Stufen wie RS232_RATE_BAUD(n) im ATmega8 (Stufe 0 = Startrate)
+const uint32_t linkRates[] = { 28800, 57600, 115200, 230400 };
+#define LINK_RATE_COUNT 4
+// Testmuster: Steuerzeichen (Stuffing) und wechselnde Bitmuster
+const uint8_t probePattern[LINK_PROBE_LEN] = { 0x7E, 0x7D, 0x00, 0xFF, 0x55, 0xAA, 0x20, 0x5D };
+
+enum { RATE_IDLE, RATE_WAIT_CAPS, RATE_WAIT_ACK, RATE_WAIT_ECHO };
+uint8_t  linkRate = 0;        // Aktuelle Stufe
+uint8_t  rateState = RATE_IDLE;
+uint8_t  rateTarget = 0;      // Angeforderte Stufe
+uint8_t  rateFailed = 0;      // Bitmaske: Stufen, deren Probe oder Betrieb fehlgeschlagen ist
+uint32_t rateDeadline = 0;    // Zeitgrenze des aktuellen Schritts (ms)
+uint32_t rateNextQuery = 0;   // Nächste Abfrage / Lebenszeichen (ms)
+uint32_t rateFailedSince = 0; // Fehlgeschlagene Stufen werden nach 10 Minuten erneut versucht
+uint32_t rateCrcCheckMs = 0;  // Beginn des Fensters für die CRC-Fehlerprüfung
+uint32_t rateCrcAtCheck = 0;  // CRC-Fehler zu Beginn des Fensters
+uint32_t probeStartUs = 0;
+uint32_t probeUs = 0;         // Umlaufzeit des letzten erfolgreichen Probe-Rahmens (µs)
+uint32_t rateSwitches = 0;    // Erfolgreiche Umschaltungen
+uint32_t rateFallbacks = 0;   // Rückfälle auf die Startrate
+uint32_t lastFrameMs = 0;     // Letzter gültiger Rahmen vom ATmega8
+
+// Kopie der vier Verläufe (Series 0-3 = Seiten 1-4), neuester Punkt zuerst
+#define SERIES_COUNT  4
+#define SERIES_POINTS 96
+int16_t  seriesData[SERIES_COUNT][SERIES_POINTS];
+uint16_t seriesSeq[SERIES_COUNT];          // Laufende Nummer des neuesten Punkts
+bool     seriesValid[SERIES_COUNT];        // Kompletter Verlauf empfangen
+uint32_t seriesRequested[SERIES_COUNT];    // Zeitpunkt der letzten Abfrage (ms)
+uint32_t seriesRequests = 0;               // Abfragen wegen fehlender oder verpasster Punkte
+uint32_t currentMs = 0;                    // Empfangszeit der aktuellen Werte (ms)
+#define CURRENT_MAX_AGE_MS 3000            // Ältere aktuelle Werte werden beim ATmega8 abgefragt
+#define PULL_WAIT_MS       300             // Wartezeit auf die Antwort innerhalb einer HTTP-Anfrage
+
+// Komplette Historie (Bulk-Sync beim Start)
+// Die Ringpuffer des ATmega8 werden abschnittsweise als Rohbytes gespiegelt.
+// Jeder Abschnitt wird einzeln angefordert, ein verlorener Abschnitt wird nach
+// SYNC_TIMEOUT_MS ab demselben Offset erneut angefordert.
+#define SYNC_ENABLE      0           // 1 = Historie spiegeln (ATmega8 mit -DLINK_BULK=1)
+#define SYNC_RAW         1           // 1 = auch den Rohdaten-Ring spiegeln
+#define SYNC_REGIONS     (SYNC_RAW ? 3 : 2)
+#define SYNC_CHUNK_LEN   32          // Bytes je Abschnitt (LINK_CHUNK_MAX des ATmega8)
+#define SYNC_PACKED      0           // 1 = komprimiert übertragen (Delta + Zigzag mit Längen-Kopfbyte, pack.c, -DLINK_PACK=1)
+#define SYNC_PACK_RECORDS 16         // Datensätze je komprimiertem Abschnitt (LINK_PACK_MAX)
+#define SYNC_TIMEOUT_MS  300
+#define RECORD_SIZE      8           // SensorValue: Zeitstempel (24 Bit), Feuchte, Temperatur, Druck
+const uint16_t regionSize[3] = { 96 * RECORD_SIZE, 96 * RECORD_SIZE, 64 * RECORD_SIZE };
+uint8_t  mirror[3][96 * RECORD_SIZE];
+uint16_t mirrorSeq[3];        // Seq des Rings beim ersten Abschnitt
+uint8_t  mirrorHead[3];       // Nächste Schreibposition (ältester Datensatz)
+bool     mirrorValid[3];      // Bereich vollständig gespiegelt
+bool     syncActive = false;
+bool     syncDone = false;
+uint8_t  syncRegion = 0;      // Bereich in Arbeit
+uint16_t syncOffset = 0;      // Nächster fehlender Offset im Bereich
+uint32_t syncStartMs = 0;
+uint32_t syncRequestMs = 0;   // Zeitpunkt der letzten Abschnitt-Abfrage
+uint32_t syncMs = 0;          // Dauer des letzten kompletten Syncs (ms)
+uint32_t syncBytes = 0;       // Empfangene Rohbytes
+uint32_t syncWireBytes = 0;   // Davon tatsächlich übertragene Nutzdaten (komprimiert)
+uint32_t syncRetries = 0;     // Erneut angeforderte Abschnitte
+uint32_t syncRestarts = 0;    // Bereiche, die sich während des Syncs geändert haben
+
+// Gesicherte Zustellung (APPEND trägt eine LinkSeq, siehe linkseq.h im ATmega8-Projekt)
+uint8_t  relExpected = 0;     // Nächste erwartete LinkSeq
+bool     relSynced = false;   // Erste LinkSeq gesehen
+bool     ackPending = false;  // Bestätigung steht aus
+uint32_t ackDueMs = 0;        // Frühester Zeitpunkt der nächsten Bestätigung
+uint32_t relFrames = 0;       // Zugestellte gesicherte Rahmen
+uint32_t relDuplicates = 0;   // Verworfene Duplikate (Wiederholung nach verlorenem ACK)
+uint32_t relGaps = 0;         // Verworfene Rahmen hinter einer Lücke (kommen als Wiederholung)
+uint32_t relResyncs = 0;      // Neuabgleich nach Neustart des ATmega8
+uint32_t serialOverflows = 0; // Überläufe des SoftwareSerial-Empfangspuffers
+uint32_t badLines = 0;        // Unlesbare Zeilen im Textformat
+
+uint8_t  frameBuf[260];       // Typ, Länge, bis zu 255 Bytes Nutzdaten, CRC
+uint16_t framePos = 0;        // Anzahl empfangener Bytes im Rahmen
+bool     frameActive = false; // Flag empfangen, Rahmen läuft
+bool     frameEscaped = false;// Vorheriges Byte war LINK_ESC
+bool     binaryPeer = false;  // ATmega8 spricht das Binärformat (dann Befehle auch binär senden)
+
+// Link-Statistiken der ESP-Seite
+uint32_t linkFrames = 0;      // Gültige Rahmen
+uint32_t linkCrcErrors = 0;   // Verworfene Rahmen
+uint32_t linkParseUs = 0;     // Dauer der letzten Umwandlung Datenpaket -> JSON (µs)
+uint32_t linkBytes = 0;       // Empfangene Bytes insgesamt
+
+// Namen der Statuswerte in der Reihenfolge des ATmega8 (Text und Binär)
+const char* const statusKeys[] = {
+  "i2c_errors", "i2c_timeouts", "i2c_recoveries", "sensor_gaps", "filter_cycles",
+  "eeprom_writes", "eeprom_writes_avoided", "eeprom_lifetime_days", "sample_interval",
+  "sample_requests", "sample_saved",
+  // Nur im Textformat hier, binär im LINK_STATUS-Rahmen
+  "link_packet_bytes", "link_packet_ms", "link_tx_waits", "link_rate"
+};
+const uint8_t statusKeyCount = sizeof(statusKeys) / sizeof(statusKeys[0]);
 
 // Serielle Verarbeitung
 String serialLine = "";  // Puffer für empfangene RS232-Zeilen
 
 // Setup-Funktion - wird einmal beim Start ausgeführt
 void setup() {
-  // RS232 mit 28800 Baud initialisieren (muss mit ATmega8 übereinstimmen)
-  rs232.begin(28800);
+  // RS232 mit der Startrate 28800 Baud initialisieren (muss mit ATmega8 übereinstimmen)
+  // Eine höhere Rate handelt rateTask() aus, sobald der ATmega8 binär sendet
+  rs232.begin(linkRates[0]);
   delay(100);  // Kurz warten für Stabilisierung
   
   // Alle Daten-Puffer mit leeren JSON-Arrays initialisieren
@@ -171,6 +348,9 @@ void setup() {
   <canvas id="chart" width="900" height="360"></canvas>
   <div id="current" style="display:none"></div>
 
+  <!-- Statuszeile mit Fehlerzählern des ATmega8 -->
+  <div id="status" style="font-size:0.8em; opacity:0.7"></div>
+
   <script>
     // JavaScript-Variablen
     let pageJS = 1;  // Aktuelle Seite im JavaScript
@@ -202,10 +382,11 @@ void setup() {
             // Seite 5: Aktuelle Werte als Text anzeigen
             curDiv.innerHTML =
               `<p>Temperatur: <strong>${(arr[0]/10).toFixed(1)} °C</strong></p>` +
-              `<p>Druck:      <strong>${(arr[1]/10).toFixed(1)} hPa</strong></p>`;
+              `<p>Druck:      <strong>${(arr[1]/10).toFixed(1)} hPa</strong></p>` +
+              (arr.length > 2 ? `<p>Feuchte:    <strong>${(arr[2]/10).toFixed(1)} %</strong></p>` : '');
           } else {
             // Seiten 1-4: Graph zeichnen
-            drawChart(arr.map(v => v/10));  // Werte durch 10 teilen für Anzeige
+            drawChart(arr.map(v => v === null ? null : v/10));  // Werte durch 10 teilen, Lücken bleiben null
           }
         })
         .catch(console.error);  // Fehler in Konsole ausgeben
@@ -226,7 +407,7 @@ void setup() {
     document.querySelectorAll('#page-selector input[name="page"]').forEach(radio => {
       radio.addEventListener('change', () => {
         const n = parseInt(radio.value);
-        fetch('/page?num=' + n);  // Seite an ATmega8 senden
+        fetch('/page?num=' + n);  // Nur im Textformat schaltet das Display mit um
         setPage(n);  // Anzeige aktualisieren
       });
     });
@@ -250,9 +431,10 @@ void setup() {
       }
       ctx.setLineDash([]);
 
-      // Min/Max-Werte für Y-Achse finden
-      const min = Math.min(...data) - 0.0001;
-      const max = Math.max(...data) + 0.0001;
+      // Min/Max-Werte für Y-Achse finden (Lücken ignorieren)
+      const valid = data.filter(v => v !== null);
+      const min = (valid.length ? Math.min(...valid) : 0) - 0.0001;
+      const max = (valid.length ? Math.max(...valid) : 0) + 0.0001;
       
       // Achsen zeichnen
       const axisColor = getComputedStyle(document.body).getPropertyValue('--text-color').trim();
@@ -286,12 +468,15 @@ void setup() {
       // X-Achsen-Titel
       ctx.fillText((pageJS <= 2 ? 'Stunden' : 'Tage'), m.left + cW/2, m.top + cH + 40);
 
-      // Graph-Linie zeichnen
+      // Graph-Linie zeichnen (an Lücken unterbrechen)
       ctx.beginPath();
+      let penDown = false;
       data.forEach((v,i) => {
+        if (v === null) { penDown = false; return; }  // Lücke: Sensor hat nicht geantwortet
         const x = m.left + cW * (i / len);
         const y = m.top + cH * (1 - (v - min) / (max - min));
-        i === 0 ? ctx.moveTo(x, y) : ctx.lineTo(x, y);
+        penDown ? ctx.lineTo(x, y) : ctx.moveTo(x, y);
+        penDown = true;
       });
       ctx.strokeStyle = '#0077cc'; ctx.lineWidth = 2; ctx.stroke();
     }
@@ -301,12 +486,64 @@ void setup() {
     
     // Automatische Updates alle 1 Sekunde
     setInterval(() => loadData(pageJS), 1000);
+
+    // Fehlerzähler alle 5 Sekunden aktualisieren
+    const statusDiv = document.getElementById('status');
+    setInterval(() => {
+      fetch('/status', { cache: 'no-store' }).then(r => r.json()).then(s => {
+        if (s.i2c_errors === undefined) return;  // Noch kein Statuspaket empfangen
+        statusDiv.textContent =
+          `I2C-Fehler: ${s.i2c_errors} (Timeouts: ${s.i2c_timeouts}, Recovery: ${s.i2c_recoveries}) · Messlücken: ${s.sensor_gaps}` +
+          (s.filter_cycles !== undefined ? ` · Filter: ${s.filter_cycles} Takte` : '') +
+          (s.eeprom_writes !== undefined ?
+            ` · EEPROM: ${s.eeprom_writes} Schreibvorgänge, ` +
+            `${s.ee_writes_avoided !== undefined ? s.ee_writes_avoided : s.eeprom_writes_avoided} eingespart, ` +
+            `Lebensdauer ${s.eeprom_lifetime_days >= 65535 ? '∞' : s.eeprom_lifetime_days + ' Tage'} · Intervall ${s.sample_interval} s` : '') +
+          (s.sample_requests !== undefined ?
+            ` · Messwert-Cache: ${s.sample_saved} von ${s.sample_requests} Anfragen ohne Sensor-Abfrage` : '') +
+          (s.link_packet_bytes !== undefined ?
+            ` · Link (${s.link_binary ? 'binär' : 'Text'}): ${s.link_packet_bytes} Bytes in ${s.link_packet_ms} ms, ` +
+            `${s.esp_crc_errors} CRC-Fehler, ${s.esp_series_requests} Abfragen, ` +
+            `${s.esp_uptime_s ? Math.round(s.esp_bytes / s.esp_uptime_s) : 0} B/s, JSON ${s.esp_parse_us} µs, ` +
+            `${s.link_baud} Baud (Probe ${s.esp_probe_us} µs, ${s.esp_rate_fallbacks} Rückfälle)` +
+            (s.esp_sync_done ? `, Historie ${s.esp_sync_bytes} Bytes (${s.esp_sync_wire_bytes} übertragen) in ${s.esp_sync_ms} ms (${s.esp_sync_retries} wiederholt)` : '') : '') +
+          (s.link_retransmits !== undefined ?
+            ` · Zustellung: ${s.esp_rel_frames} gesichert, ${s.link_retransmits} wiederholt, ` +
+            `${s.esp_rel_duplicates} Duplikate, ${s.esp_rel_gaps} Lücken, ` +
+            `Überläufe ATmega8 ${s.link_rx_overflows + s.link_rx_errors} / ESP ${s.esp_rx_overflows}` : '') +
+          (s.tasks !== undefined ?
+            ` · CPU: ${s.sched_idle_pct} % Idle, ` +
+            s.tasks.map(t => `${t.name} ${(t.run_max_us / 1000).toFixed(1)} ms` + (t.overruns ? ` (${t.overruns}× zu spät)` : '')).join(', ') : '') +
+          (s.button_presses !== undefined ?
+            ` · Taster: ${s.button_presses} Drücke, Bild nach ${s.button_latency_ms} ms (max. ${s.button_latency_max_ms} ms` +
+            (s.button_late ? `, ${s.button_late}× zu langsam` : '') + ')' : '') +
+          (s.ee_bytes_written !== undefined ?
+            ` · EEPROM-Treiber: ${s.ee_bytes_written} Bytes geschrieben (Warten ${s.ee_wip_wait_ms} ms, max. ${s.ee_wip_wait_max_us} µs), ` +
+            `${s.ee_bytes_read} gelesen, Datensätze 24h/7d/Roh ${s.ee_writes_24h}/${s.ee_writes_7d}/${s.ee_writes_raw}` : '') +
+          (s.lcd_frames !== undefined ? ` · LCD: ${s.lcd_frames} Bilder, ${s.lcd_bytes} Bytes, ${s.lcd_commands} Kommandos` : '') +
+          (s.uart_tx_peak !== undefined ?
+            ` · UART: Sendepuffer max. ${s.uart_tx_peak} Bytes, ${s.uart_tx_waits}× gewartet, ` +
+            `${s.uart_rx_overflows + s.uart_rx_errors} Empfangsverluste` : '') +
+          (s.ram_stack_max !== undefined ?
+            ` · RAM: ${s.ram_data + s.ram_bss} Bytes statisch, Stack max. ${s.ram_stack_max} Bytes, ` +
+            `Reserve min. ${s.ram_headroom_min} Bytes` +
+            (s.ram_modules.length ? ' (' + s.ram_modules.slice().sort((a, b) => b.bytes - a.bytes).slice(0, 4)
+              .map(m => `${m.name} ${m.bytes}`).join(', ') + ')' : '') : '') +
+          (s.profile !== undefined ?
+            ` · Profil: ` + s.profile.map(p => `${p.name} Ø ${p.avg_us} µs (max. ${p.max_cycles} Takte, ${p.count}×)`).join(', ') : '');
+      }).catch(console.error);
+    }, 5000);
     
     // Synchronisation mit Hardware-Button alle 1 Sekunde
+    // Nur einem Wechsel am Display folgen, eine eigene Auswahl im Browser bleibt sonst bestehen
+    let lcdPage = 0;
     setInterval(() => {
       fetch('/page').then(r => r.text()).then(text => {
         const n = parseInt(text);
-        if (n >=1 && n <=5 && n !== pageJS) setPage(n);  // Seite wechseln, falls geändert
+        if (n >= 1 && n <= 5 && n !== lcdPage) {
+          if (lcdPage) setPage(n);  // Seite wurde am Taster gewechselt
+          lcdPage = n;
+        }
       }).catch(console.error);
     }, 1000);
   </script>
@@ -320,10 +557,11 @@ void setup() {
     if (server.hasArg("num")) {
       // Neue Seite setzen
       int n = server.arg("num").toInt();
-      if (n >= 1 && n <= 5) {
-        page = n;  // Globale Variable setzen
-        rs232.print(n);  // Seitennummer an ATmega8 senden
-        rs232.print('\n');  // Zeilenende
+      if (n >= 1 && n <= 5 && !binaryPeer) {
+        // Textformat: Daten gibt es nur für die angezeigte Seite, also Display umschalten.
+        // Im Binärformat werden die Daten abgefragt und das Display bleibt unverändert.
+        page = n;
+        sendPageCommand(n);  // Seitennummer an ATmega8 senden
       }
       server.send(200, "text/plain", "OK");
     } else {
@@ -342,23 +580,732 @@ void setup() {
     // Gewünschte Seite ermitteln
     int cmd = server.hasArg("cmd") ? server.arg("cmd").toInt() : page;
     if (cmd < 1 || cmd > 5) cmd = 1;  // Standard: Seite 1
+
+    // Binärformat: fehlende oder veraltete Daten beim ATmega8 abfragen
+    if (binaryPeer && cmd <= SERIES_COUNT && !seriesValid[cmd - 1]) {
+      pullSeries(cmd - 1);
+    } else if (binaryPeer && cmd == 5 && millis() - currentMs > CURRENT_MAX_AGE_MS) {
+      pullCurrent();
+    }
     
     // JSON-Daten der gewünschten Seite senden
     server.send(200, "application/json", dataPayloads[cmd]);
   });
 
+  // Route für die Fehlerzähler (von JavaScript aufgerufen)
+  server.on("/status", HTTP_GET, []() {
+    server.sendHeader("Cache-Control", "no-store");
+    // Laufzeitbericht anfordern, die Antwort erscheint beim nächsten Abruf
+    if (binaryPeer && millis() - profileRequestMs >= PROFILE_REQUEST_MS) {
+      profileRequestMs = millis();
+      sendFrame(LINK_FRAME_GET_PROFILE, nullptr, 0);
+    }
+    String json = "{" + statusPayload;
+    if (statusPayload.length()) json += ",";
+    if (linkStatusPayload.length()) json += linkStatusPayload + ",";
+    if (inputStatusPayload.length()) json += inputStatusPayload + ",";
+    for (uint8_t d = 0; d < DRIVER_COUNT; d++) {
+      if (driverPayloads[d].length()) json += driverPayloads[d] + ",";
+    }
+    json += "\"link_binary\":" + String(binaryPeer ? 1 : 0);
+    json += ",\"esp_frames\":" + String(linkFrames);
+    json += ",\"esp_crc_errors\":" + String(linkCrcErrors);
+    json += ",\"esp_parse_us\":" + String(linkParseUs);
+    json += ",\"esp_series_requests\":" + String(seriesRequests);
+    json += ",\"esp_bytes\":" + String(linkBytes);
+    json += ",\"esp_uptime_s\":" + String(millis() / 1000);
+    json += ",\"link_baud\":" + String(linkRates[linkRate]);
+    json += ",\"esp_probe_us\":" + String(probeUs);
+    json += ",\"esp_rate_switches\":" + String(rateSwitches);
+    json += ",\"esp_rate_fallbacks\":" + String(rateFallbacks);
+    json += ",\"esp_sync_done\":" + String(syncDone ? 1 : 0);
+    json += ",\"esp_sync_ms\":" + String(syncMs);
+    json += ",\"esp_sync_bytes\":" + String(syncBytes);
+    json += ",\"esp_sync_wire_bytes\":" + String(syncWireBytes);
+    json += ",\"esp_sync_retries\":" + String(syncRetries);
+    json += ",\"esp_sync_restarts\":" + String(syncRestarts);
+    json += ",\"esp_rel_frames\":" + String(relFrames);
+    json += ",\"esp_rel_duplicates\":" + String(relDuplicates);
+    json += ",\"esp_rel_gaps\":" + String(relGaps);
+    json += ",\"esp_rel_resyncs\":" + String(relResyncs);
+    json += ",\"esp_rx_overflows\":" + String(serialOverflows);
+    json += ",\"esp_bad_lines\":" + String(badLines);
+    if (taskCount) {
+      json += ",\"sched_idle_pct\":" + String(schedIdlePct);
+      json += ",\"sched_ev_overflows\":" + String(schedEvOverflows);
+      json += ",\"tasks\":[";
+      bool first = true;
+      for (uint8_t i = 0; i < taskCount; i++) {
+        if (!taskPayloads[i].length()) continue;  // Bericht noch nicht empfangen
+        if (!first) json += ",";
+        json += taskPayloads[i];
+        first = false;
+      }
+      json += "]";
+    }
+    if (ramModCount) {
+      // Rest: kleine Variablen ohne eigenen Eintrag (erst wenn alle Module bekannt sind)
+      json += ",\"ram_data\":" + String(ramData) + ",\"ram_bss\":" + String(ramBss);
+      json += ",\"ram_stack_max\":" + String(ramStackMax) + ",\"ram_headroom_min\":" + String(ramHeadroomMin);
+      json += ",\"ram_modules\":[";
+      uint16_t sum = 0;
+      bool complete = true, first = true;
+      for (uint8_t i = 0; i < ramModCount; i++) {
+        if (ramModBytes[i] == 0xFFFF) { complete = false; continue; }
+        if (!first) json += ",";
+        first = false;
+        String name = i < sizeof(ramModNames) / sizeof(ramModNames[0]) ? ramModNames[i] : String(i);
+        json += "{\"name\":\"" + name + "\",\"bytes\":" + String(ramModBytes[i]) + "}";
+        sum += ramModBytes[i];
+      }
+      json += "]";
+      if (complete) json += ",\"ram_other\":" + String((int32_t)ramData + ramBss - sum);
+    }
+    if (profileCount) {
+      json += ",\"profile\":[";
+      bool first = true;
+      for (uint8_t i = 0; i < profileCount; i++) {
+        if (!profilePayloads[i].length()) continue;
+        if (!first) json += ",";
+        json += profilePayloads[i];
+        first = false;
+      }
+      json += "]";
+    }
+    json += "}";
+    server.send(200, "application/json", json);
+  });
+
+  // Route für das Ablaufprotokoll des ATmega8 (Rohdaten, ältester zuerst)
+  // {"counts_per_s":3600,"total":N,"events":[[Zeitpunkt,Ereignis,a,b],...]}
+  server.on("/trace", HTTP_GET, []() {
+    server.sendHeader("Cache-Control", "no-store");
+    uint16_t n = traceTotal < TRACE_KEEP ? traceTotal : TRACE_KEEP;
+    String json = "{\"counts_per_s\":3600,\"total\":" + String(traceTotal) + ",\"events\":[";
+    for (uint16_t k = 0; k < n; k++) {
+      const TraceEntry& e = traceRing[(traceHead + TRACE_KEEP - n + k) % TRACE_KEEP];
+      if (k) json += ",";
+      json += "[" + String(e.counts) + "," + String(e.id) + "," + String(e.a) + "," + String(e.b) + "]";
+    }
+    json += "]}";
+    server.send(200, "application/json", json);
+  });
+
+  // Route für die komplette Historie aus dem Bulk-Sync
+  // /history?region=0 (24h), 1 (7 Tage), 2 (Rohdaten): [[Zeit,Temp,Druck,Feuchte],...], ältester zuerst
+  // Zeit in Sekunden, über den 24-Bit-Überlauf hinweg fortlaufend (historyJson)
+  server.on("/history", HTTP_GET, []() {
+    uint8_t r = server.hasArg("region") ? server.arg("region").toInt() : 0;
+    if (r >= SYNC_REGIONS || !mirrorValid[r]) {
+      server.send(503, "application/json", "[]");
+      return;
+    }
+    server.send(200, "application/json", historyJson(r));
+  });
+
   // Web-Server starten
   server.begin();
 }
 
+// CRC-16/CCITT wie _crc_ccitt_update() der avr-libc (Startwert 0xFFFF)
+uint16_t crcCcittUpdate(uint16_t crc, uint8_t data) {
+  data ^= (uint8_t)crc;
+  data ^= data << 4;
+  return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+// Ein Byte mit Stuffing senden
+void linkPut(uint8_t c, uint16_t& crc) {
+  crc = crcCcittUpdate(crc, c);
+  if (c == LINK_FLAG || c == LINK_ESC) { rs232.write(LINK_ESC); c ^= LINK_ESC_XOR; }
+  rs232.write(c);
+}
+
+// Einen Binärrahmen an den ATmega8 senden
+void sendFrame(uint8_t type, const uint8_t* p, uint8_t len) {
+  uint16_t crc = 0xFFFF;
+  rs232.write(LINK_FLAG);
+  linkPut(type, crc);
+  linkPut(len, crc);
+  for (uint8_t i = 0; i < len; i++) linkPut(p[i], crc);
+  uint16_t c = crc;
+  linkPut((uint8_t)c, crc);         // CRC Low-Byte
+  linkPut((uint8_t)(c >> 8), crc);  // CRC High-Byte
+}
+
+// Seitenwechsel an den ATmega8 senden (im Format, das der ATmega8 spricht)
+void sendPageCommand(uint8_t n) {
+  if (!binaryPeer) {
+    rs232.print(n);     // Textformat: Seitennummer
+    rs232.print('\n');  // Zeilenende
+    return;
+  }
+  sendFrame(LINK_FRAME_PAGE, &n, 1);
+}
+
+// Abschnitt eines Verlaufs beim ATmega8 abfragen (höchstens alle 2 s je Verlauf)
+void requestSeries(uint8_t series, uint8_t from, uint8_t count) {
+  if (millis() - seriesRequested[series] < 2000) return;
+  seriesRequested[series] = millis();
+  seriesRequests++;
+  uint8_t req[3] = { series, from, count };
+  sendFrame(LINK_FRAME_GET_SERIES, req, 3);
+}
+
+// Verlauf abfragen und kurz auf die Antwort warten (innerhalb einer HTTP-Anfrage)
+void pullSeries(uint8_t series) {
+  requestSeries(series, 0, SERIES_POINTS);
+  uint32_t t0 = millis();
+  while (!seriesValid[series] && millis() - t0 < PULL_WAIT_MS) {
+    processSerialData();
+    delay(1);
+  }
+}
+
+// Aktuelle Werte abfragen und kurz auf die Antwort warten
+void pullCurrent() {
+  uint32_t before = currentMs;
+  sendFrame(LINK_FRAME_GET_CURRENT, nullptr, 0);
+  uint32_t t0 = millis();
+  while (currentMs == before && millis() - t0 < PULL_WAIT_MS) {
+    processSerialData();
+    delay(1);
+  }
+}
+
+// Nächsten fehlenden Abschnitt anfordern
+void syncRequest() {
+  uint16_t left = regionSize[syncRegion] - syncOffset;
+#if SYNC_PACKED
+  uint8_t records = left / RECORD_SIZE;
+  uint8_t req[3] = { syncRegion, (uint8_t)(syncOffset / RECORD_SIZE),
+                     (uint8_t)(records < SYNC_PACK_RECORDS ? records : SYNC_PACK_RECORDS) };
+  sendFrame(LINK_FRAME_GET_PACKED, req, 3);
+#else
+  uint8_t req[4] = { syncRegion, (uint8_t)syncOffset, (uint8_t)(syncOffset >> 8),
+                     (uint8_t)(left < SYNC_CHUNK_LEN ? left : SYNC_CHUNK_LEN) };
+  sendFrame(LINK_FRAME_GET_CHUNK, req, 4);
+#endif
+  syncRequestMs = millis();
+}
+
+// Zigzag-Feld mit 0, 1, 2 oder 4 Bytes lesen (Gegenstück zu put_field() in pack.c)
+bool getField(const uint8_t* p, uint8_t len, uint8_t& pos, uint8_t tag, int32_t& value) {
+  uint8_t n = (tag == 3) ? 4 : tag;
+  if (pos + n > len) return false;
+  uint32_t z = 0;
+  for (uint8_t i = 0; i < n; i++) z |= (uint32_t)p[pos++] << (8 * i);
+  value = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+  return true;
+}
+
+// Komprimierte Datensätze in Rohbytes (Layout wie SensorValue) zurückwandeln
+// Rückgabe: false, wenn die Daten nicht genau count Datensätze ergeben
+bool unpackRecords(const uint8_t* p, uint8_t len, uint8_t count, uint8_t* out) {
+  uint32_t ts = 0;
+  int32_t  dts = 0, d;
+  uint8_t  hum = 0;
+  int16_t  temp = 0;
+  uint16_t press = 0;
+  uint8_t  pos = 0;
+  for (uint8_t k = 0; k < count; k++, out += RECORD_SIZE) {
+    if (pos >= len) return false;
+    uint8_t head = p[pos++];  // 2 Bit Länge je Feld: Zeit, Feuchte, Temperatur, Druck
+    if (!getField(p, len, pos, head & 3, d)) return false;
+    dts += d;
+    ts = (ts + dts) & 0xFFFFFF;
+    if (!getField(p, len, pos, (head >> 2) & 3, d)) return false;
+    hum += d;
+    if (!getField(p, len, pos, (head >> 4) & 3, d)) return false;
+    temp += d;
+    if (!getField(p, len, pos, head >> 6, d)) return false;
+    press += d;
+    out[0] = ts; out[1] = ts >> 8; out[2] = ts >> 16; out[3] = hum;
+    out[4] = temp; out[5] = (uint16_t)temp >> 8;
+    out[6] = press; out[7] = press >> 8;
+  }
+  return pos == len;
+}
+
+// Datensatz aus dem Spiegel lesen (Little Endian, Layout wie SensorValue)
+uint32_t recordTime(const uint8_t* rec)  { return rec[0] | ((uint32_t)rec[1] << 8) | ((uint32_t)rec[2] << 16); }
+int16_t  recordTemp(const uint8_t* rec)  { return rec[4] | ((uint16_t)rec[5] << 8); }
+uint16_t recordPress(const uint8_t* rec) { return rec[6] | ((uint16_t)rec[7] << 8); }
+// Gelöschter Datensatz (EEPROM 0xFF): die Feuchte 0xFF (127,5 %) schreibt der ATmega8 nie,
+// der Zeitstempel 0xFFFFFF dagegen kommt alle 194 Tage einmal vor
+bool recordEmpty(const uint8_t* rec)     { return rec[3] == 0xFF && recordTime(rec) == 0xFFFFFF; }
+
+// Gespiegelten Mittelwert-Bereich in die Verläufe übernehmen (Temperatur und Druck)
+void applyMirror(uint8_t region) {
+  for (uint8_t k = 0; k < 2; k++) {
+    uint8_t s = region * 2 + k;  // Series: T24, P24, T7D, P7D
+    for (uint8_t age = 0; age < SERIES_POINTS; age++) {
+      const uint8_t* rec = &mirror[region][((mirrorHead[region] + SERIES_POINTS - 1 - age) % SERIES_POINTS) * RECORD_SIZE];
+      int16_t t = recordTemp(rec);
+      seriesData[s][age] = (t == -32768) ? -32768 : (k ? (int16_t)recordPress(rec) : t);
+    }
+    seriesSeq[s] = mirrorSeq[region];
+    seriesValid[s] = true;
+    buildSeriesJson(s);
+  }
+}
+
+// JSON der gespiegelten Datensätze, ältester zuerst (leere Einträge und Lücken fehlen)
+// Die Zeitstempel sind 24 Bit breit und laufen nach 194 Tagen über: die Zeit läuft hier
+// über die Abstände zum Vorgänger (modulo 2^24) weiter, damit sie auch über einen
+// Überlauf hinweg steigt. Der älteste Datensatz behält seinen gespeicherten Wert.
+String historyJson(uint8_t region) {
+  uint8_t n = regionSize[region] / RECORD_SIZE;
+  String json = "[";
+  json.reserve(n * 24);
+  bool first = true;
+  bool started = false;
+  uint32_t prev = 0, time = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    const uint8_t* rec = &mirror[region][((mirrorHead[region] + i) % n) * RECORD_SIZE];
+    if (recordEmpty(rec)) continue;
+    uint32_t ts = recordTime(rec);
+    time = started ? time + ((ts - prev) & 0xFFFFFF) : ts;
+    prev = ts;
+    started = true;
+    if (recordTemp(rec) == -32768) continue;  // Lücke
+    if (!first) json += ",";
+    first = false;
+    json += "[" + String(time) + "," + String(recordTemp(rec)) + ","
+          + String(recordPress(rec)) + "," + String(rec[3] * 5) + "]";  // Feuchte in 0.1 %
+  }
+  json += "]";
+  return json;
+}
+
+// Bulk-Sync starten (komplette Historie neu spiegeln)
+void syncStart() {
+  syncActive = true;
+  syncRegion = 0;
+  syncOffset = 0;
+  syncStartMs = millis();
+  syncRequest();
+}
+
+// Empfangenen Abschnitt übernehmen (Rohbytes)
+void syncChunk(const uint8_t* p, uint8_t len) {
+  if (syncStore(p[0], p[1] | ((uint16_t)p[2] << 8), p[3] | ((uint16_t)p[4] << 8), p[5], &p[6], len - 6)) {
+    syncWireBytes += len - 6;
+  }
+}
+
+// Empfangenen komprimierten Abschnitt entpacken und übernehmen
+void syncPacked(const uint8_t* p, uint8_t len) {
+  uint8_t count = p[5];
+  uint8_t data[SYNC_PACK_RECORDS * RECORD_SIZE];
+  if (count > SYNC_PACK_RECORDS || !unpackRecords(&p[6], len - 6, count, data)) {
+    return;  // Inhalt passt nicht zur Anzahl: wird nach SYNC_TIMEOUT_MS erneut angefordert
+  }
+  if (syncStore(p[0], p[1] * RECORD_SIZE, p[2] | ((uint16_t)p[3] << 8), p[4], data, count * RECORD_SIZE)) {
+    syncWireBytes += len - 6;
+  }
+}
+
+// Abschnitt in den Spiegel übernehmen und den nächsten anfordern
+// Rückgabe: true, wenn der Abschnitt übernommen wurde
+bool syncStore(uint8_t region, uint16_t offset, uint16_t seq, uint8_t head, const uint8_t* data, uint8_t n) {
+  if (!syncActive || region != syncRegion || offset != syncOffset
+      || offset + n > regionSize[region]) return false;  // Verspätete Antwort auf eine ältere Abfrage
+
+  if (offset == 0) {
+    mirrorSeq[region] = seq;
+  } else if (seq != mirrorSeq[region]) {
+    // Ring wurde während des Syncs beschrieben: Bereich von vorne lesen
+    syncRestarts++;
+    syncOffset = 0;
+    syncRequest();
+    return false;
+  }
+  mirrorHead[region] = head;
+  memcpy(&mirror[region][offset], data, n);
+  syncBytes += n;
+  syncOffset += n;
+
+  if (syncOffset < regionSize[region]) {
+    syncRequest();
+    return true;
+  }
+  mirrorValid[region] = true;
+  if (region < 2) applyMirror(region);
+  if (++syncRegion < SYNC_REGIONS) {
+    syncOffset = 0;
+    syncRequest();
+  } else {
+    syncActive = false;
+    syncDone = true;
+    syncMs = millis() - syncStartMs;
+  }
+  return true;
+}
+
+// Bulk-Sync steuern: nach dem Start (und der Baudraten-Aushandlung) einmal komplett,
+// verlorene Abschnitte nach SYNC_TIMEOUT_MS ab demselben Offset erneut anfordern
+void syncTask() {
+  if (!SYNC_ENABLE || !binaryPeer || rateState != RATE_IDLE) return;
+  if (!syncDone && !syncActive) {
+    syncStart();
+  } else if (syncActive && millis() - syncRequestMs > SYNC_TIMEOUT_MS) {
+    syncRetries++;
+    syncRequest();
+  }
+}
+
+// Eigene Baudrate umschalten (der ATmega8 schaltet nach seinem ACK selbst um)
+void setLinkRate(uint8_t rate) {
+  rs232.flush();                  // Laufende Ausgabe mit der alten Rate beenden
+  rs232.begin(linkRates[rate]);
+  linkRate = rate;
+  frameActive = false;            // Angefangenen Rahmen verwerfen
+}
+
+// Antwort auf RATE_QUERY: höchste gemeinsame, nicht gesperrte Stufe anfordern
+void rateChoose(uint8_t caps) {
+  uint8_t best = 0;
+  for (uint8_t r = 0; r < LINK_RATE_COUNT; r++) {
+    if ((caps & (1 << r)) && !(rateFailed & (1 << r))) best = r;
+  }
+  if (best == linkRate) { rateState = RATE_IDLE; return; }
+  rateTarget = best;
+  sendFrame(LINK_FRAME_RATE_SET, &rateTarget, 1);
+  rateState = RATE_WAIT_ACK;
+  rateDeadline = millis() + 1000;
+}
+
+// Baudraten-Aushandlung, Lebenszeichen und Rückfall (aus loop())
+void rateTask() {
+  if (!RATE_ENABLE || !binaryPeer) return;  // Nur das Binärformat kann aushandeln
+  uint32_t now = millis();
+
+  // Zeitgrenzen der einzelnen Schritte
+  if (rateState != RATE_IDLE && (int32_t)(now - rateDeadline) >= 0) {
+    if (rateState == RATE_WAIT_ECHO) {
+      // Kein gültiges Echo: Stufe sperren, zurück auf die Startrate.
+      // Der ATmega8 fällt ohne COMMIT nach 2 s ebenfalls zurück.
+      rateFailed |= 1 << rateTarget;
+      rateFailedSince = now;
+      setLinkRate(0);
+      rateFallbacks++;
+      rateNextQuery = now + 3000;
+    }
+    rateState = RATE_IDLE;
+  }
+
+  if (linkRate != 0) {
+    // Lange kein gültiger Rahmen: Rate funktioniert nicht (mehr)
+    if (now - lastFrameMs > 15000) {
+      rateFailed |= 1 << linkRate;
+      rateFailedSince = now;
+      setLinkRate(0);
+      rateFallbacks++;
+      rateState = RATE_IDLE;
+      rateNextQuery = now + 3000;
+    }
+    // Gehäufte CRC-Fehler: Stufe sperren und neu aushandeln (dann eine Stufe tiefer)
+    if (now - rateCrcCheckMs > 10000) {
+      if (linkCrcErrors - rateCrcAtCheck >= 3) {
+        rateFailed |= 1 << linkRate;
+        rateFailedSince = now;
+        rateNextQuery = now;
+      }
+      rateCrcCheckMs = now;
+      rateCrcAtCheck = linkCrcErrors;
+    }
+  }
+
+  // Gesperrte Stufen nach 10 Minuten wieder zulassen
+  if (rateFailed && now - rateFailedSince > 600000UL) rateFailed = 0;
+
+  // Abfrage (beim Start und danach alle 10 s als Lebenszeichen)
+  if (rateState == RATE_IDLE && (int32_t)(now - rateNextQuery) >= 0) {
+    sendFrame(LINK_FRAME_RATE_QUERY, nullptr, 0);
+    rateState = RATE_WAIT_CAPS;
+    rateDeadline = now + 1000;
+    rateNextQuery = now + 10000;
+  }
+}
+
+// JSON-Array eines Verlaufs für die Webseite erzeugen (Lücken als null)
+void buildSeriesJson(uint8_t series) {
+  uint32_t t0 = micros();
+  String json = "[";
+  json.reserve(SERIES_POINTS * 6);
+  for (uint8_t i = 0; i < SERIES_POINTS; i++) {
+    if (i) json += ",";
+    int16_t v = seriesData[series][i];
+    json += (v == -32768) ? String("null") : String(v);
+  }
+  json += "]";
+  dataPayloads[series + 1] = json;
+  linkParseUs = micros() - t0;
+}
+
+// Statuswerte als JSON-Felder speichern (ohne Klammern)
+void storeStatus(const uint32_t* values, uint8_t count) {
+  String json = "";
+  for (uint8_t k = 0; k < count && k < statusKeyCount; k++) {
+    if (k) json += ",";
+    json += "\"" + String(statusKeys[k]) + "\":" + String(values[k]);
+  }
+  statusPayload = json;
+}
+
+// LinkSeq eines gesicherten Rahmens prüfen (Go-Back-N)
+// Rückgabe: true = neuer Rahmen in Reihenfolge, auswerten
+bool relAccept(uint8_t seq) {
+  if (!relSynced) { relSynced = true; relExpected = seq; }
+  int8_t d = (int8_t)(seq - relExpected);
+  ackPending = true;  // Jede gesicherte Nummer wird (erneut) bestätigt
+  if (d == 0) {
+    relExpected++;
+    relFrames++;
+    return true;
+  }
+  if (d < 0 && d >= -LINKSEQ_WINDOW) { relDuplicates++; return false; }  // Schon zugestellt
+  if (d > 0 && d < LINKSEQ_WINDOW)   { relGaps++; return false; }        // Vorgänger fehlt
+  // Weit außerhalb des Fensters: ATmega8 neu gestartet, Nummern übernehmen
+  relResyncs++;
+  relExpected = seq + 1;
+  relFrames++;
+  return true;
+}
+
+// Gesammelte Bestätigung senden
+void ackTask() {
+  if (!ackPending || millis() < ackDueMs) return;
+  uint8_t ack = relExpected - 1;  // Letzte lückenlos empfangene Nummer
+  sendFrame(LINK_FRAME_ACK, &ack, 1);
+  ackPending = false;
+  ackDueMs = millis() + ACK_DELAY_MS;
+}
+
+// Vollständigen Binärrahmen auswerten
+void handleFrame(uint8_t type, const uint8_t* p, uint8_t len) {
+  if (type == LINK_FRAME_CURRENT && len == 7) {
+    // Angezeigte Seite des ATmega8 übernehmen (Synchronisation mit dem Taster)
+    if (p[0] >= 1 && p[0] <= 5) page = p[0];
+    int16_t  t = p[1] | ((uint16_t)p[2] << 8);
+    uint16_t pr = p[3] | ((uint16_t)p[4] << 8);
+    uint16_t h = p[5] | ((uint16_t)p[6] << 8);
+    dataPayloads[5] = "[" + String(t) + "," + String(pr) + "," + String(h) + "]";
+    currentMs = millis();
+  } else if (type == LINK_FRAME_SERIES && len >= 5 && p[0] < SERIES_COUNT
+             && p[3] + p[4] <= SERIES_POINTS && len == 5 + p[4] * 2) {
+    uint8_t  s = p[0], from = p[3], count = p[4];
+    uint16_t seq = p[1] | ((uint16_t)p[2] << 8);
+    int16_t  delta = seq - seriesSeq[s];
+    if (!seriesValid[s]) {
+      if (from != 0 || count != SERIES_POINTS) return;  // Ohne Kopie nur der komplette Verlauf
+      seriesValid[s] = true;
+    } else if (delta > 0 && delta < SERIES_POINTS) {
+      // Kopie um die neuen Punkte verschieben, die Antwort füllt die Lücke vorne
+      memmove(&seriesData[s][delta], &seriesData[s][0], (SERIES_POINTS - delta) * sizeof(int16_t));
+    } else if (delta != 0 && !(from == 0 && count == SERIES_POINTS)) {
+      seriesValid[s] = false;                           // Zu alt oder zu weit voraus: neu abfragen
+      return;
+    }
+    seriesSeq[s] = seq;
+    for (uint8_t i = 0; i < count; i++) {
+      seriesData[s][from + i] = p[5 + 2 * i] | ((uint16_t)p[6 + 2 * i] << 8);
+    }
+    buildSeriesJson(s);
+  } else if (type == LINK_FRAME_APPEND && len == 6 && p[1] < SERIES_COUNT) {
+    if (!relAccept(p[0])) return;  // Duplikat oder Lücke: wird wiederholt
+    p++;                           // LinkSeq überspringen
+    uint8_t  s   = p[0];
+    uint16_t seq = p[1] | ((uint16_t)p[2] << 8);
+    if (!seriesValid[s]) {
+      // Noch keine Kopie: wird beim ersten Aufruf der Seite abgefragt
+    } else if (seq == (uint16_t)(seriesSeq[s] + 1)) {
+      // Passender Folgepunkt: Ring um eins verschieben, neuen Punkt vorne einfügen
+      memmove(&seriesData[s][1], &seriesData[s][0], (SERIES_POINTS - 1) * sizeof(int16_t));
+      seriesData[s][0] = p[3] | ((uint16_t)p[4] << 8);
+      seriesSeq[s] = seq;
+      buildSeriesJson(s);
+    } else if ((int16_t)(seq - seriesSeq[s]) > 0) {
+      // Punkte verpasst: nur die fehlenden (neuesten) Punkte abfragen
+      uint16_t missing = seq - seriesSeq[s];
+      requestSeries(s, 0, missing < SERIES_POINTS ? missing : SERIES_POINTS);
+    }
+    // Ältere oder doppelte Punkte werden ignoriert
+  } else if (type == LINK_FRAME_CHUNK && len >= 6) {
+    syncChunk(p, len);
+  } else if (type == LINK_FRAME_PACKED && len >= 6) {
+    syncPacked(p, len);
+  } else if (type == LINK_FRAME_LINK_STATUS && len == 22) {
+    static const char* const keys[] = {
+      "link_crc_errors", "link_rx_overflows", "link_rx_errors",
+      "link_rel_frames", "link_retransmits", "link_ack_timeouts", "link_resyncs",
+      "link_packet_bytes", "link_packet_ms", "link_tx_waits", "link_rate"
+    };
+    String json = "";
+    for (uint8_t k = 0; k < 11; k++) {
+      if (k) json += ",";
+      json += "\"" + String(keys[k]) + "\":" + String(p[2 * k] | ((uint16_t)p[2 * k + 1] << 8));
+    }
+    linkStatusPayload = json;
+  } else if (type == LINK_FRAME_PROFILE && len == 16 && p[0] < p[1] && p[1] <= PROFILE_MAX) {
+    // Takte bei 3,6864 MHz: µs = Takte * 1000 / 3686
+    uint16_t count = p[2] | ((uint16_t)p[3] << 8);
+    uint32_t v[3];
+    for (uint8_t k = 0; k < 3; k++) {
+      const uint8_t* q = p + 4 + 4 * k;
+      v[k] = q[0] | ((uint32_t)q[1] << 8) | ((uint32_t)q[2] << 16) | ((uint32_t)q[3] << 24);
+    }
+    String name = p[0] < sizeof(profileNames) / sizeof(profileNames[0]) ? profileNames[p[0]] : String(p[0]);
+    profilePayloads[p[0]] = "{\"name\":\"" + name + "\",\"count\":" + String(count) +
+                            ",\"min_cycles\":" + String(v[0]) + ",\"max_cycles\":" + String(v[1]) +
+                            ",\"avg_cycles\":" + String(v[2]) +
+                            ",\"avg_us\":" + String((uint32_t)((uint64_t)v[2] * 1000 / 3686)) + "}";
+    profileCount = p[1];
+  } else if (type == LINK_FRAME_INPUT_STATUS && len == 14) {
+    static const char* const keys[] = {
+      "button_presses", "button_longs", "button_repeats", "button_dropped",
+      "button_latency_ms", "button_latency_max_ms", "button_late"
+    };
+    String json = "";
+    for (uint8_t k = 0; k < 7; k++) {
+      if (k) json += ",";
+      json += "\"" + String(keys[k]) + "\":" + String(p[2 * k] | ((uint16_t)p[2 * k + 1] << 8));
+    }
+    inputStatusPayload = json;
+  } else if (type == LINK_FRAME_RAM_STATUS && len == 12 && p[8] < p[9] && p[9] <= RAM_MOD_MAX) {
+    ramData        = p[0] | ((uint16_t)p[1] << 8);
+    ramBss         = p[2] | ((uint16_t)p[3] << 8);
+    ramStackMax    = p[4] | ((uint16_t)p[5] << 8);
+    ramHeadroomMin = p[6] | ((uint16_t)p[7] << 8);
+    if (ramModCount != p[9]) {
+      for (uint8_t i = 0; i < RAM_MOD_MAX; i++) ramModBytes[i] = 0xFFFF;
+      ramModCount = p[9];
+    }
+    ramModBytes[p[8]] = p[10] | ((uint16_t)p[11] << 8);
+  } else if (type == LINK_FRAME_TRACE && len >= 4 && (len - 4) % 5 == 0) {
+    // 16-Bit-Zeitpunkte relativ zum Sendezeitpunkt auf volle Timer1-Schritte ergänzen
+    uint32_t now = p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    for (const uint8_t* q = p + 4; q < p + len; q += 5) {
+      uint16_t t = q[1] | ((uint16_t)q[2] << 8);
+      TraceEntry& e = traceRing[traceHead];
+      e.counts = now - (uint16_t)((uint16_t)now - t);
+      e.id = q[0];
+      e.a  = q[3];
+      e.b  = q[4];
+      traceHead = (traceHead + 1) % TRACE_KEEP;
+      traceTotal++;
+    }
+  } else if (type == LINK_FRAME_DRIVER_STATUS && len >= 2 && p[0] < DRIVER_COUNT) {
+    // Zeiten in Timer1-Schritten (1/3600 s)
+    const uint8_t* q = p + 2;
+    auto u16 = [&](uint8_t o) { return (uint32_t)(q[o] | ((uint16_t)q[o + 1] << 8)); };
+    auto u32 = [&](uint8_t o) { return u16(o) | (u16(o + 2) << 16); };
+    String json = "";
+    if (p[0] == 0 && len == 26) {
+      json = "\"ee_bytes_read\":" + String(u32(0)) + ",\"ee_bytes_written\":" + String(u32(4)) +
+             ",\"ee_wip_wait_ms\":" + String((uint32_t)((uint64_t)u32(8) * 5 / 18)) +
+             ",\"ee_wip_wait_max_us\":" + String(u16(12) * 2500UL / 9) +
+             ",\"ee_writes_24h\":" + String(u16(14)) + ",\"ee_writes_7d\":" + String(u16(16)) +
+             ",\"ee_writes_raw\":" + String(u16(18)) + ",\"ee_writes_avoided\":" + String(u32(20));
+    } else if (p[0] == 1 && len == 14) {
+      json = "\"lcd_bytes\":" + String(u32(0)) + ",\"lcd_commands\":" + String(u32(4)) +
+             ",\"lcd_reads\":" + String(u16(8)) + ",\"lcd_frames\":" + String(u16(10));
+    } else if (p[0] == 2 && len == 15) {
+      json = "\"uart_tx_bytes\":" + String(u16(0)) + ",\"uart_rx_bytes\":" + String(u16(2)) +
+             ",\"uart_rx_overflows\":" + String(u16(4)) + ",\"uart_rx_errors\":" + String(u16(6)) +
+             ",\"uart_tx_full\":" + String(u16(8)) + ",\"uart_tx_waits\":" + String(u16(10)) +
+             ",\"uart_tx_peak\":" + String(q[12]);
+    }
+    if (json.length()) driverPayloads[p[0]] = json;
+  } else if (type == LINK_FRAME_TASK_STATUS && len == 13 && p[0] < p[1] && p[1] <= TASK_MAX) {
+    // Laufzeit in Timer1-Schritten (1/3600 s), Verspätung in Ticks (10 ms)
+    uint16_t runs     = p[2] | ((uint16_t)p[3] << 8);
+    uint16_t runMax   = p[4] | ((uint16_t)p[5] << 8);
+    uint16_t lateMax  = p[6] | ((uint16_t)p[7] << 8);
+    uint16_t overruns = p[8] | ((uint16_t)p[9] << 8);
+    String name = p[0] < sizeof(taskNames) / sizeof(taskNames[0]) ? taskNames[p[0]] : String(p[0]);
+    taskPayloads[p[0]] = "{\"name\":\"" + name + "\",\"runs\":" + String(runs) +
+                         ",\"run_max_us\":" + String((uint32_t)runMax * 2500UL / 9) +
+                         ",\"late_max_ms\":" + String((uint32_t)lateMax * 10) +
+                         ",\"overruns\":" + String(overruns) + "}";
+    taskCount = p[1];
+    schedIdlePct = p[10];
+    schedEvOverflows = p[11] | ((uint16_t)p[12] << 8);
+  } else if (type == LINK_FRAME_RATE_CAPS && len == 2) {
+    if (rateState == RATE_WAIT_CAPS) rateChoose(p[0]);
+  } else if (type == LINK_FRAME_RATE_ACK && len == 1) {
+    if (rateState == RATE_WAIT_ACK && p[0] == rateTarget) {
+      setLinkRate(rateTarget);
+      delay(1);  // ATmega8 schaltet nach dem letzten Stoppbit um
+      probeStartUs = micros();
+      sendFrame(LINK_FRAME_PROBE, probePattern, LINK_PROBE_LEN);
+      rateState = RATE_WAIT_ECHO;
+      rateDeadline = millis() + 500;
+    }
+  } else if (type == LINK_FRAME_PROBE_ECHO && len == LINK_PROBE_LEN) {
+    if (rateState == RATE_WAIT_ECHO && memcmp(p, probePattern, LINK_PROBE_LEN) == 0) {
+      probeUs = micros() - probeStartUs;
+      sendFrame(LINK_FRAME_RATE_COMMIT, nullptr, 0);
+      rateSwitches++;
+      rateState = RATE_IDLE;
+      rateCrcCheckMs = millis();
+      rateCrcAtCheck = linkCrcErrors;
+    }
+  } else if (type == LINK_FRAME_STATUS && len == STATUS_U16 * 2 + STATUS_U32 * 4) {
+    uint32_t values[STATUS_U16 + STATUS_U32];
+    for (uint8_t k = 0; k < STATUS_U16; k++) values[k] = p[2 * k] | ((uint16_t)p[2 * k + 1] << 8);
+    for (uint8_t k = 0; k < STATUS_U32; k++) {
+      const uint8_t* q = p + STATUS_U16 * 2 + 4 * k;
+      values[STATUS_U16 + k] = q[0] | ((uint32_t)q[1] << 8) | ((uint32_t)q[2] << 16) | ((uint32_t)q[3] << 24);
+    }
+    storeStatus(values, STATUS_U16 + STATUS_U32);
+  }
+}
+
+// Ein Byte eines Binärrahmens verarbeiten
+// Rückgabe: true solange ein Rahmen läuft (Byte gehört nicht zum Textformat)
+bool processFrameByte(uint8_t c) {
+  if (c == LINK_FLAG) {  // Rahmenanfang: immer neu synchronisieren
+    frameActive = true; framePos = 0; frameEscaped = false;
+    return true;
+  }
+  if (!frameActive) return false;
+
+  if (c == LINK_ESC) { frameEscaped = true; return true; }
+  if (frameEscaped) { c ^= LINK_ESC_XOR; frameEscaped = false; }
+  frameBuf[framePos++] = c;
+
+  if (framePos >= 2 && framePos == (uint16_t)frameBuf[1] + 4) {
+    frameActive = false;  // Rahmen vollständig
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < framePos - 2; i++) crc = crcCcittUpdate(crc, frameBuf[i]);
+    if (crc != (frameBuf[framePos - 2] | ((uint16_t)frameBuf[framePos - 1] << 8))) {
+      linkCrcErrors++;
+      return true;
+    }
+    linkFrames++;
+    lastFrameMs = millis();
+    binaryPeer = true;
+    handleFrame(frameBuf[0], &frameBuf[2], frameBuf[1]);
+  }
+  return true;
+}
+
 // Verarbeitet empfangene RS232-Daten vom ATmega8
+// Binärrahmen beginnen mit 0x7E, alles andere wird als Textzeile gelesen
 void processSerialData() {
+  if (rs232.overflow()) serialOverflows++;  // Bytes verloren, bevor sie gelesen wurden
   while (rs232.available()) {  // Solange Daten verfügbar sind
     char c = rs232.read();  // Ein Zeichen lesen
+    linkBytes++;
+
+    if (processFrameByte((uint8_t)c)) continue;  // Byte gehört zu einem Binärrahmen
     
     if (c == '\n') {  // Zeilenende erreicht
       if (serialLine.startsWith("d:")) {  // Datenpaket erkannt
         // Format: d:X:data1;data2;data3;...
+        uint32_t t0 = micros();
         int firstColon  = serialLine.indexOf(':');   // Erste Doppelpunkt-Position
         int secondColon = serialLine.indexOf(':', firstColon + 1);  // Zweite Doppelpunkt-Position
         
@@ -380,7 +1327,8 @@ void processSerialData() {
               if (dataStr[i] == ';') {
                 // Semikolon gefunden - Zahl zum JSON hinzufügen
                 if (num.length() > 0) { 
-                  json += num + ","; 
+                  // -32768 markiert eine Messlücke (Sensor hat nicht geantwortet)
+                  json += (num == "-32768" ? String("null") : num) + ","; 
                   num = ""; 
                 }
               } else {
@@ -395,8 +1343,28 @@ void processSerialData() {
             
             // JSON in entsprechenden Puffer speichern
             dataPayloads[page] = json;
+            binaryPeer = false;
+            linkParseUs = micros() - t0;
+          } else {
+            badLines++;  // Ungültige Seitennummer
           }
+        } else {
+          badLines++;    // Kopf d:X: unvollständig
+        }
+      } else if (serialLine.startsWith("s:")) {  // Statuspaket erkannt
+        // Format: s:Wert;Wert;...; (Reihenfolge wie statusKeys)
+        uint32_t values[32];
+        uint8_t count = 0;
+        int start = 2;  // Hinter "s:"
+        while (count < 32) {
+          int end = serialLine.indexOf(';', start);
+          if (end < 0) break;  // Ende des Pakets
+          values[count++] = strtoul(serialLine.c_str() + start, nullptr, 10);  // Cache-Zähler sind 32 Bit
+          start = end + 1;
         }
+        storeStatus(values, count);
+      } else if (serialLine.length()) {
+        badLines++;  // Unbekannte oder abgeschnittene Zeile
       }
       serialLine = "";  // Puffer zurücksetzen
     } else if (c != '\r') {  // Nicht-Carriage-Return Zeichen
@@ -408,5 +1376,8 @@ void processSerialData() {
 // Hauptschleife - wird endlos ausgeführt
 void loop() {
   processSerialData();  // RS232-Daten verarbeiten
+  rateTask();           // Baudrate aushandeln / überwachen
+  syncTask();           // Historie spiegeln
+  ackTask();            // Gesicherte Rahmen bestätigen
   server.handleClient();  // Web-Server-Anfragen bearbeiten
 }